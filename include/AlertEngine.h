@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+#include "Config.h"
+#include "FlowDetector.h"
+#include "Formula.h"
+#include "SpscQueue.h"
+
+enum class AlertKind {
+    Tick,           // 每一笔满足条件的成交
+    Window,         // 滑动窗口内满足条件的成交合计超过阈值或当天平均的若干倍
+    VwapCross,      // 价格穿越当天成交均价
+    FlowSpike,      // 滑动窗口成交量相对基线的 z 值超过阈值（见 FlowDetector.h）
+};
+
+// 一次触发的提醒
+struct Alert {
+    std::string stockCode;
+    std::string rule;
+    AlertKind kind = AlertKind::Tick;
+    int time = 0;                       // 触发的成交时间（当天秒数）
+    double value = 0.0;                 // tick：成交金额；window：窗口合计；vwap_cross：价格；flow_spike：z 值
+    double reference = 0.0;             // tick：价格；window：阈值；vwap_cross：均价；flow_spike：买卖金额差占比
+};
+
+// 实时成交上的提醒规则：条件编译为公式字节码按批求值，窗口用按时间出队的双端队列维护合计，
+// 每条规则每笔成交的代价是常数。process 只能在一个线程中调用，触发的提醒写入无锁队列供界面线程读取
+class AlertEngine {
+public:
+    // 条件有语法错误时抛出 std::runtime_error
+    explicit AlertEngine(const std::vector<AlertRuleEntry>& rules, size_t queueCapacity = 4096);
+
+    // ticks 中 [begin, ticks.size()) 为该股票新到的成交，之前的成交已经处理过；
+    // notify 为 false 时只更新窗口和均价等状态，不产生提醒（启动时补齐当天已有的成交）
+    void process(const std::string& stockCode, const TickColumns& ticks, size_t begin, bool notify = true);
+    // 丢弃该股票的窗口和均价等状态，换到新交易日时调用，与 process 在同一线程
+    void reset(const std::string& stockCode) { symbols_.erase(stockCode); }
+    // 界面线程取出已触发的提醒
+    bool pop(Alert& alert) { return queue_.pop(alert); }
+    // 队列满时丢弃的提醒数，可以在任意线程读取
+    size_t dropped() const { return dropped_; }
+
+    static wxString formatAlert(const Alert& alert);
+
+private:
+    enum class WindowValue { Amount, Volume, Count };
+
+    struct Rule {
+        std::string name;
+        AlertKind kind;
+        std::unique_ptr<Formula> filter;
+        WindowValue value;
+        int window;
+        double threshold;
+        double averageMultiple;
+    };
+
+    // 一条规则在一只股票上的状态
+    struct RuleState {
+        // window：窗口内满足条件的成交，按时间先后
+        std::deque<std::pair<int, double>> entries;
+        double sum = 0.0;
+        double total = 0.0;             // 当天满足条件的合计，用于计算平均窗口合计
+        bool firing = false;            // 超过阈值期间只在越过的那一刻提醒一次
+        // vwap_cross：均价 = 成交额 / 股数，股数由成交额 / 价格得出，不依赖每手股数
+        double amount = 0.0;
+        double shares = 0.0;
+        int side = 0;                   // 价格在均价之上为 1，之下为 -1
+        // flow_spike
+        std::optional<FlowWindow> flow;
+    };
+
+    struct SymbolState {
+        int firstTime = -1;
+        std::vector<RuleState> rules;   // 按规则下标
+    };
+
+    void emit(Alert alert);
+
+    std::vector<Rule> rules_;
+    std::unordered_map<std::string, SymbolState> symbols_;
+    std::vector<uint8_t> mask_;
+    SpscQueue<Alert> queue_;
+    std::atomic<size_t> dropped_{ 0 };
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// 单个方向（买盘或卖盘）的统计结果
+struct SideSummary {
+    size_t count = 0;
+    double sumPrice = 0.0;
+    double maxPrice = 0.0;
+    double minPrice = 0.0;
+    double sumVolume = 0.0;
+    double maxVolume = 0.0;
+    double minVolume = 0.0;
+    double avgVolume = 0.0;
+    double sumAmount = 0.0;
+    double maxAmount = 0.0;
+    double minAmount = 0.0;
+    double avgAmount = 0.0;
+    double avgPrice = 0.0;      // 成交均价（成交额 / 成交股数）
+    int lastTime = -1;          // 最近一笔的时间（当天秒数）
+    double lastPrice = 0.0;
+    double lastVolume = 0.0;
+    double lastAmount = 0.0;
+};
+
+// 滚动窗口内成交量明显高于基线的一段时间（见 FlowDetector.h）
+struct FlowSpike {
+    int window = 0;             // 窗口秒数
+    int start = 0;              // 开始和结束时间（当天秒数）
+    int end = 0;
+    double peakZ = 0.0;         // 窗口成交量相对基线的最大 z 值
+    double imbalance = 0.0;     // 峰值时窗口内 (买盘金额 - 卖盘金额) / (买盘金额 + 卖盘金额)
+    double intensity = 0.0;     // 峰值时每秒成交笔数
+    double maxAmount = 0.0;     // 峰值时窗口内最大单笔成交金额
+};
+
+// 一次分析的结构化结果，界面渲染和导出都基于它
+struct AnalysisResult {
+    std::string stockCode;
+    size_t tickCount = 0;
+    int firstTime = -1;
+    int lastTime = -1;
+    int lotSize = 0;            // 一手多少股
+    SideSummary buy;
+    SideSummary sell;
+    std::vector<FlowSpike> spikes;  // 按开始时间排序
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ArrowFlatBuilder;
+
+// 不依赖 Arrow 库的 IPC 文件写入器，输出单个 RecordBatch，可被 pyarrow / DuckDB / Polars 直接映射读取
+// 列数据只保存指针，调用方需保证在 write 之前数据有效
+class ArrowWriter {
+public:
+    void addInt8(const std::string& name, const std::vector<int8_t>& values);
+    void addInt32(const std::string& name, const std::vector<int32_t>& values);
+    void addInt64(const std::string& name, const std::vector<int64_t>& values);
+    void addFloat64(const std::string& name, const std::vector<double>& values);
+    void addTime32(const std::string& name, const std::vector<int32_t>& seconds);   // 负值写为空值
+    void addUtf8(const std::string& name, const std::vector<std::string>& values);
+
+    void write(const std::string& path) const;
+
+private:
+    enum class Type { Int8, Int32, Int64, Float64, Time32, Utf8 };
+
+    struct Column {
+        std::string name;
+        Type type;
+        const void* data;
+        size_t length;
+        size_t width;
+        const std::vector<std::string>* strings;
+        std::vector<uint8_t> validity;      // 为空表示没有空值
+        int64_t nullCount;
+    };
+
+    struct Buffer {
+        int64_t offset;
+        int64_t length;
+    };
+
+    void addColumn(const std::string& name, Type type, const void* data, size_t length, size_t width,
+        const std::vector<std::string>* strings = nullptr);
+    size_t rowCount() const;
+
+    std::vector<Buffer> layoutBody(int64_t& bodyLength) const;
+    size_t writeSchema(ArrowFlatBuilder& builder) const;
+    std::vector<uint8_t> buildSchemaMessage() const;
+    std::vector<uint8_t> buildRecordBatchMessage(const std::vector<Buffer>& buffers, int64_t bodyLength) const;
+    std::vector<uint8_t> buildFooter(int64_t batchOffset, int32_t batchMetaLength, int64_t bodyLength) const;
+
+    std::vector<Column> columns_;
+};
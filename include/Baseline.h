@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <wx/string.h>
+#include "StockData.h"
+
+enum BaselineMetric {
+    BASELINE_VOLUME,
+    BASELINE_AMOUNT,
+    BASELINE_IMBALANCE,     // (买盘金额 - 卖盘金额) / (买盘金额 + 卖盘金额)
+    BASELINE_METRIC_COUNT,
+};
+
+// 一个交易日按固定时长分段汇总的成交，只保存第一个到最后一个有成交的时间段
+struct DayProfile {
+    int32_t date = 0;
+    int firstBucket = 0;
+    std::vector<float> volume;
+    std::vector<float> amount;
+    std::vector<float> buyAmount;
+    std::vector<float> sellAmount;
+
+    // 第 bucket 个时间段的指标，没有成交时为 0
+    double value(int bucket, BaselineMetric metric) const;
+    // [first, last] 内各时间段合计后的指标
+    double total(int first, int last, BaselineMetric metric) const;
+};
+
+// 最近 days 个交易日各时间段指标的和与平方和，按当天的时间段编号存放；
+// 新的一天加入时减去移出窗口的一天，不需要重新汇总
+struct RollingBaseline {
+    int days = 0;
+    std::vector<int32_t> dates;         // 参与计算的交易日，升序
+    std::array<std::vector<double>, BASELINE_METRIC_COUNT> sum;
+    std::array<std::vector<double>, BASELINE_METRIC_COUNT> sumSquares;
+};
+
+// 单只股票的多日基线：<程序目录>/archive/<代码>.tkb 中保存最近若干个完整交易日的分段汇总和各窗口的滚动合计。
+// 收盘后归档时增量更新；之前已有的归档在第一次比较时补算一次，之后不再读取原始成交。
+// 从构造（读取）到 save 期间须持有 lockFiles() 返回的锁，否则另一线程可能用旧的副本覆盖刚保存的基线
+class BaselineStore {
+public:
+    // 读取已有的基线文件，时间段长度或窗口配置变化时重新开始；窗口天数必须为正
+    BaselineStore(const std::string& symbol, int bucketSeconds, const std::vector<int>& windows);
+
+    // 加入（或替换）一个完整交易日并更新各窗口的滚动合计
+    void addDay(int32_t date, const TickColumns& ticks);
+    // 归档中较新的完整交易日还没有汇总时读取一次补上，返回是否有变化
+    bool syncWithArchive();
+    bool save() const;
+
+    int bucketSeconds() const { return bucketSeconds_; }
+    int bucketCount() const { return 24 * 60 * 60 / bucketSeconds_; }
+    const std::vector<DayProfile>& days() const { return days_; }
+    const DayProfile* findDay(int32_t date) const;
+    const std::vector<RollingBaseline>& rolling() const { return rolling_; }
+
+    static DayProfile makeProfile(int32_t date, const TickColumns& ticks, int bucketSeconds);
+    static std::string getBaselineFile(const std::string& symbol);
+    static std::unique_lock<std::mutex> lockFiles();
+    // 收盘后的整日数据写入归档之后调用
+    static void onDayArchived(const std::string& symbol, int32_t date, const TickColumns& ticks);
+
+private:
+    void insertDay(DayProfile profile);
+    void accumulate(RollingBaseline& rolling, const DayProfile& day, double sign) const;
+    void rebuild(RollingBaseline& rolling) const;
+    size_t keepDays() const;
+    void load();
+
+    std::string path_;
+    std::string symbol_;
+    int bucketSeconds_;
+    std::vector<DayProfile> days_;          // 按日期升序
+    std::vector<RollingBaseline> rolling_;  // 按窗口配置的顺序
+};
+
+// 本次的值在基线交易日中的位置
+struct BaselineStats {
+    double value = 0.0;
+    double mean = 0.0;
+    double stdev = 0.0;
+    double percentile = NAN;    // 基线中低于本次的交易日所占百分比，相等的计一半
+    size_t days = 0;
+
+    double zScore() const { return stdev > 0 ? (value - mean) / stdev : 0.0; }
+};
+
+using BaselineRow = std::array<BaselineStats, BASELINE_METRIC_COUNT>;
+
+struct BaselineComparison {
+    std::string stockCode;
+    int32_t date = 0;
+    int bucketSeconds = 0;
+    int firstBucket = 0;
+    int lastBucket = -1;
+    std::vector<int> windows;           // 各基线的交易日数，如 20、60
+    std::vector<BaselineRow> span;      // 按窗口：整个时间范围合计
+    std::vector<BaselineRow> buckets;   // 按时间段：与第一个窗口比较
+};
+
+class Baseline {
+public:
+    // ticks 为当天 [stimesec, etimesec] 的成交，与之前 N 个交易日的同一时间范围比较；只比较基本完整覆盖的时间段
+    static BaselineComparison compare(const std::string& stockCode, const TickColumns& ticks, int stimesec, int etimesec);
+    static wxString format(const BaselineComparison& comparison);
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include <wx/wx.h>
+#include <memory>
+#include "Baseline.h"
+
+// 当前时间范围与之前若干交易日同一时间范围的比较，基线在后台读取和补算
+class BaselinePanel : public wxPanel {
+public:
+    BaselinePanel(wxWindow* parent, const std::string& stockCode, std::shared_ptr<const TickColumns> ticks, int stimesec, int etimesec);
+    ~BaselinePanel() override;
+
+private:
+    // 后台计算回调时页面可能已经关闭
+    struct BaselineState {
+        bool alive = true;
+    };
+
+    std::shared_ptr<BaselineState> state_;
+    wxTextCtrl* text_;
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include "StockData.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 图表的采样桶：金字塔第 1 层每桶 4 笔成交，之后每层 4 个桶合并为 1 个
+struct ChartBucket {
+    int32_t startTime;
+    int32_t endTime;
+    float open;
+    float close;
+    float low;
+    float high;
+    float buyMax;       // 桶内最大的单笔买盘成交量
+    float sellMax;      // 桶内最大的单笔卖盘成交量
+    float vwap;         // 截至桶末的成交均价
+};
+
+// 一次绘制所需的数据，已按屏幕宽度降采样
+struct ChartFrame {
+    struct Point {
+        int32_t time;
+        float value;
+    };
+    std::vector<Point> price;           // LTTB 降采样后的价格线
+    std::vector<Point> vwap;            // 与价格线相同采样点的均价线
+    std::vector<float> buyVolume;       // 每个像素列的最大买盘成交量
+    std::vector<float> sellVolume;      // 每个像素列的最大卖盘成交量
+    float priceMin = 0;
+    float priceMax = 0;
+    float volumeMax = 0;
+    int level = 0;                      // 使用的金字塔层，0 为逐笔
+};
+
+// 价格、成交量和均价的多分辨率金字塔，缩放和平移时只读取与屏幕分辨率相当的一层
+class ChartPyramid {
+public:
+    static constexpr int FAN_OUT = 4;
+
+    explicit ChartPyramid(std::shared_ptr<const TickColumns> ticks);
+
+    bool empty() const { return ticks_->empty(); }
+    int32_t startTime() const { return ticks_->time.front(); }
+    int32_t endTime() const { return ticks_->time.back(); }
+
+    // 取得 [t0, t1] 范围内宽度为 width 像素的绘制数据
+    ChartFrame frame(int32_t t0, int32_t t1, int width) const;
+
+    // Largest-Triangle-Three-Buckets：从 points 中选出 threshold 个最能保持形状的点
+    static std::vector<ChartFrame::Point> lttb(const std::vector<ChartFrame::Point>& points, size_t threshold);
+
+private:
+    ChartBucket tickBucket(size_t i) const;
+    // 第 level 层中 [t0, t1] 范围内的桶，第 0 层由逐笔数据临时生成
+    void collect(int level, int32_t t0, int32_t t1, std::vector<ChartBucket>& out) const;
+    size_t countInRange(int level, int32_t t0, int32_t t1) const;
+
+    std::shared_ptr<const TickColumns> ticks_;
+    std::vector<float> vwap_;                       // 逐笔的累计成交均价
+    std::vector<std::vector<ChartBucket>> levels_;  // levels_[0] 为第 1 层
+};
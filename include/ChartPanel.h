@@ -0,0 +1,51 @@
+#pragma once
+#include "AnalysisResult.h"
+#include "ChartData.h"
+#include <wx/wx.h>
+#include <atomic>
+#include <memory>
+
+// 分时图：价格线、均价线和买卖成交量，成交量异常的时间段用底色标出；
+// 缩放平移时在后台线程按金字塔数据绘制到位图，界面线程只负责贴图
+class ChartPanel : public wxPanel {
+public:
+    ChartPanel(wxWindow* parent, std::shared_ptr<const TickColumns> ticks, std::vector<FlowSpike> spikes = {});
+    ~ChartPanel() override;
+
+    // 在后台线程把 [t0, t1] 范围绘制成 width x height 的图像，同时给出价格区的上下限
+    static wxImage Render(const ChartPyramid& pyramid, int32_t t0, int32_t t1, int width, int height,
+        float* priceMin = nullptr, float* priceMax = nullptr, const std::vector<FlowSpike>* spikes = nullptr);
+
+private:
+    void RequestRender();
+    void OnPaint(wxPaintEvent& event);
+    void OnSize(wxSizeEvent& event);
+    void OnMouseWheel(wxMouseEvent& event);
+    void OnMouseDown(wxMouseEvent& event);
+    void OnMouseMove(wxMouseEvent& event);
+    void OnMouseUp(wxMouseEvent& event);
+    void OnCaptureLost(wxMouseCaptureLostEvent& event);
+    void OnDoubleClick(wxMouseEvent& event);
+    void SetRange(double t0, double t1);
+
+    // 后台绘制完成时窗口可能已经关闭
+    struct RenderState {
+        bool alive = true;
+    };
+
+    std::shared_ptr<const ChartPyramid> pyramid_;
+    std::shared_ptr<const std::vector<FlowSpike>> spikes_;
+    std::shared_ptr<RenderState> state_;
+    double t0_ = 0;
+    double t1_ = 0;
+    wxBitmap bitmap_;
+    int32_t bitmapT0_ = 0;
+    int32_t bitmapT1_ = 0;
+    float priceMin_ = 0;
+    float priceMax_ = 0;
+    bool rendering_ = false;
+    bool pending_ = false;
+    bool dragging_ = false;
+    int dragX_ = 0;
+    double dragT0_ = 0;
+};
@@ -0,0 +1,10 @@
+#pragma once
+#include <wx/wx.h>
+#include <vector>
+#include "StockData.h"
+
+// 多股票对比结果
+class CompareWindow : public wxDialog {
+public:
+    CompareWindow(wxWindow* parent, const std::vector<ComparisonEntry>& entries, int64_t elapsedUs);
+};
@@ -1,20 +1,88 @@
-#pragma once
-#include <string>
-#include <vector>
-#include <nlohmann/json.hpp>
-
-class Config {
-public:
-    static Config& getInstance();
-    bool saveConfig(const std::string& stockCode = "");
-    bool loadConfig();
-	const int getLanguage();
-    const std::vector<std::string>& getStockHistory() const { return stockHistory_; }
-
-private:
-    Config();
-	std::string getProgramDir();
-    std::string configFile_ = "stock_history.json";
-	std::string language_ = "";
-    std::vector<std::string> stockHistory_;
-};
+#pragma once
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// 保存的自定义公式（见 Formula.h）
+struct FormulaEntry {
+    std::string name;
+    std::string expression;
+};
+
+// 实时模式的提醒规则（见 AlertEngine.h）
+struct AlertRuleEntry {
+    std::string name;
+    std::string kind;                   // tick：逐笔条件；window：窗口合计；vwap_cross：价格穿越均价；flow_spike：窗口成交量异常
+    std::string filter;                 // 参与计算的成交，语法同公式中的 where 条件，空表示全部
+    std::string value = "amount";       // window 累加的字段：amount、volume 或 count
+    int window = 300;                   // window、flow_spike 的窗口秒数
+    double threshold = 0.0;             // window 合计超过该值时提醒，0 表示不用；vwap_cross 为价格偏离均价的比例，过滤均价附近的来回波动；flow_spike 为 z 值阈值
+    double averageMultiple = 0.0;       // window 合计超过当天平均窗口合计的倍数时提醒，0 表示不用
+};
+
+class Config {
+public:
+    static Config& getInstance();
+    bool saveConfig(const std::string& stockCode = "");
+    bool loadConfig();
+	const int getLanguage();
+    const std::vector<std::string>& getStockHistory() const { return stockHistory_; }
+    bool getTrace() const { return trace_; }
+    bool getArchive() const { return archive_; }
+    size_t getCacheSize() const { return cacheMB_ * 1024 * 1024; }
+    double getRequestRate() const { return requestRate_; }
+    double getRequestBurst() const { return requestBurst_; }
+    size_t getMaxConcurrency() const { return maxConcurrency_; }
+    int getFetchRetries() const { return fetchRetries_; }
+    bool getHedgeRequests() const { return hedgeRequests_; }
+    size_t getScanRequestBudget() const { return scanRequestBudget_; }
+    size_t getScanTopN() const { return scanTopN_; }
+    double getScanLargeAmount() const { return scanLargeAmount_; }
+    int getScanSpikeWindow() const { return scanSpikeWindow_; }
+    const std::vector<FormulaEntry>& getFormulas() const { return formulas_; }
+    // 替换公式列表并写入配置文件
+    bool setFormulas(const std::vector<FormulaEntry>& formulas);
+    double getLivePollSeconds() const { return livePollSeconds_; }
+    const std::vector<AlertRuleEntry>& getAlertRules() const { return alertRules_; }
+    const std::vector<int>& getFlowWindows() const { return flowWindows_; }
+    double getFlowZThreshold() const { return flowZThreshold_; }
+    int getFlowBaselineSeconds() const { return flowBaselineMinutes_ * 60; }
+    const std::vector<int>& getBaselineDays() const { return baselineDays_; }
+    int getBaselineBucketSeconds() const { return baselineBucketMinutes_ * 60; }
+	std::string getProgramDir();
+
+private:
+    Config();
+    std::string configFile_ = "stock_history.json";
+	std::string language_ = "";
+    bool trace_ = false;
+    bool archive_ = true;
+    size_t cacheMB_ = 256;
+    double requestRate_ = 2.0;
+    double requestBurst_ = 2.0;
+    size_t maxConcurrency_ = 4;
+    int fetchRetries_ = 3;
+    bool hedgeRequests_ = true;
+    size_t scanRequestBudget_ = 20000;
+    size_t scanTopN_ = 50;
+    double scanLargeAmount_ = 1000000.0;
+    int scanSpikeWindow_ = 60;
+    std::vector<std::string> stockHistory_;
+    std::vector<FormulaEntry> formulas_ = {
+        { "Large buys 10:00-10:30", "sum(amount where side == buy and amount >= 1m and time between 10:00 and 10:30)" },
+        { "Large sell/buy ratio", "count(where side == sell and amount >= 1m) / count(where side == buy and amount >= 1m)" },
+        { "Net buy volume by 30m", "sum(volume where side == buy) - sum(volume where side == sell) by 30m" },
+    };
+    double livePollSeconds_ = 3.0;
+    std::vector<AlertRuleEntry> alertRules_ = {
+        { "Large buy", "tick", "side == buy and amount > 5m" },
+        { "Sell burst 5m", "window", "side == sell", "amount", 300, 0.0, 3.0 },
+        { "VWAP cross", "vwap_cross", "", "amount", 300, 0.002 },
+        { "Volume spike 1m", "flow_spike", "", "volume", 60, 3.0 },
+    };
+    std::vector<int> flowWindows_ = { 30, 60, 300 };
+    double flowZThreshold_ = 3.0;
+    int flowBaselineMinutes_ = 30;
+    std::vector<int> baselineDays_ = { 20, 60 };
+    int baselineBucketMinutes_ = 5;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <wx/string.h>
+#include "StockData.h"
+#include "SymbolMetadata.h"
+
+// 按交易时段对齐的分钟序列，午间休市等时段之外的时间不占位置
+struct MinuteSeries {
+    std::string stockCode;
+    std::vector<double> returns;    // 相邻分钟收盘价的对数收益率，长度为分钟数 - 1
+    std::vector<double> flow;       // 每分钟买盘金额 - 卖盘金额
+};
+
+// 对称的相关系数矩阵，按行存放；方差为 0 的序列与其他序列的相关系数为 NaN
+struct CorrelationMatrix {
+    std::vector<std::string> codes;
+    std::vector<double> values;
+
+    size_t size() const { return codes.size(); }
+    double at(size_t i, size_t j) const { return values[i * codes.size() + j]; }
+};
+
+struct CorrelationResult {
+    std::vector<int> minutes;           // 各分钟的开始时间（当天秒数）
+    CorrelationMatrix returns;
+    CorrelationMatrix flow;
+    std::vector<std::string> errors;    // 查询失败的股票及原因
+    int64_t fetchUs = 0;
+    int64_t computeUs = 0;
+};
+
+// 多只股票分钟收益率和净买入金额的两两相关系数
+class Correlation {
+public:
+    // 交易时段与 [stimesec, etimesec] 交集内的各分钟，多个市场的时段取并集
+    static std::vector<int> minuteGrid(std::vector<TradingSession> sessions, int stimesec = -1, int etimesec = -1);
+    static MinuteSeries buildSeries(const std::string& stockCode, const TickColumns& data, const std::vector<int>& minutes);
+    // 各行长度相同；标准化后分块计算 Z * Z^T，块按上三角分配给多个线程
+    static CorrelationMatrix compute(const std::vector<std::string>& codes, const std::vector<std::vector<double>>& rows);
+    // 并行查询各股票并计算两个矩阵，失败的股票不参与计算
+    static CorrelationResult analyze(const std::vector<std::string>& stockCodes, int stimesec = -1, int etimesec = -1);
+    // 相关性最强的若干对股票
+    static wxString formatTopPairs(const CorrelationResult& result, size_t count = 20);
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include <wx/wx.h>
+#include "Correlation.h"
+
+// 相关系数分析结果：相关性最强的股票对，完整矩阵可以导出
+class CorrelationWindow : public wxDialog {
+public:
+    CorrelationWindow(wxWindow* parent, const CorrelationResult& result);
+
+private:
+    void OnExport(wxCommandEvent& event);
+
+    CorrelationResult result_;
+};
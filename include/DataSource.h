@@ -0,0 +1,52 @@
+#pragma once
+#include "Metrics.h"
+#include "StockData.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 成交明细数据源：分页发现、按页请求、解码响应
+// 代码统一使用 getStockSymbol 规范化后的形式（如 sh600000），数据源内部自行转换
+class DataSource {
+public:
+    virtual ~DataSource() = default;
+
+    // 名称和版本，作为缓存和分页表的来源标识；解析方式变化时修改，使旧的缓存失效
+    virtual std::string name() const = 0;
+    // 各页的开始时间、最后一页的结束时间和 24:00（当天秒数）
+    virtual std::vector<int> getTimePages(const std::string& symbol, PageTiming* timing = nullptr) = 0;
+    // 请求一页原始数据，没有数据时返回空字符串
+    virtual std::string fetchPage(const std::string& symbol, int page, PageTiming* timing = nullptr) = 0;
+    // 解码一页响应，追加到 out，返回解码的笔数
+    virtual size_t decodePage(const std::string& response, TickColumns& out, size_t* skipped = nullptr) = 0;
+    // 预先解析域名、建立连接，本地数据源不需要
+    virtual void warmUp() {}
+};
+
+// 按健康分数选择数据源：连续失败的数据源暂停使用一段时间，其余按最近的平均耗时排序
+class DataSourceRouter {
+public:
+    static DataSourceRouter& getInstance();
+
+    void add(std::shared_ptr<DataSource> source);
+    // 按优先顺序排列的数据源，第一个是当前最快的健康数据源
+    std::vector<std::shared_ptr<DataSource>> candidates() const;
+    void reportSuccess(const DataSource& source, int64_t latencyUs);
+    void reportFailure(const DataSource& source);
+
+private:
+    DataSourceRouter() = default;
+
+    struct Health {
+        std::shared_ptr<DataSource> source;
+        double latencyUs = 0;       // 耗时的指数滑动平均，0 表示还没有样本
+        int failures = 0;           // 连续失败次数
+        std::chrono::steady_clock::time_point retryAfter;
+    };
+    Health* findHealth(const DataSource& source);
+
+    mutable std::mutex mutex_;
+    std::vector<Health> sources_;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "AnalysisResult.h"
+
+struct TickColumns;
+struct CorrelationMatrix;
+struct CorrelationResult;
+
+// 将分析结果和原始成交明细导出为 JSON / CSV / Arrow IPC
+class Exporter {
+public:
+    // 按扩展名选择格式；CSV 与 Arrow 分别写出 <名称>_summary 与 <名称>_ticks 两个文件，返回写出的文件列表
+    static std::vector<std::string> exportResult(const std::string& path, const AnalysisResult& result, const TickColumns& ticks);
+
+    static void writeJson(const std::string& path, const AnalysisResult& result, const TickColumns& ticks);
+    static void writeSummaryCsv(const std::string& path, const AnalysisResult& result);
+    static void writeTicksCsv(const std::string& path, const TickColumns& ticks);
+    static void writeSummaryArrow(const std::string& path, const AnalysisResult& result);
+    static void writeTicksArrow(const std::string& path, const TickColumns& ticks);
+
+    // 相关系数矩阵：JSON 写入一个文件；CSV 与 Arrow 分别写出 <名称>_returns 与 <名称>_flow
+    static std::vector<std::string> exportCorrelation(const std::string& path, const CorrelationResult& result);
+    static void writeCorrelationJson(const std::string& path, const CorrelationResult& result);
+    static void writeCorrelationCsv(const std::string& path, const CorrelationMatrix& matrix);
+    static void writeCorrelationArrow(const std::string& path, const CorrelationMatrix& matrix);
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include "AnalysisResult.h"
+#include "RingBuffer.h"
+#include "StockData.h"
+
+// 一个窗口长度上的滚动订单流统计，逐笔按时间顺序加入，每笔的代价是常数（均摊）：
+// 窗口内的成交存放在按时间出队的环形缓冲区中并维护买卖金额、成交量和笔数的合计，
+// 最大单笔金额用单调递减的双端队列维护；窗口成交量的基线是按秒加权的指数移动均值和方差
+class FlowWindow {
+public:
+    // halfLife 为基线的半衰期（秒），两者都必须为正
+    FlowWindow(int seconds, double zThreshold, int halfLife);
+
+    // 按时间顺序加入第 i 笔成交，早于上一笔的成交被忽略；开始一段新的异常时返回 true
+    bool add(const TickColumns& ticks, size_t i);
+    // 结束仍在进行的异常
+    void finish();
+
+    int seconds() const { return seconds_; }
+    double imbalance() const;
+    double intensity() const { return static_cast<double>(entries_.size()) / seconds_; }
+    double maxAmount() const { return peaks_.empty() ? 0.0 : peaks_.front().amount; }
+    // 基线样本不足时为 0
+    double zScore() const { return z_; }
+    bool inSpike() const { return inSpike_; }
+    // 因早于上一笔而被忽略的成交数
+    size_t outOfOrder() const { return outOfOrder_; }
+    const FlowSpike& current() const { return current_; }
+    const std::vector<FlowSpike>& spikes() const { return spikes_; }
+
+private:
+    struct Entry {
+        int time;
+        double buy;
+        double sell;
+        double volume;
+    };
+    struct Peak {
+        int time;
+        double amount;
+    };
+
+    void sample(int time);
+
+    int seconds_;
+    double threshold_;
+    double halfLife_;
+    RingBuffer<Entry> entries_;
+    RingBuffer<Peak> peaks_;
+    double buy_ = 0.0;
+    double sell_ = 0.0;
+    double volume_ = 0.0;
+    // 基线
+    int lastTime_ = -1;
+    double weight_ = 0.0;
+    double mean_ = 0.0;
+    double variance_ = 0.0;
+    double z_ = 0.0;
+    bool inSpike_ = false;
+    size_t outOfOrder_ = 0;
+    FlowSpike current_;
+    std::vector<FlowSpike> spikes_;
+};
+
+// 多个窗口长度（如 30 秒、1 分钟、5 分钟）同时检测，历史数据和实时模式共用
+class FlowDetector {
+public:
+    // 默认使用配置中的窗口、阈值和基线半衰期
+    FlowDetector();
+    FlowDetector(const std::vector<int>& windows, double zThreshold, int halfLife);
+
+    // [begin, end) 内没有按时间排列时按时间排序后加入
+    void add(const TickColumns& ticks, size_t begin, size_t end);
+    void finish();
+    const std::vector<FlowWindow>& windows() const { return windows_; }
+    // 各窗口的异常按开始时间合并
+    std::vector<FlowSpike> spikes() const;
+
+private:
+    std::vector<FlowWindow> windows_;
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "StockData.h"
+
+// 公式的计算结果：不分组时只有一个值，按时间分组时每个有成交的时间段一个值
+struct FormulaResult {
+    bool grouped = false;
+    std::vector<int> bucketStart;       // 各时间段的开始时间（当天秒数）
+    std::vector<double> values;         // 无法计算（如除以 0、没有符合条件的成交）时为 NaN
+};
+
+// 成交明细上的自定义指标公式，例如
+//   sum(amount where side == buy and amount > 1m and time between 10:00 and 10:30)
+//   count(where side == sell and amount >= 1m) / count(where side == buy and amount >= 1m)
+//   sum(volume where side == buy) - sum(volume where side == sell) by 5m
+// 语法：
+//   formula   := expr ['by' 时长]                时长如 30s、5m、1h，按整点对齐分组
+//   expr      := 聚合函数、数字和 + - * / ( ) 组成的算术表达式
+//   聚合函数  := sum|count|avg|min|max|first|last '(' [列表达式] ['where' 条件] ')'
+//   列表达式  := 列 price change volume amount time side index、数字和 + - * / 组成的表达式
+//   条件      := 比较 < <= > >= == != 、'between' a 'and' b，用 and / or / not 组合
+// 数字可带 k（千）、m（百万）后缀，HH:MM[:SS] 为当天秒数，buy / sell / neutral 为成交方向的取值。
+// 编译时把列表达式翻译成按列成块执行的字节码，每条指令对一块数据（1024 行）做同一运算，
+// 浮点列直接引用 TickColumns 的内存；聚合按块累加，最后按时间段计算外层算术表达式
+class Formula {
+public:
+    // 语法错误时抛出 std::runtime_error，说明出错的位置
+    static Formula compile(const std::string& text);
+
+    // 只有条件部分的公式，如 side == buy and amount > 5m，用于逐笔过滤
+    static Formula compileCondition(const std::string& text);
+
+    FormulaResult evaluate(const TickColumns& ticks) const;
+    // 条件公式在 [begin, end) 上的结果，out[i] 对应第 begin + i 笔，成立为 1
+    void evaluateCondition(const TickColumns& ticks, size_t begin, size_t end, std::vector<uint8_t>& out) const;
+    const std::string& text() const { return text_; }
+
+    enum class Op : uint8_t {
+        // 列运算，dst/a/b 为寄存器
+        LoadPrice, LoadChange, LoadVolume, LoadAmount, LoadTime, LoadSide, LoadIndex,
+        Const,
+        Add, Sub, Mul, Div, Neg,
+        Lt, Le, Gt, Ge, Eq, Ne,
+        And, Or, Not,
+    };
+
+    enum class Aggregate : uint8_t {
+        Sum, Count, Avg, Min, Max, First, Last,
+    };
+
+    // 外层算术表达式的后缀指令
+    enum class ScalarOp : uint8_t {
+        PushAggregate, PushConst, Add, Sub, Mul, Div, Neg,
+    };
+
+    struct Instruction {
+        Op op;
+        int dst;
+        int a;
+        int b;
+        double constant;
+    };
+
+    struct AggregateSpec {
+        Aggregate kind;
+        int value;                      // 取值寄存器，count 没有取值时为 -1
+        int mask;                       // 条件寄存器（0/1），没有条件时为 -1
+    };
+
+    struct ScalarInstruction {
+        ScalarOp op;
+        int aggregate;
+        double constant;
+    };
+
+private:
+    friend class FormulaParser;
+
+    void runChunk(const TickColumns& ticks, size_t base, size_t len, double* storage, size_t stride, const double** reg) const;
+
+    std::string text_;
+    std::vector<Instruction> program_;
+    std::vector<AggregateSpec> aggregates_;
+    std::vector<ScalarInstruction> scalar_;
+    int registers_ = 0;
+    int bucketSeconds_ = 0;             // 0 表示不分组
+    int mask_ = -1;                     // 条件公式的结果寄存器
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include "Config.h"
+#include "Formula.h"
+#include <wx/listctrl.h>
+#include <wx/wx.h>
+#include <memory>
+
+// 保存的自定义公式及其在当前成交明细上的计算结果
+class FormulaPanel : public wxPanel {
+public:
+    FormulaPanel(wxWindow* parent, std::shared_ptr<const TickColumns> ticks);
+
+private:
+    struct Row {
+        FormulaEntry entry;
+        bool valid = true;
+        wxString value;         // 列表中显示的值，分组公式显示时间段数
+        wxString detail;        // 分组公式的逐段结果或错误信息
+    };
+
+    Row evaluate(const FormulaEntry& entry) const;
+    void Reload();
+    void Save();
+    void OnSelect(wxListEvent& event);
+    void OnAdd(wxCommandEvent& event);
+    void OnRemove(wxCommandEvent& event);
+
+    std::shared_ptr<const TickColumns> ticks_;
+    std::vector<Row> rows_;
+    wxListCtrl* list_;
+    wxTextCtrl* nameBox_;
+    wxTextCtrl* expressionBox_;
+    wxTextCtrl* detail_;
+};
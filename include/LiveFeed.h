@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "StockData.h"
+
+// 实时模式：后台线程按 live_poll_seconds 轮询各股票当天的成交，把新增的成交交给回调。
+// 每次只查询上次最后一笔之后的时间段，写满的页来自内存缓存，网络请求只有仍在增长的最后一页
+class LiveFeed {
+public:
+    // 在轮询线程中按股票依次调用；ticks 为该股票当天到目前为止的全部成交，[begin, ticks.size()) 为新增部分。
+    // initial 为 true 时是启动或换到新交易日后补齐的成交，接收方应丢弃该股票之前的状态并据此重建，不应当作新事件提示
+    using Listener = std::function<void(const std::string& stockCode, const TickColumns& ticks, size_t begin, bool initial)>;
+
+    LiveFeed(std::vector<std::string> stockCodes, Listener listener);
+    ~LiveFeed();
+
+    // 通知轮询线程退出，不等待：线程可能正在限速等待或网络请求中，结束后自行释放状态，之后不再调用回调
+    void stop();
+
+    size_t polls() const { return state_->polls; }
+    size_t ticks() const { return state_->ticks; }
+    size_t errors() const { return state_->errors; }
+    // 实际的轮询间隔：股票多时一轮的请求数超过限速允许的数量，间隔按 requests_per_second 放宽
+    int64_t intervalUs() const { return state_->intervalUs; }
+    // 上一轮查询的耗时
+    int64_t lastRoundUs() const { return state_->lastRoundUs; }
+
+private:
+    struct SymbolFeed {
+        std::string stockCode;
+        TickColumns ticks;
+        bool primed = false;
+    };
+
+    // 轮询线程和 LiveFeed 共同持有，窗口关闭后由线程释放
+    struct State {
+        std::vector<SymbolFeed> symbols;
+        Listener listener;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+        std::atomic<size_t> polls{ 0 };
+        std::atomic<size_t> ticks{ 0 };
+        std::atomic<size_t> errors{ 0 };
+        std::atomic<int64_t> intervalUs{ 0 };
+        std::atomic<int64_t> lastRoundUs{ 0 };
+    };
+
+    static void run(std::shared_ptr<State> state);
+    static void poll(State& state, SymbolFeed& feed, TickColumns& fresh);
+    static bool stopping(State& state);
+
+    std::shared_ptr<State> state_;
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <wx/listctrl.h>
+#include <wx/timer.h>
+#include <wx/wx.h>
+#include <memory>
+#include "AlertEngine.h"
+#include "LiveFeed.h"
+#include "Metrics.h"
+
+// 实时提醒窗口：轮询线程把新成交交给提醒规则，界面定时从无锁队列取出触发的提醒
+class LiveWindow : public wxFrame {
+public:
+    LiveWindow(wxWindow* parent, const std::vector<std::string>& stockCodes);
+    ~LiveWindow() override;
+
+private:
+    void OnTimer(wxTimerEvent& event);
+
+    std::shared_ptr<AlertEngine> engine_;     // 轮询线程的回调也持有，窗口关闭后由线程释放
+    std::unique_ptr<LiveFeed> feed_;
+    StopWatch watch_;
+    size_t alerts_ = 0;
+    wxTimer timer_;
+    wxStaticText* status_;
+    wxListCtrl* list_;
+};
@@ -1,22 +1,38 @@
-#pragma once
-#include <wx/wx.h>
-#include <wx/combobox.h>
-
-class MainWindow : public wxFrame {
-public:
-    MainWindow();
-	void UpdateStockComboBox(const std::vector<std::string>& newHistory);
-
-private:
-    void CreateStockPanel();
-    void OnGetData();
-    void OnButton(wxCommandEvent& event);
-    void OnEnter(wxCommandEvent& event);
-
-    wxPanel* mainPanel_;
-    wxBoxSizer* mainSizer_;
-    wxComboBox* stockCombo_;
-    wxButton* actionButton_;
-    wxTextCtrl* stimeBox_;
-    wxTextCtrl* etimeBox_;
+#pragma once
+#include <wx/wx.h>
+#include <wx/combobox.h>
+#include <functional>
+#include "StockData.h"
+
+class MainWindow : public wxFrame {
+public:
+    MainWindow();
+	void UpdateStockComboBox(const std::vector<std::string>& newHistory);
+
+private:
+    void CreateStockPanel();
+    void OnGetData();
+    bool GetTimeSpan(int& stimesec, int& etimesec);
+    void RunQuery(const std::string& stockCode, std::function<TickColumns(QueryMetrics*)> query);
+    void OnButton(wxCommandEvent& event);
+    void OnEnter(wxCommandEvent& event);
+    void OnImport(wxCommandEvent& event);
+    void OnCompare(wxCommandEvent& event);
+    void OnScan(wxCommandEvent& event);
+    void OnCorrelate(wxCommandEvent& event);
+    void OnLive(wxCommandEvent& event);
+    void OnStockFocus(wxFocusEvent& event);
+    void OnStockEdit(wxCommandEvent& event);
+
+    wxPanel* mainPanel_;
+    wxBoxSizer* mainSizer_;
+    wxComboBox* stockCombo_;
+    wxButton* actionButton_;
+    wxButton* importButton_;
+    wxButton* compareButton_;
+    wxButton* scanButton_;
+    wxButton* correlateButton_;
+    wxButton* liveButton_;
+    wxTextCtrl* stimeBox_;
+    wxTextCtrl* etimeBox_;
 };
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+#include <wx/string.h>
+#include "RateLimiter.h"
+#include "StockData.h"
+
+// 扫描的排名依据
+enum ScanCriterion : int {
+    SCAN_IMBALANCE = 0,         // 买卖金额差（绝对值）
+    SCAN_LARGE_TRADES,          // 大单笔数
+    SCAN_VOLUME_SPIKE,          // 成交量放大倍数
+    SCAN_CRITERION_COUNT,
+};
+
+// 单只股票在时间范围内的扫描结果
+struct ScanScore {
+    std::string stockCode;
+    double buyAmount = 0.0;
+    double sellAmount = 0.0;
+    int largeTrades = 0;        // 金额不低于 scan_large_amount 的买卖单
+    double volumeSpike = 0.0;   // 任一 scan_spike_window 秒窗口内的成交量 / 窗口平均成交量
+    int spikeTime = -1;         // 放量窗口的开始时间（当天秒数）
+
+    double imbalance() const;
+    double value(ScanCriterion criterion) const;
+};
+
+// 只保留得分最高的 N 项的小顶堆，内存占用与扫描的股票数量无关
+class TopN {
+public:
+    explicit TopN(ScanCriterion criterion = SCAN_IMBALANCE, size_t capacity = 50);
+
+    void push(const ScanScore& score);
+    // 按得分从高到低排列的副本
+    std::vector<ScanScore> sorted() const;
+    const std::vector<ScanScore>& items() const { return heap_; }
+
+private:
+    bool greater(const ScanScore& a, const ScanScore& b) const;
+
+    ScanCriterion criterion_;
+    size_t capacity_;
+    std::vector<ScanScore> heap_;
+};
+
+struct ScanOptions {
+    std::string listFile;               // 股票代码列表，每行一个代码，可选第二列为成交额等流动性指标
+    int stimesec = -1;
+    int etimesec = -1;
+    size_t topN = 50;
+    size_t requestBudget = 20000;       // 每次运行最多发出的网络请求数，用完后停止，之后可以继续
+    double largeAmount = 1000000.0;
+    int spikeWindow = 60;
+};
+
+// 扫描进度和当前各项排名，扫描过程中定期交给界面
+struct ScanProgress {
+    size_t total = 0;
+    size_t done = 0;                    // 已完成（含之前中断前完成的）
+    size_t failed = 0;
+    size_t requests = 0;                // 本次运行已使用的请求数
+    size_t requestBudget = 0;
+    bool finished = false;
+    bool budgetExhausted = false;
+    std::array<std::vector<ScanScore>, SCAN_CRITERION_COUNT> leaders;
+};
+
+// 全市场扫描：按流动性从高到低依次查询，每次运行受请求预算约束，只保留各项排名的前 N 名。
+// 进度保存在 <程序目录>/market_scan.json，同一列表、同一交易日和时间范围的扫描中断后从断点继续
+class MarketScanner {
+public:
+    explicit MarketScanner(const ScanOptions& options);
+
+    // 在调用线程中执行扫描，onProgress 在工作线程中调用，调用间隔不少于 0.5 秒，结束时必定调用一次
+    void run(const std::function<void(const ScanProgress&)>& onProgress);
+    // 请求停止，正在查询的股票完成后返回，进度已保存
+    void stop() { stopped_ = true; }
+
+    // 读取股票代码列表，忽略空行和 # 开头的注释；第二列作为流动性，缺省为 0
+    static std::vector<std::pair<std::string, double>> loadCodeList(const std::string& path);
+    static ScanScore score(const std::string& stockCode, const TickColumns& data, double largeAmount, int spikeWindow);
+    static wxString formatLeaders(const ScanProgress& progress, ScanCriterion criterion);
+
+private:
+    struct Task {
+        double liquidity = 0.0;
+        size_t order = 0;           // 列表中的位置，流动性相同时保持原有顺序
+        std::string stockCode;
+        bool operator<(const Task& other) const {
+            return liquidity != other.liquidity ? liquidity < other.liquidity : order > other.order;
+        }
+    };
+
+    std::string stateKey() const;
+    void loadState();
+    void saveState();
+    ScanProgress snapshot(bool finished);
+
+    ScanOptions options_;
+    std::string stateFile_;
+    std::atomic<bool> stopped_{ false };
+    std::atomic<bool> budgetExhausted_{ false };
+    RequestBudget budget_;          // 扫描线程及其取数线程发出的每个请求都从这里预留
+
+    // 以下成员由 mutex_ 保护
+    std::mutex mutex_;
+    std::priority_queue<Task> queue_;
+    std::set<std::string> done_;
+    std::map<std::string, double> liquidity_;     // 之前扫描得到的成交额，作为下一次扫描的优先级
+    std::array<TopN, SCAN_CRITERION_COUNT> leaders_;
+    size_t total_ = 0;
+    size_t failed_ = 0;
+};
@@ -0,0 +1,222 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include "AnalysisResult.h"
+#include "StockData.h"
+
+// 编译期组合的统计指标：每个指标是一个带 add / merge 的小类型，MetricSet 把它们展开到同一个循环体中，
+// 增加指标不会增加遍历次数。取值字段同样是类型，编译器可以把整个集合内联成一次手写的融合循环
+namespace metric {
+
+    // 取值字段
+    struct Price {
+        static double get(const TickColumns& t, size_t i) { return t.price[i]; }
+    };
+    struct Volume {
+        static double get(const TickColumns& t, size_t i) { return t.volume[i]; }
+    };
+    struct Amount {
+        static double get(const TickColumns& t, size_t i) { return t.amount[i]; }
+    };
+
+    struct Count {
+        size_t value = 0;
+        void add(const TickColumns&, size_t) { value++; }
+        void merge(const Count& other) { value += other.value; }
+    };
+
+    template <typename Field>
+    struct Sum {
+        double value = 0.0;
+        void add(const TickColumns& t, size_t i) { value += Field::get(t, i); }
+        void merge(const Sum& other) { value += other.value; }
+    };
+
+    template <typename Field>
+    struct Min {
+        double value = std::numeric_limits<double>::infinity();
+        void add(const TickColumns& t, size_t i) { value = (std::min)(value, Field::get(t, i)); }
+        void merge(const Min& other) { value = (std::min)(value, other.value); }
+    };
+
+    template <typename Field>
+    struct Max {
+        double value = -std::numeric_limits<double>::infinity();
+        void add(const TickColumns& t, size_t i) { value = (std::max)(value, Field::get(t, i)); }
+        void merge(const Max& other) { value = (std::max)(value, other.value); }
+    };
+
+    // 成交均价 = 成交额 / 成交量，成交量单位为手时再除以每手股数
+    struct Vwap {
+        double amount = 0.0;
+        double volume = 0.0;
+        void add(const TickColumns& t, size_t i) {
+            amount += t.amount[i];
+            volume += t.volume[i];
+        }
+        void merge(const Vwap& other) {
+            amount += other.amount;
+            volume += other.volume;
+        }
+        double value(int lotSize = 1) const { return (volume > 0 && lotSize > 0) ? amount / volume / lotSize : 0.0; }
+    };
+
+    // 以第一个值为偏移累加一次和二次和，避免每笔做除法，同时减小相消误差
+    template <typename Field>
+    struct Variance {
+        size_t count = 0;
+        double shift = 0.0;
+        double sum = 0.0;
+        double sumSquares = 0.0;
+        void add(const TickColumns& t, size_t i) {
+            const double value = Field::get(t, i);
+            if (count == 0) shift = value;
+            const double d = value - shift;
+            count++;
+            sum += d;
+            sumSquares += d * d;
+        }
+        void merge(const Variance& other) {
+            if (other.count == 0) return;
+            if (count == 0) {
+                *this = other;
+                return;
+            }
+            // 换算到本对象的偏移
+            const double delta = other.shift - shift;
+            sumSquares += other.sumSquares + 2 * delta * other.sum + other.count * delta * delta;
+            sum += other.sum + other.count * delta;
+            count += other.count;
+        }
+        double mean() const { return count ? shift + sum / count : 0.0; }
+        double value() const {
+            if (count < 2) return 0.0;
+            const double m = sum / count;
+            return (std::max)(sumSquares / count - m * m, 0.0);
+        }
+        double stdev() const { return std::sqrt(value()); }
+    };
+
+    // 最后一笔只记录下标，结束时再读取各字段
+    struct Last {
+        size_t index = SIZE_MAX;
+        void add(const TickColumns&, size_t i) { index = i; }
+        void merge(const Last& other) {
+            if (other.index != SIZE_MAX) index = other.index;
+        }
+    };
+
+    // 按 2 的幂分段的直方图：第 k 格为 [2^(k-1), 2^k)，第 0 格为小于 1 的值，超出范围的计入最后一格
+    template <typename Field, int Buckets = 32>
+    struct Histogram {
+        std::array<uint32_t, Buckets> counts{};
+        void add(const TickColumns& t, size_t i) {
+            const double value = Field::get(t, i);
+            const int bucket = (value < 1.0) ? 0 : (std::min)(std::ilogb(value) + 1, Buckets - 1);
+            counts[bucket]++;
+        }
+        void merge(const Histogram& other) {
+            for (int k = 0; k < Buckets; ++k) counts[k] += other.counts[k];
+        }
+    };
+
+    template <typename... Metrics>
+    struct MetricSet {
+        std::tuple<Metrics...> metrics;
+
+        // 折叠表达式展开为依次调用各指标的 add，没有虚调用和额外的遍历
+        void add(const TickColumns& t, size_t i) {
+            std::apply([&](auto&... m) { (m.add(t, i), ...); }, metrics);
+        }
+        void merge(const MetricSet& other) {
+            mergeAll(other, std::index_sequence_for<Metrics...>());
+        }
+
+        template <typename M>
+        static constexpr bool has() { return (std::is_same_v<M, Metrics> || ...); }
+        template <typename M>
+        const M& get() const { return std::get<M>(metrics); }
+
+    private:
+        template <size_t... I>
+        void mergeAll(const MetricSet& other, std::index_sequence<I...>) {
+            (std::get<I>(metrics).merge(std::get<I>(other.metrics)), ...);
+        }
+    };
+
+    // 买卖两个方向各一组指标，中性盘不计；一次遍历 [begin, end)
+    template <typename Set>
+    struct BySide {
+        Set buy;
+        Set sell;
+
+        // 先选出目标集合再调用 add，循环体只展开一份，分支预测失败时代价也更小
+        void add(const TickColumns& t, size_t i) {
+            const int8_t side = t.side[i];
+            if (side == SIDE_NEUTRAL) return;
+            (side == SIDE_BUY ? buy : sell).add(t, i);
+        }
+        void accumulate(const TickColumns& t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) add(t, i);
+        }
+        void merge(const BySide& other) {
+            buy.merge(other.buy);
+            sell.merge(other.sell);
+        }
+    };
+
+    // 结果报告使用的指标集合
+    using SummaryMetrics = MetricSet<
+        Count,
+        Sum<Price>, Min<Price>, Max<Price>,
+        Sum<Volume>, Min<Volume>, Max<Volume>,
+        Sum<Amount>, Min<Amount>, Max<Amount>,
+        Last>;
+
+    // 把集合中存在的指标写入 SideSummary，不在集合中的字段保持默认值；是否存在在编译期确定
+    template <typename Set>
+    void fillSummary(const Set& set, const TickColumns& t, int lotSize, SideSummary& s) {
+        static_assert(Set::template has<Count>(), "SideSummary needs Count");
+        s.count = set.template get<Count>().value;
+        if (s.count == 0) return;
+        if constexpr (Set::template has<Sum<Price>>()) s.sumPrice = set.template get<Sum<Price>>().value;
+        if constexpr (Set::template has<Min<Price>>()) s.minPrice = set.template get<Min<Price>>().value;
+        if constexpr (Set::template has<Max<Price>>()) s.maxPrice = set.template get<Max<Price>>().value;
+        if constexpr (Set::template has<Sum<Volume>>()) {
+            s.sumVolume = set.template get<Sum<Volume>>().value;
+            s.avgVolume = s.sumVolume / s.count;
+        }
+        if constexpr (Set::template has<Min<Volume>>()) s.minVolume = set.template get<Min<Volume>>().value;
+        if constexpr (Set::template has<Max<Volume>>()) s.maxVolume = set.template get<Max<Volume>>().value;
+        if constexpr (Set::template has<Sum<Amount>>()) {
+            s.sumAmount = set.template get<Sum<Amount>>().value;
+            s.avgAmount = s.sumAmount / s.count;
+        }
+        if constexpr (Set::template has<Min<Amount>>()) s.minAmount = set.template get<Min<Amount>>().value;
+        if constexpr (Set::template has<Max<Amount>>()) s.maxAmount = set.template get<Max<Amount>>().value;
+        // 已有成交量和成交额的合计时直接计算均价，不必再累加一次
+        if constexpr (Set::template has<Vwap>()) {
+            s.avgPrice = set.template get<Vwap>().value(lotSize);
+        }
+        else if constexpr (Set::template has<Sum<Volume>>() && Set::template has<Sum<Amount>>()) {
+            Vwap vwap;
+            vwap.amount = s.sumAmount;
+            vwap.volume = s.sumVolume;
+            s.avgPrice = vwap.value(lotSize);
+        }
+        if constexpr (Set::template has<Last>()) {
+            const size_t i = set.template get<Last>().index;
+            if (i != SIZE_MAX) {
+                s.lastTime = t.time[i];
+                s.lastPrice = t.price[i];
+                s.lastVolume = t.volume[i];
+                s.lastAmount = t.amount[i];
+            }
+        }
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <wx/string.h>
+
+// 微秒转成便于阅读的时长
+wxString formatDuration(int64_t us);
+
+// 单页请求的耗时明细（微秒）
+struct PageTiming {
+    int page = -1;
+    int64_t dnsUs = 0;          // DNS 解析
+    int64_t connectUs = 0;      // TCP 连接
+    int64_t tlsUs = 0;          // TLS 握手
+    int64_t transferUs = 0;     // 发送请求到传输完成
+    int64_t totalUs = 0;        // 整个请求
+    int64_t parseUs = 0;        // 解析该页
+    size_t bytes = 0;           // 接收字节数
+    size_t ticks = 0;           // 解析出的成交笔数
+    size_t skipped = 0;         // 缺少字段被跳过的记录数
+    bool hedged = false;        // 发出过对冲请求
+    bool hedgeWon = false;      // 对冲请求先完成
+};
+
+// 单次查询的各阶段耗时，由工作线程填充后交给界面线程
+struct QueryMetrics {
+    PageTiming pagesRequest;            // getTimePages 的分页请求
+    std::vector<PageTiming> pages;      // 每一页的请求与解析
+    int64_t fetchUs = 0;                // 取数阶段总耗时（含限速等待）
+    int64_t aggregateUs = 0;            // 统计分析
+    int64_t formatUs = 0;               // 表格格式化
+    size_t cachedPages = 0;             // 直接使用内存缓存的页数
+    size_t cachedTicks = 0;             // 缓存页中的成交笔数
+    size_t sharedPages = 0;             // 与同时进行的其他查询共享请求的页数
+    size_t diskPages = 0;               // 从本地归档读取的页数
+    std::vector<int> missingPages;      // 本次失败的页，后台重试取得后放入缓存，再次查询时只请求仍然缺少的页
+    wxString plan;                      // 查询计划说明
+
+    size_t totalBytes() const;
+    size_t totalTicks() const;
+    wxString summary() const;
+};
+
+// 简单的计时器
+class StopWatch {
+public:
+    StopWatch() : start_(std::chrono::steady_clock::now()) {}
+    int64_t elapsedUs() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count();
+    }
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+// HDR 风格直方图：按 2 的幂分段，每段线性细分为 32 格，相对误差约 3%
+class Histogram {
+public:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    static constexpr int MAX_BITS = 40;
+    static constexpr int BUCKET_COUNT = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+    void record(uint64_t value);
+    void merge(const Histogram& other);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+    uint64_t percentile(double p) const;
+
+private:
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketUpper(int index);
+
+    std::array<uint64_t, BUCKET_COUNT> counts_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+// 滚动直方图：按时间片轮转，只保留最近一段时间窗口内的数据
+class RollingHistogram {
+public:
+    static constexpr int SLOT_COUNT = 6;
+    static constexpr int SLOT_SECONDS = 600;
+
+    void record(uint64_t value);
+    Histogram snapshot() const;
+
+private:
+    void rotate(int64_t epoch);
+
+    mutable std::mutex mutex_;
+    std::array<Histogram, SLOT_COUNT> slots_;
+    std::array<int64_t, SLOT_COUNT> epochs_{};
+};
+
+// 进程内的指标注册表，按名称保存滚动直方图和累计计数器
+// 指标文件由后台线程定期合并写入，界面线程记录查询时不做文件操作
+class Metrics {
+public:
+    static Metrics& getInstance();
+
+    RollingHistogram& histogram(const std::string& name, const std::string& unit = "us");
+    std::atomic<uint64_t>& counter(const std::string& name);
+    void record(const QueryMetrics& metrics);
+    bool dump(const std::string& path) const;
+    std::string getMetricsFile() const;
+    // 停止后台线程并写入尚未写入的数据，程序退出时调用
+    void flush();
+
+private:
+    Metrics() = default;
+    ~Metrics();
+    void scheduleFlush();
+    void flushLoop();
+
+    struct Entry {
+        std::string unit;
+        RollingHistogram histogram;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<Entry>> entries_;
+    std::map<std::string, std::unique_ptr<std::atomic<uint64_t>>> counters_;
+
+    // 以下成员由 flushMutex_ 保护
+    std::mutex flushMutex_;
+    std::condition_variable flushCondition_;
+    std::thread flusher_;
+    bool dirty_ = false;
+    bool stopping_ = false;
+};
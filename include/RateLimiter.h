@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+
+// 令牌桶限速：所有线程共享同一个桶，保证对数据接口的总请求频率不超过设定值
+class RateLimiter {
+public:
+    static RateLimiter& getInstance();
+
+    void configure(double ratePerSecond, double burst);
+
+    // 阻塞直到取得一个令牌
+    void acquire();
+    // 有令牌时取走并返回 true，否则立即返回 false
+    bool tryAcquire();
+
+private:
+    RateLimiter() = default;
+    void refill(std::chrono::steady_clock::time_point now);
+
+    std::mutex mutex_;
+    double rate_ = 2.0;
+    double burst_ = 1.0;
+    double tokens_ = 1.0;
+    std::chrono::steady_clock::time_point last_ = std::chrono::steady_clock::now();
+};
+
+// 请求预算用完，调用方应停止而不是重试
+class RequestBudgetExceeded : public std::runtime_error {
+public:
+    RequestBudgetExceeded() : std::runtime_error("request budget exhausted") {}
+};
+
+// 一次运行最多发出的网络请求数。每个请求（包括重试和对冲请求）发出前预留一个名额，多个线程共享同一预算。
+// 预算通过 Scope 绑定到线程，查询内部启动的取数线程需要再绑定一次
+class RequestBudget {
+public:
+    explicit RequestBudget(size_t limit) : limit_(limit) {}
+
+    // 预留一个请求名额，已经用完时返回 false
+    bool reserve();
+    size_t used() const { return used_.load(std::memory_order_relaxed); }
+    bool exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+    // 当前线程绑定的预算，没有时为 nullptr
+    static RequestBudget* current();
+    // 当前线程有预算时预留一个名额，用完时抛出 RequestBudgetExceeded
+    static void charge();
+    // 与 charge 相同但不抛出异常，用于可以放弃的请求
+    static bool tryCharge();
+
+    class Scope {
+    public:
+        explicit Scope(RequestBudget* budget);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        RequestBudget* previous_;
+    };
+
+private:
+    const size_t limit_;
+    std::atomic<size_t> used_{ 0 };
+    std::atomic<bool> exhausted_{ false };
+};
@@ -1,18 +1,23 @@
-#ifndef RESULTFRAME_H
-#define RESULTFRAME_H
-
-#include <wx/wx.h>
-#include <StockData.h>
-
-class ResultWindow : public wxDialog {
-private:
-    void analyzeData(const std::string& stockCode, const std::vector<TickData>& data);
-
-public:
-    ResultWindow(wxWindow* parent, const wxString& title);
-    int ResultWindow::ShowModal() override;
-    void ShowResult(const std::string& stockCode, const std::vector<TickData>& data);
-    int ShowModalResult(const std::string& stockCode, const std::vector<TickData>& data);
-};
-
+#ifndef RESULTFRAME_H
+#define RESULTFRAME_H
+
+#include <wx/wx.h>
+#include <memory>
+#include <StockData.h>
+
+class ResultWindow : public wxDialog {
+private:
+    void analyzeData(const std::string& stockCode, std::shared_ptr<const TickColumns> data, QueryMetrics metrics);
+    void OnExport(wxCommandEvent& event);
+
+    AnalysisResult result_;
+    std::shared_ptr<const TickColumns> ticks_;
+
+public:
+    ResultWindow(wxWindow* parent, const wxString& title);
+    int ResultWindow::ShowModal() override;
+    void ShowResult(const std::string& stockCode, std::shared_ptr<const TickColumns> data, const QueryMetrics& metrics = QueryMetrics());
+    int ShowModalResult(const std::string& stockCode, std::shared_ptr<const TickColumns> data, const QueryMetrics& metrics = QueryMetrics());
+};
+
 #endif // RESULTFRAME_H
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// 先进先出的环形缓冲区，容量为 2 的幂，满时翻倍；滑动窗口从队尾加入、从队首过期，
+// 单调队列还会从队尾弹出。与 std::deque 相比元素连续存放，没有分块的间接寻址
+template <typename T>
+class RingBuffer {
+public:
+    bool empty() const { return head_ == tail_; }
+    size_t size() const { return tail_ - head_; }
+
+    T& front() { return slots_[head_ & mask_]; }
+    const T& front() const { return slots_[head_ & mask_]; }
+    T& back() { return slots_[(tail_ - 1) & mask_]; }
+    const T& back() const { return slots_[(tail_ - 1) & mask_]; }
+
+    void push_back(const T& value) {
+        if (tail_ - head_ == slots_.size()) grow();
+        slots_[tail_ & mask_] = value;
+        tail_++;
+    }
+    void pop_front() { head_++; }
+    void pop_back() { tail_--; }
+    void clear() { head_ = tail_ = 0; }
+
+private:
+    void grow() {
+        std::vector<T> slots((std::max)(slots_.size() * 2, static_cast<size_t>(64)));
+        for (size_t i = head_; i != tail_; ++i) {
+            slots[i - head_] = slots_[i & mask_];
+        }
+        tail_ -= head_;
+        head_ = 0;
+        slots_.swap(slots);
+        mask_ = slots_.size() - 1;
+    }
+
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <wx/wx.h>
+#include <memory>
+#include "MarketScanner.h"
+#include "Metrics.h"
+
+// 全市场扫描窗口：扫描在后台进行，排名随进度刷新；停止后可以从断点继续
+class ScanWindow : public wxFrame {
+public:
+    ScanWindow(wxWindow* parent, const ScanOptions& options);
+    ~ScanWindow() override;
+
+private:
+    void Start();
+    void ShowProgress();
+    void OnCriterion(wxCommandEvent& event);
+    void OnStop(wxCommandEvent& event);
+
+    // 后台扫描回调时窗口可能已经关闭
+    struct ScanState {
+        bool alive = true;
+    };
+
+    ScanOptions options_;
+    std::shared_ptr<MarketScanner> scanner_;
+    std::shared_ptr<ScanState> state_;
+    ScanProgress progress_;
+    StopWatch watch_;
+    bool running_ = false;
+    wxStaticText* status_;
+    wxChoice* criterion_;
+    wxButton* stopButton_;
+    wxTextCtrl* table_;
+};
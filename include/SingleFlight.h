@@ -0,0 +1,49 @@
+#pragma once
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+
+// 合并相同 key 的并发调用：同一时刻只有第一个调用者执行 fn，其余调用者等待并得到同一结果（包括异常）
+template <typename Key, typename Value>
+class SingleFlight {
+public:
+    Value run(const Key& key, const std::function<Value()>& fn, bool* shared = nullptr) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = calls_.find(key);
+        if (it != calls_.end()) {
+            std::shared_future<Value> future = it->second;
+            lock.unlock();
+            if (shared) *shared = true;
+            return future.get();
+        }
+
+        std::promise<Value> promise;
+        calls_.emplace(key, promise.get_future().share());
+        lock.unlock();
+        if (shared) *shared = false;
+
+        try {
+            Value value = fn();
+            finish(key);
+            promise.set_value(value);
+            return value;
+        }
+        catch (...) {
+            finish(key);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+private:
+    // 先移除再发布结果，之后到达的调用者会发起新的请求而不是拿到旧结果
+    void finish(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls_.erase(key);
+    }
+
+    std::mutex mutex_;
+    std::map<Key, std::shared_future<Value>> calls_;
+};
@@ -1,45 +1,115 @@
-#pragma once
-#include <string>
-#include <vector>
-#include <optional>
-#include <wx/string.h>
-#include <wx/window.h>
-
-struct TickData {
-    int index;              // 
-    std::string time;       // ʱ
-    double price;           // ۸
-    double change;          // ǵ
-    double volume;          // ɽ
-    double amount;          // ɽ
-    std::string type;       // ͣ//̣
-    int onehand() const {   // һֶٹ
-        return static_cast<int>(amount / volume / price + 0.5);
-    }
-};
-
-struct StockAnalysis {
-    std::optional<double> minPrice;
-    std::optional<double> maxPrice;
-    std::optional<double> avgPrice;
-    std::optional<int> minVolume;
-    std::optional<int> maxVolume;
-    std::optional<double> avgVolume;
-    int count;
-};
-
-class StockData {
-public:
-    static std::vector<int> getTimePages(const std::string& inputStr);
-    static int timeStringToSeconds(const std::string& timeStr);
-    static int findIndexForTime(const std::vector<int>& timePeriods, int givenSecond);
-    static int findIndexForTime(const std::vector<int>& timePeriods, const std::string& givenTime);
-    static std::vector<TickData> queryStockData(const std::string& stockCode, int stimesec = -1, int etimesec = -1);
-    static wxString analyzeData(const std::vector<TickData>& data);
-private:
-    static std::string getResponseText(const std::string& response);
-    static std::string getStockSymbol(const std::string stockCode);
-    static std::string fetchPageData(const std::string& symbol, int page, const std::string& action = "data");
-    static std::vector<TickData>  StockData::parseStockData(const std::string& response, int stimesec = -1, int etimesec = -1);
-    static wxString formatTableData(std::stringstream ss);
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <optional>
+#include <wx/string.h>
+#include <wx/window.h>
+#include "AnalysisResult.h"
+#include "Metrics.h"
+
+class TextTable;
+
+struct TickData {
+    int index;              // 序号
+    std::string time;       // 时间
+    double price;           // 价格
+    double change;          // 涨跌幅
+    double volume;          // 成交量
+    double amount;          // 成交金额
+    std::string type;       // 类型（买盘/卖盘/中性盘）
+    int onehand() const {   // 计算一手多少股
+        return static_cast<int>(amount / volume / price + 0.5);
+    }
+};
+
+// 成交方向
+enum TickSide : int8_t {
+    SIDE_SELL = -1,
+    SIDE_NEUTRAL = 0,
+    SIDE_BUY = 1,
+};
+
+// 按列存放的成交明细，分析与导出直接使用这些列
+struct TickColumns {
+    std::vector<int32_t> index;     // 序号
+    std::vector<int32_t> time;      // 时间（当天秒数）
+    std::vector<double> price;      // 价格
+    std::vector<double> change;     // 涨跌幅
+    std::vector<double> volume;     // 成交量
+    std::vector<double> amount;     // 成交金额
+    std::vector<int8_t> side;       // 类型（TickSide）
+
+    size_t size() const { return index.size(); }
+    bool empty() const { return index.empty(); }
+    void reserve(size_t n);
+    void resize(size_t n);
+    void clear();
+    void push(int32_t index, int32_t time, double price, double change, double volume, double amount, int8_t side);
+    void append(const TickColumns& other);
+    size_t appendRange(const TickColumns& other, int stimesec, int etimesec);
+    TickData row(size_t i) const;
+    size_t memoryBytes() const;
+};
+
+struct StockAnalysis {
+    std::optional<double> minPrice;
+    std::optional<double> maxPrice;
+    std::optional<double> avgPrice;
+    std::optional<int> minVolume;
+    std::optional<int> maxVolume;
+    std::optional<double> avgVolume;
+    int count;
+};
+
+// 查询计划中每一页的数据来源
+enum class PageSource {
+    Memory,
+    Disk,
+    Network,
+};
+
+struct PlannedPage {
+    int page;
+    PageSource source;
+};
+
+struct QueryPlan {
+    std::vector<PlannedPage> pages;
+    bool diskDay = false;       // 收盘后归档的整日数据，直接从本地读取
+
+    wxString describe() const;
+};
+
+// 多股票对比中的一项
+struct ComparisonEntry {
+    std::string stockCode;
+    AnalysisResult result;
+    QueryMetrics metrics;
+    std::string error;          // 查询失败时的原因
+};
+
+class DataSource;
+struct CachedDay;
+
+class StockData {
+public:
+    static int timeStringToSeconds(const std::string& timeStr);
+    static std::string secondsToTimeString(int seconds);
+    static int findIndexForTime(const std::vector<int>& timePeriods, int givenSecond);
+    static int findIndexForTime(const std::vector<int>& timePeriods, const std::string& givenTime);
+    static TickColumns queryStockData(const std::string& stockCode, int stimesec = -1, int etimesec = -1, QueryMetrics* metrics = nullptr);
+    static TickColumns importStockData(const std::string& path, int stimesec = -1, int etimesec = -1, QueryMetrics* metrics = nullptr);
+    static AnalysisResult analyzeData(const std::string& stockCode, const TickColumns& data, QueryMetrics* metrics = nullptr);
+    static wxString formatResult(const AnalysisResult& result, QueryMetrics* metrics = nullptr);
+    static void warmUp(const std::string& stockCode = "");
+    static std::vector<ComparisonEntry> compareStocks(const std::vector<std::string>& stockCodes, int stimesec = -1, int etimesec = -1);
+    static wxString formatComparison(const std::vector<ComparisonEntry>& entries);
+    static std::string getStockSymbol(const std::string stockCode);
+private:
+    static std::shared_ptr<const TickColumns> fetchTicks(DataSource& source, const std::string& symbol, int page, PageTiming* timing = nullptr, bool* shared = nullptr);
+    static void retryPages(std::shared_ptr<DataSource> source, const std::string& symbol, int32_t date, std::shared_ptr<const CachedDay> day, std::vector<int> pages);
+    static wxString formatTableData(const TextTable& table);
+    static void archiveStockData(const std::string& symbol, const TickColumns& data, bool complete);
 };
\ No newline at end of file
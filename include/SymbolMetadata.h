@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 交易时段（当天秒数）
+struct TradingSession {
+    int open;
+    int close;
+};
+
+// 股票的基础信息和当天的分页表
+struct SymbolInfo {
+    std::string symbol;                     // getStockSymbol 规范化后的代码
+    std::string exchange;                   // 交易所
+    int lotSize = 0;                        // 每手股数，0 表示未知
+    std::vector<TradingSession> sessions;   // 交易时段，为空表示未知
+    int32_t pagesDate = 0;                  // 分页表对应的交易日
+    std::string pagesSource;                // 分页表来自哪个数据源
+    std::vector<int> timePages;             // getTimePages 的结果
+    bool pagesComplete = false;             // 收盘后取得的分页表，不会再变化
+
+    // 指定交易日的交易是否已经结束
+    bool isClosed(int32_t date) const;
+    // 保存的分页表可以直接使用：同一交易日、同一数据源，且收盘后取得或仍在交易中
+    bool hasPages(int32_t date, const std::string& source) const;
+};
+
+// 持久化的股票元数据缓存，保存在 <程序目录>/stock_symbols.json
+// 分页表在交易时段内只有最后一个边界会增长，因此当天的分页表可以直接复用，新增的页由查询时探测
+class SymbolMetadata {
+public:
+    static SymbolMetadata& getInstance();
+
+    bool load();
+    bool save() const;
+
+    // 取得股票信息，没有记录时按代码前缀填入交易所、每手股数和交易时段的默认值
+    SymbolInfo get(const std::string& symbol) const;
+    // 只返回已记录的股票
+    bool find(const std::string& symbol, SymbolInfo& info) const;
+    void update(const SymbolInfo& info);
+    // 批量查询期间只更新内存，结束时统一保存一次，避免每只股票都重写整个文件
+    void beginBatch();
+    void endBatch();
+
+private:
+    SymbolMetadata();
+
+    std::string metadataFile_ = "stock_symbols.json";
+    mutable std::mutex mutex_;
+    mutable std::mutex fileMutex_;          // 串行化文件写入，先于 mutex_ 加锁
+    std::map<std::string, SymbolInfo> symbols_;
+    int batchDepth_ = 0;
+    bool dirty_ = false;
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include "DataSource.h"
+
+// 腾讯成交明细接口 stock.gtimg.cn
+class TencentSource : public DataSource {
+public:
+    std::string name() const override { return "tencent/1"; }
+    std::vector<int> getTimePages(const std::string& symbol, PageTiming* timing = nullptr) override;
+    std::string fetchPage(const std::string& symbol, int page, PageTiming* timing = nullptr) override;
+    size_t decodePage(const std::string& response, TickColumns& out, size_t* skipped = nullptr) override;
+    void warmUp() override;
+
+private:
+    static std::string getResponseText(const std::string& response);
+    static std::string fetchPageData(const std::string& symbol, int page, const std::string& action, PageTiming* timing);
+    static std::string fetchPageHedged(const std::string& symbol, int page, PageTiming* timing);
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 等宽字体下的文本表格：单元格在加入时格式化并计算显示宽度，渲染时一次写入预分配的缓冲区
+class TextTable {
+public:
+    void reserve(size_t rows, size_t cells);
+
+    // 非表格行，原样输出
+    void addLine(const std::string& text);
+
+    // 开始新的表格行，随后依次加入单元格
+    void beginRow();
+    void addText(const std::string& text);
+    void addNumber(double value, int precision = 2, const std::string& suffix = "");
+    void addInteger(long long value);
+
+    std::string render() const;
+
+    // UTF-8 文本在等宽字体下的显示宽度，东亚宽字符计为 2
+    static int displayWidth(const char* text, size_t length);
+
+private:
+    struct Cell {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t width;
+    };
+
+    struct Row {
+        bool isTable;
+        uint32_t first;     // 表格行：第一个单元格下标；普通行：文本在 arena_ 中的偏移
+        uint32_t count;     // 表格行：单元格数量；普通行：文本长度
+    };
+
+    void pushCell(uint32_t offset, uint32_t width);
+
+    std::string arena_;
+    std::vector<Cell> cells_;
+    std::vector<Row> rows_;
+    std::vector<uint32_t> columnWidths_;
+};
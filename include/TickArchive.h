@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "StockData.h"
+
+enum ArchiveBlockFlags : uint16_t {
+    ARCHIVE_SORTED = 1,         // 时间单调不减，可以二分查找颗粒
+    ARCHIVE_COMPLETE = 2,       // 收盘后写入的整日数据
+};
+
+// 归档文件中每个交易日数据块的摘要，统一存放在文件尾部的目录中，
+// 读取时只需查看目录即可按日期、时间、价格跳过不相关的数据块
+struct ArchiveBlock {
+    uint64_t offset;            // 数据块在文件中的偏移
+    uint32_t size;              // 数据块字节数
+    uint32_t crc;               // 数据块 CRC32
+    int32_t date;               // 交易日 yyyymmdd
+    uint32_t rows;              // 成交笔数
+    int32_t minTime;            // 最早时间（当天秒数）
+    int32_t maxTime;            // 最晚时间（当天秒数）
+    int32_t firstIndex;         // 第一笔序号
+    int32_t lotSize;            // 每手股数，用于预测成交金额
+    double minPrice;            // 最低价
+    double maxPrice;            // 最高价
+    double volume;              // 总成交量
+    double amount;              // 总成交金额
+    uint32_t columnSize[7];     // 各列编码后的字节数
+    uint8_t encoding[7];        // 各列编码方式
+    uint8_t priceDigits;        // 价格定点小数位数
+    uint16_t granuleRows;       // 稀疏时间索引每个颗粒的行数，0 表示没有索引
+    uint16_t flags;             // ArchiveBlockFlags
+};
+
+// 按交易日分块、按列压缩的成交明细归档：序号、时间和定点价格做差分，数量和金额用 zigzag varint，
+// 每个数据块带 CRC32 校验和稀疏时间索引。读取时内存映射整个文件，只解码时间范围覆盖的颗粒。
+// 对象存在期间持有该文件的共享锁，writeDay 替换文件前等待所有读取者释放映射（Windows 上映射中的文件不能替换），
+// 因此不要长时间持有，也不要在持有同一文件的 TickArchive 时调用 writeDay
+class TickArchive {
+public:
+    explicit TickArchive(const std::string& path);
+
+    const std::vector<ArchiveBlock>& blocks() const { return blocks_; }
+    size_t fileSize() const { return file_.size(); }
+    const ArchiveBlock* findBlock(int32_t date) const;
+
+    // 读取 [fromDate, toDate] 内的数据，按时间范围过滤，多日数据按日期顺序拼接
+    TickColumns read(int32_t fromDate = 0, int32_t toDate = INT32_MAX, int stimesec = -1, int etimesec = -1) const;
+    size_t readBlock(const ArchiveBlock& block, TickColumns& out, int stimesec = -1, int etimesec = -1) const;
+
+    // 写入（或替换）一个交易日的数据，先写临时文件再替换原文件
+    // 数据与另一交易日完全相同时不写入并返回 false
+    static bool writeDay(const std::string& path, int32_t date, const TickColumns& ticks, bool complete = false);
+    static bool exists(const std::string& path);
+
+    // <程序目录>/archive/<股票代码>.tka，返回 UTF-8 路径
+    static std::string getArchiveFile(const std::string& symbol);
+
+    // 当前对应的交易日：开盘前算作上一日，周末退回到周五
+    static int32_t currentTradingDate();
+
+private:
+    static std::shared_mutex& fileLock(const std::string& path);
+
+    std::shared_lock<std::shared_mutex> lock_;          // 在映射之前取得，之后释放
+    MappedFile file_;
+    std::vector<ArchiveBlock> blocks_;
+    std::unique_ptr<std::atomic<bool>[]> verified_;    // 已通过校验的数据块，同一文件只校验一次
+};
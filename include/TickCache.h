@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "StockData.h"
+
+// 缓存中的一页数据；final 表示取得时已有后续页，内容不会再变化
+struct CachedPage {
+    std::shared_ptr<const TickColumns> ticks;
+    bool final = false;
+};
+
+// 一只股票一个交易日已解析的分页数据，未经时间过滤
+struct CachedDay {
+    std::vector<int> timePages;         // getTimePages 的结果
+    std::vector<CachedPage> pages;      // 按页码存放，未取得的页为空
+    bool complete = false;              // 收盘后取得的完整数据，不需要再请求网络
+
+    size_t memoryBytes() const;
+};
+
+struct TickCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+    size_t capacity = 0;
+};
+
+// 进程内按 (股票代码, 交易日, 数据源版本) 缓存已解析的成交明细，超出内存上限时淘汰最久未使用的交易日
+class TickCache {
+public:
+    static TickCache& getInstance();
+
+    std::shared_ptr<const CachedDay> find(const std::string& symbol, int32_t date, const std::string& source);
+    void put(const std::string& symbol, int32_t date, const std::string& source, std::shared_ptr<const CachedDay> day);
+    void setCapacity(size_t bytes);
+    void clear();
+    TickCacheStats stats() const;
+
+private:
+    TickCache() = default;
+
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const CachedDay> day;
+        size_t bytes;
+    };
+
+    static std::string makeKey(const std::string& symbol, int32_t date, const std::string& source);
+    void evict();
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;      // 表头为最近使用
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    size_t bytes_ = 0;
+    size_t capacity_ = 256 * 1024 * 1024;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include "TickView.h"
+#include <wx/listctrl.h>
+#include <wx/wx.h>
+#include <memory>
+
+// 虚拟列表：只在行可见时格式化单元格，排序和过滤都通过 TickView 的行号排列完成
+class TickList : public wxListCtrl {
+public:
+    TickList(wxWindow* parent, std::shared_ptr<const TickColumns> ticks);
+
+    TickView& view() { return view_; }
+    // 视图变化后刷新行数和可见行
+    void reload();
+
+protected:
+    wxString OnGetItemText(long item, long column) const override;
+
+private:
+    void OnColumnClick(wxListEvent& event);
+
+    TickView view_;
+};
+
+// 带过滤条件的成交明细面板
+class TickGrid : public wxPanel {
+public:
+    TickGrid(wxWindow* parent, std::shared_ptr<const TickColumns> ticks);
+
+private:
+    void OnFilter(wxCommandEvent& event);
+    void UpdateCount();
+
+    TickList* list_;
+    wxChoice* sideChoice_;
+    wxTextCtrl* minVolumeBox_;
+    wxStaticText* countLabel_;
+};
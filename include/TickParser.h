@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include "StockData.h"
+
+// 成交明细文本解析：记录以 '|' 或换行分隔，字段以 '/' 或 ',' 分隔，
+// 字段顺序为 index/time/price/change/volume/amount/type，与接口返回及导出的 CSV 一致
+class TickParser {
+public:
+    // 解析 [begin, end) 内的记录并追加到 out，返回追加的笔数；无法解析的记录计入 skipped
+    static size_t parseRange(const char* begin, const char* end, TickColumns& out,
+        int stimesec = -1, int etimesec = -1, size_t* skipped = nullptr);
+
+    // 按记录边界切分后多线程解析，结果保持原有顺序
+    static TickColumns parseParallel(const char* data, size_t size, int stimesec = -1, int etimesec = -1,
+        size_t* skipped = nullptr, unsigned threads = 0);
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include "StockData.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 成交明细的列
+enum TickField {
+    FIELD_INDEX,
+    FIELD_TIME,
+    FIELD_PRICE,
+    FIELD_CHANGE,
+    FIELD_VOLUME,
+    FIELD_AMOUNT,
+    FIELD_SIDE,
+    FIELD_COUNT,
+};
+
+// 明细过滤条件
+struct TickFilter {
+    bool buy = true;
+    bool sell = true;
+    bool neutral = true;
+    double minVolume = 0;
+    int stimesec = -1;
+    int etimesec = -1;
+};
+
+// 成交明细的排序过滤视图：只保存行号排列，不复制数据
+class TickView {
+public:
+    explicit TickView(std::shared_ptr<const TickColumns> ticks = nullptr);
+
+    void setFilter(const TickFilter& filter);
+    // FIELD_COUNT 表示按原始顺序
+    void sort(TickField field, bool ascending);
+
+    size_t size() const { return rows_.size(); }
+    size_t totalSize() const { return ticks_ ? ticks_->size() : 0; }
+    // 视图中第 i 行对应的原始行号
+    uint32_t row(size_t i) const { return rows_[i]; }
+    const TickColumns& ticks() const { return *ticks_; }
+    TickField sortField() const { return sortField_; }
+    bool ascending() const { return ascending_; }
+
+private:
+    void applySort();
+
+    std::shared_ptr<const TickColumns> ticks_;
+    std::vector<uint32_t> rows_;
+    TickFilter filter_;
+    TickField sortField_ = FIELD_COUNT;
+    bool ascending_ = true;
+};
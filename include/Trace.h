@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 编译时打开 STOCK_ENABLE_TRACE 才会生成埋点；运行时默认关闭，关闭时每个埋点只有一次原子读
+#ifdef STOCK_ENABLE_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, arg) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, arg)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_ARG(name, arg) ((void)0)
+#endif
+
+// 一个已完成的时间段，name 必须是字符串字面量
+struct TraceEvent {
+    const char* name;
+    int64_t startUs;
+    int64_t durationUs;
+    int64_t arg;
+};
+
+// 按线程缓存时间段，导出为 Chrome trace-event JSON（可用 Perfetto 打开）
+class Trace {
+public:
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+    static int64_t nowUs();
+    static void record(const char* name, int64_t startUs, int64_t durationUs, int64_t arg = -1);
+    static void setThreadName(const std::string& name);
+    static bool write(const std::string& path);
+    static std::string getTraceFile();
+
+private:
+    inline static std::atomic<bool> enabled_{ false };
+};
+
+// 作用域计时，析构时写入当前线程的缓冲区
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, int64_t arg = -1)
+        : name_(name), arg_(arg), startUs_(Trace::enabled() ? Trace::nowUs() : -1) {}
+    ~TraceScope() {
+        if (startUs_ >= 0) {
+            Trace::record(name_, startUs_, Trace::nowUs() - startUs_, arg_);
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    int64_t arg_;
+    int64_t startUs_;
+};
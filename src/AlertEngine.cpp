@@ -0,0 +1,143 @@
+#include "Common.h"
+#include "AlertEngine.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <cmath>
+#include <stdexcept>
+
+AlertEngine::AlertEngine(const std::vector<AlertRuleEntry>& rules, size_t queueCapacity)
+    : queue_(queueCapacity) {
+    for (const auto& entry : rules) {
+        Rule rule;
+        rule.name = entry.name;
+        rule.kind = entry.kind == "window" ? AlertKind::Window
+            : entry.kind == "vwap_cross" ? AlertKind::VwapCross
+            : entry.kind == "flow_spike" ? AlertKind::FlowSpike
+            : AlertKind::Tick;
+        if (!entry.filter.empty() && (rule.kind == AlertKind::Tick || rule.kind == AlertKind::Window)) {
+            try {
+                rule.filter = std::make_unique<Formula>(Formula::compileCondition(entry.filter));
+            }
+            catch (const std::runtime_error& e) {
+                throw std::runtime_error(entry.name + ": " + e.what());
+            }
+        }
+        rule.value = entry.value == "volume" ? WindowValue::Volume : entry.value == "count" ? WindowValue::Count : WindowValue::Amount;
+        rule.window = (std::max)(entry.window, 1);
+        rule.threshold = entry.threshold;
+        rule.averageMultiple = entry.averageMultiple;
+        rules_.push_back(std::move(rule));
+    }
+}
+
+void AlertEngine::emit(Alert alert) {
+    if (!queue_.push(std::move(alert))) {
+        dropped_++;
+        Metrics::getInstance().counter("alerts.dropped")++;
+    }
+}
+
+void AlertEngine::process(const std::string& stockCode, const TickColumns& ticks, size_t begin, bool notify) {
+    TRACE_SCOPE("AlertEngine::process");
+    const size_t end = ticks.size();
+    if (begin >= end) return;
+    SymbolState& state = symbols_[stockCode];
+    if (state.firstTime < 0) {
+        state.firstTime = ticks.time[begin];
+        state.rules.resize(rules_.size());
+    }
+
+    for (size_t r = 0; r < rules_.size(); ++r) {
+        const Rule& rule = rules_[r];
+        RuleState& current = state.rules[r];
+        if (rule.kind == AlertKind::Tick && !notify) continue;
+        // 条件对整批新成交一次求值
+        if (rule.filter) {
+            rule.filter->evaluateCondition(ticks, begin, end, mask_);
+        }
+        auto matches = [&](size_t i) { return !rule.filter || mask_[i - begin] != 0; };
+
+        switch (rule.kind) {
+        case AlertKind::Tick: {
+            for (size_t i = begin; i < end; ++i) {
+                if (matches(i)) emit(Alert{ stockCode, rule.name, rule.kind, ticks.time[i], ticks.amount[i], ticks.price[i] });
+            }
+            break;
+        }
+        case AlertKind::Window: {
+            for (size_t i = begin; i < end; ++i) {
+                const int t = ticks.time[i];
+                // 窗口为 (t - window, t]，过期的成交从队首出队
+                while (!current.entries.empty() && current.entries.front().first <= t - rule.window) {
+                    current.sum -= current.entries.front().second;
+                    current.entries.pop_front();
+                }
+                // 窗口清空时归零，避免加减累积的舍入误差
+                if (current.entries.empty()) current.sum = 0.0;
+                if (matches(i)) {
+                    const double v = rule.value == WindowValue::Amount ? ticks.amount[i] : rule.value == WindowValue::Volume ? ticks.volume[i] : 1.0;
+                    current.entries.emplace_back(t, v);
+                    current.sum += v;
+                    current.total += v;
+                }
+                // 平均窗口合计 = 当天合计 / 已经过的时间 * 窗口长度，开盘后不足一个窗口时不比较
+                const int elapsed = t - state.firstTime;
+                double limit = rule.threshold > 0 ? rule.threshold : INFINITY;
+                if (rule.averageMultiple > 0 && elapsed >= rule.window) {
+                    limit = (std::min)(limit, rule.averageMultiple * current.total / elapsed * rule.window);
+                }
+                const bool above = current.sum > limit;
+                if (above && !current.firing && notify) {
+                    emit(Alert{ stockCode, rule.name, rule.kind, t, current.sum, limit });
+                }
+                current.firing = above;
+            }
+            break;
+        }
+        case AlertKind::VwapCross: {
+            for (size_t i = begin; i < end; ++i) {
+                const double price = ticks.price[i];
+                if (price <= 0) continue;
+                current.amount += ticks.amount[i];
+                current.shares += ticks.amount[i] / price;
+                if (current.shares <= 0) continue;
+                const double vwap = current.amount / current.shares;
+                const double band = vwap * rule.threshold;
+                const int side = price > vwap + band ? 1 : price < vwap - band ? -1 : 0;
+                if (side != 0 && current.side != 0 && side != current.side && notify) {
+                    emit(Alert{ stockCode, rule.name, rule.kind, ticks.time[i], price, vwap });
+                }
+                if (side != 0) current.side = side;
+            }
+            break;
+        }
+        case AlertKind::FlowSpike: {
+            if (!current.flow) {
+                current.flow.emplace(rule.window, rule.threshold > 0 ? rule.threshold : Config::getInstance().getFlowZThreshold(),
+                    Config::getInstance().getFlowBaselineSeconds());
+            }
+            for (size_t i = begin; i < end; ++i) {
+                if (current.flow->add(ticks, i) && notify) {
+                    emit(Alert{ stockCode, rule.name, rule.kind, ticks.time[i], current.flow->zScore(), current.flow->imbalance() });
+                }
+            }
+            break;
+        }
+        }
+    }
+}
+
+wxString AlertEngine::formatAlert(const Alert& alert) {
+    switch (alert.kind) {
+    case AlertKind::Tick:
+        return wxString::Format(_("amount %.0f at %.2f"), alert.value, alert.reference);
+    case AlertKind::Window:
+        return wxString::Format(_("window total %.0f > %.0f"), alert.value, alert.reference);
+    case AlertKind::VwapCross:
+        return wxString::Format(alert.value > alert.reference ? _("price %.2f crossed above VWAP %.2f") : _("price %.2f crossed below VWAP %.2f"),
+            alert.value, alert.reference);
+    case AlertKind::FlowSpike:
+        return wxString::Format(_("volume z-score %.1f, buy/sell imbalance %+.0f%%"), alert.value, alert.reference * 100);
+    }
+    return wxEmptyString;
+}
@@ -0,0 +1,394 @@
+#include "ArrowWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+
+// Arrow 元数据使用的 FlatBuffers 常量
+namespace {
+    const int16_t METADATA_V5 = 4;
+    const uint8_t HEADER_SCHEMA = 1;
+    const uint8_t HEADER_RECORD_BATCH = 3;
+    const uint8_t TYPE_INT = 2;
+    const uint8_t TYPE_FLOATING_POINT = 3;
+    const uint8_t TYPE_UTF8 = 5;
+    const uint8_t TYPE_TIME = 9;
+    const int16_t PRECISION_DOUBLE = 2;
+    const int16_t TIME_UNIT_SECOND = 0;
+    const size_t BODY_ALIGNMENT = 64;
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+// 极简的 FlatBuffers 构建器：父对象在前、子对象在后，所有偏移都指向更高地址
+class ArrowFlatBuilder {
+public:
+    struct Field {
+        int id;
+        int size;                                           // 标量字节数，子对象偏移为 4
+        uint64_t value;
+        std::function<size_t(ArrowFlatBuilder&)> child;     // 非空时该字段为子对象偏移
+    };
+
+    std::vector<uint8_t> buffer;
+
+    void pad(size_t alignment) {
+        while (buffer.size() % alignment) buffer.push_back(0);
+    }
+
+    template <typename T>
+    size_t put(T value) {
+        pad(sizeof(T));
+        const size_t pos = buffer.size();
+        buffer.resize(pos + sizeof(T));
+        memcpy(&buffer[pos], &value, sizeof(T));
+        return pos;
+    }
+
+    void patchOffset(size_t at, size_t target) {
+        const uint32_t offset = static_cast<uint32_t>(target - at);
+        memcpy(&buffer[at], &offset, sizeof(offset));
+    }
+
+    // 写入 vtable 和表，随后依次写入子对象并回填偏移
+    size_t table(std::vector<Field> fields) {
+        int slots = 0;
+        for (const auto& f : fields) slots = (std::max)(slots, f.id + 1);
+
+        std::stable_sort(fields.begin(), fields.end(), [](const Field& a, const Field& b) { return a.size > b.size; });
+        std::vector<uint16_t> slotOffsets(slots, 0);
+        std::vector<size_t> fieldOffsets;
+        size_t inlineSize = 4;
+        for (const auto& f : fields) {
+            inlineSize = alignUp(inlineSize, f.size);
+            fieldOffsets.push_back(inlineSize);
+            slotOffsets[f.id] = static_cast<uint16_t>(inlineSize);
+            inlineSize += f.size;
+        }
+
+        pad(2);
+        const size_t vtablePos = buffer.size();
+        put<uint16_t>(static_cast<uint16_t>(4 + 2 * slots));
+        put<uint16_t>(static_cast<uint16_t>(inlineSize));
+        for (uint16_t offset : slotOffsets) put<uint16_t>(offset);
+
+        pad(8);
+        const size_t tablePos = buffer.size();
+        buffer.resize(tablePos + alignUp(inlineSize, 4), 0);
+        const int32_t soffset = static_cast<int32_t>(tablePos - vtablePos);
+        memcpy(&buffer[tablePos], &soffset, sizeof(soffset));
+
+        for (size_t i = 0; i < fields.size(); ++i) {
+            if (!fields[i].child) {
+                memcpy(&buffer[tablePos + fieldOffsets[i]], &fields[i].value, fields[i].size);
+            }
+        }
+        for (size_t i = 0; i < fields.size(); ++i) {
+            if (fields[i].child) {
+                const size_t childPos = fields[i].child(*this);
+                patchOffset(tablePos + fieldOffsets[i], childPos);
+            }
+        }
+        return tablePos;
+    }
+
+    size_t string(const std::string& text) {
+        const size_t pos = put<uint32_t>(static_cast<uint32_t>(text.size()));
+        buffer.insert(buffer.end(), text.begin(), text.end());
+        buffer.push_back(0);
+        return pos;
+    }
+
+    // 元素按 8 字节对齐的结构体数组
+    size_t structVector(const std::vector<uint8_t>& bytes, size_t count) {
+        pad(4);
+        if ((buffer.size() + 4) % 8) put<uint32_t>(0);
+        const size_t pos = put<uint32_t>(static_cast<uint32_t>(count));
+        buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+        return pos;
+    }
+
+    size_t tableVector(const std::vector<std::function<size_t(ArrowFlatBuilder&)>>& items) {
+        const size_t pos = put<uint32_t>(static_cast<uint32_t>(items.size()));
+        const size_t slots = buffer.size();
+        buffer.resize(slots + items.size() * 4, 0);
+        for (size_t i = 0; i < items.size(); ++i) {
+            patchOffset(slots + i * 4, items[i](*this));
+        }
+        return pos;
+    }
+
+    // 写入根偏移，结果长度补齐到 8 的倍数
+    std::vector<uint8_t> finish(const std::function<size_t(ArrowFlatBuilder&)>& root) {
+        put<uint32_t>(0);
+        patchOffset(0, root(*this));
+        pad(8);
+        return std::move(buffer);
+    }
+};
+
+namespace {
+    template <typename T>
+    void appendBytes(std::vector<uint8_t>& out, T value) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    void writePadding(std::ofstream& file, size_t count) {
+        static const char zeros[BODY_ALIGNMENT] = {};
+        file.write(zeros, count);
+    }
+}
+
+void ArrowWriter::addColumn(const std::string& name, Type type, const void* data, size_t length, size_t width,
+    const std::vector<std::string>* strings) {
+    if (!columns_.empty() && length != rowCount()) {
+        throw std::runtime_error("Arrow column length mismatch: " + name);
+    }
+    columns_.push_back(Column{ name, type, data, length, width, strings, {}, 0 });
+}
+
+size_t ArrowWriter::rowCount() const {
+    return columns_.empty() ? 0 : columns_.front().length;
+}
+
+void ArrowWriter::addInt8(const std::string& name, const std::vector<int8_t>& values) {
+    addColumn(name, Type::Int8, values.data(), values.size(), sizeof(int8_t));
+}
+
+void ArrowWriter::addInt32(const std::string& name, const std::vector<int32_t>& values) {
+    addColumn(name, Type::Int32, values.data(), values.size(), sizeof(int32_t));
+}
+
+void ArrowWriter::addInt64(const std::string& name, const std::vector<int64_t>& values) {
+    addColumn(name, Type::Int64, values.data(), values.size(), sizeof(int64_t));
+}
+
+void ArrowWriter::addFloat64(const std::string& name, const std::vector<double>& values) {
+    addColumn(name, Type::Float64, values.data(), values.size(), sizeof(double));
+}
+
+void ArrowWriter::addTime32(const std::string& name, const std::vector<int32_t>& seconds) {
+    addColumn(name, Type::Time32, seconds.data(), seconds.size(), sizeof(int32_t));
+
+    Column& column = columns_.back();
+    for (size_t i = 0; i < seconds.size(); ++i) {
+        if (seconds[i] < 0) column.nullCount++;
+    }
+    if (column.nullCount > 0) {
+        column.validity.assign((seconds.size() + 7) / 8, 0);
+        for (size_t i = 0; i < seconds.size(); ++i) {
+            if (seconds[i] >= 0) column.validity[i / 8] |= static_cast<uint8_t>(1 << (i % 8));
+        }
+    }
+}
+
+void ArrowWriter::addUtf8(const std::string& name, const std::vector<std::string>& values) {
+    addColumn(name, Type::Utf8, nullptr, values.size(), 0, &values);
+}
+
+// 计算每列缓冲区在消息体中的位置：定长列为 [有效位图, 数值]，字符串列为 [有效位图, 偏移, 数据]
+std::vector<ArrowWriter::Buffer> ArrowWriter::layoutBody(int64_t& bodyLength) const {
+    std::vector<Buffer> buffers;
+    size_t offset = 0;
+    auto add = [&](size_t length) {
+        buffers.push_back(Buffer{ static_cast<int64_t>(offset), static_cast<int64_t>(length) });
+        offset = alignUp(offset + length, BODY_ALIGNMENT);
+    };
+
+    for (const auto& column : columns_) {
+        add(column.validity.size());
+        if (column.type == Type::Utf8) {
+            size_t bytes = 0;
+            for (const auto& s : *column.strings) bytes += s.size();
+            add((column.length + 1) * sizeof(int32_t));
+            add(bytes);
+        }
+        else {
+            add(column.length * column.width);
+        }
+    }
+    bodyLength = static_cast<int64_t>(offset);
+    return buffers;
+}
+
+size_t ArrowWriter::writeSchema(ArrowFlatBuilder& builder) const {
+    std::vector<std::function<size_t(ArrowFlatBuilder&)>> fields;
+    for (const auto& column : columns_) {
+        fields.push_back([&column](ArrowFlatBuilder& b) {
+            uint8_t typeType = TYPE_UTF8;
+            std::function<size_t(ArrowFlatBuilder&)> typeTable;
+            switch (column.type) {
+            case Type::Int8:
+            case Type::Int32:
+            case Type::Int64:
+                typeType = TYPE_INT;
+                typeTable = [&column](ArrowFlatBuilder& t) {
+                    return t.table({ { 0, 4, static_cast<uint64_t>(column.width * 8), nullptr }, { 1, 1, 1, nullptr } });
+                };
+                break;
+            case Type::Float64:
+                typeType = TYPE_FLOATING_POINT;
+                typeTable = [](ArrowFlatBuilder& t) {
+                    return t.table({ { 0, 2, static_cast<uint64_t>(PRECISION_DOUBLE), nullptr } });
+                };
+                break;
+            case Type::Time32:
+                typeType = TYPE_TIME;
+                typeTable = [](ArrowFlatBuilder& t) {
+                    return t.table({ { 0, 2, static_cast<uint64_t>(TIME_UNIT_SECOND), nullptr }, { 1, 4, 32, nullptr } });
+                };
+                break;
+            case Type::Utf8:
+                typeType = TYPE_UTF8;
+                typeTable = [](ArrowFlatBuilder& t) { return t.table({}); };
+                break;
+            }
+
+            return b.table({
+                { 0, 4, 0, [&column](ArrowFlatBuilder& t) { return t.string(column.name); } },
+                { 1, 1, column.nullCount > 0 ? 1u : 0u, nullptr },
+                { 2, 1, typeType, nullptr },
+                { 3, 4, 0, typeTable },
+                { 5, 4, 0, [](ArrowFlatBuilder& t) { return t.tableVector({}); } },
+            });
+        });
+    }
+
+    return builder.table({
+        { 0, 2, 0, nullptr },
+        { 1, 4, 0, [fields](ArrowFlatBuilder& t) { return t.tableVector(fields); } },
+    });
+}
+
+std::vector<uint8_t> ArrowWriter::buildSchemaMessage() const {
+    ArrowFlatBuilder builder;
+    return builder.finish([this](ArrowFlatBuilder& b) {
+        return b.table({
+            { 0, 2, static_cast<uint64_t>(METADATA_V5), nullptr },
+            { 1, 1, HEADER_SCHEMA, nullptr },
+            { 2, 4, 0, [this](ArrowFlatBuilder& t) { return writeSchema(t); } },
+            { 3, 8, 0, nullptr },
+        });
+    });
+}
+
+std::vector<uint8_t> ArrowWriter::buildRecordBatchMessage(const std::vector<Buffer>& buffers, int64_t bodyLength) const {
+    std::vector<uint8_t> nodes;
+    for (const auto& column : columns_) {
+        appendBytes<int64_t>(nodes, static_cast<int64_t>(rowCount()));
+        appendBytes<int64_t>(nodes, column.nullCount);
+    }
+    std::vector<uint8_t> bufferBytes;
+    for (const auto& buffer : buffers) {
+        appendBytes<int64_t>(bufferBytes, buffer.offset);
+        appendBytes<int64_t>(bufferBytes, buffer.length);
+    }
+
+    ArrowFlatBuilder builder;
+    return builder.finish([&](ArrowFlatBuilder& b) {
+        return b.table({
+            { 0, 2, static_cast<uint64_t>(METADATA_V5), nullptr },
+            { 1, 1, HEADER_RECORD_BATCH, nullptr },
+            { 2, 4, 0, [&](ArrowFlatBuilder& t) {
+                return t.table({
+                    { 0, 8, static_cast<uint64_t>(rowCount()), nullptr },
+                    { 1, 4, 0, [&](ArrowFlatBuilder& v) { return v.structVector(nodes, columns_.size()); } },
+                    { 2, 4, 0, [&](ArrowFlatBuilder& v) { return v.structVector(bufferBytes, buffers.size()); } },
+                });
+            } },
+            { 3, 8, static_cast<uint64_t>(bodyLength), nullptr },
+        });
+    });
+}
+
+std::vector<uint8_t> ArrowWriter::buildFooter(int64_t batchOffset, int32_t batchMetaLength, int64_t bodyLength) const {
+    std::vector<uint8_t> block;
+    appendBytes<int64_t>(block, batchOffset);
+    appendBytes<int32_t>(block, batchMetaLength);
+    appendBytes<int32_t>(block, 0);
+    appendBytes<int64_t>(block, bodyLength);
+
+    ArrowFlatBuilder builder;
+    return builder.finish([&](ArrowFlatBuilder& b) {
+        return b.table({
+            { 0, 2, static_cast<uint64_t>(METADATA_V5), nullptr },
+            { 1, 4, 0, [this](ArrowFlatBuilder& t) { return writeSchema(t); } },
+            { 2, 4, 0, [](ArrowFlatBuilder& t) { return t.structVector({}, 0); } },
+            { 3, 4, 0, [&](ArrowFlatBuilder& t) { return t.structVector(block, 1); } },
+        });
+    });
+}
+
+// 文件结构：魔数、Schema 消息、RecordBatch 消息与消息体、流结束标记、Footer、Footer 长度、魔数
+void ArrowWriter::write(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    const uint32_t continuation = 0xFFFFFFFF;
+    auto writeMessage = [&](const std::vector<uint8_t>& metadata) {
+        const int32_t length = static_cast<int32_t>(metadata.size());
+        file.write(reinterpret_cast<const char*>(&continuation), 4);
+        file.write(reinterpret_cast<const char*>(&length), 4);
+        file.write(reinterpret_cast<const char*>(metadata.data()), metadata.size());
+        return static_cast<int32_t>(8 + metadata.size());
+    };
+
+    file.write("ARROW1\0\0", 8);
+    writeMessage(buildSchemaMessage());
+
+    int64_t bodyLength = 0;
+    const std::vector<Buffer> buffers = layoutBody(bodyLength);
+    const int64_t batchOffset = static_cast<int64_t>(file.tellp());
+    const int32_t batchMetaLength = writeMessage(buildRecordBatchMessage(buffers, bodyLength));
+
+    // 按布局写入消息体，定长列直接写出原始内存
+    size_t written = 0;
+    size_t index = 0;
+    auto writeBuffer = [&](const void* data, size_t length) {
+        const Buffer& buffer = buffers[index++];
+        writePadding(file, static_cast<size_t>(buffer.offset) - written);
+        file.write(static_cast<const char*>(data), length);
+        written = static_cast<size_t>(buffer.offset) + length;
+    };
+    for (const auto& column : columns_) {
+        writeBuffer(column.validity.data(), column.validity.size());
+        if (column.type == Type::Utf8) {
+            std::vector<int32_t> offsets;
+            offsets.reserve(column.length + 1);
+            int32_t offset = 0;
+            offsets.push_back(offset);
+            for (const auto& s : *column.strings) {
+                offset += static_cast<int32_t>(s.size());
+                offsets.push_back(offset);
+            }
+            std::string data;
+            data.reserve(offset);
+            for (const auto& s : *column.strings) data += s;
+            writeBuffer(offsets.data(), offsets.size() * sizeof(int32_t));
+            writeBuffer(data.data(), data.size());
+        }
+        else {
+            writeBuffer(column.data, column.length * column.width);
+        }
+    }
+    writePadding(file, static_cast<size_t>(bodyLength) - written);
+
+    const int32_t endOfStream[2] = { -1, 0 };
+    file.write(reinterpret_cast<const char*>(endOfStream), sizeof(endOfStream));
+
+    const std::vector<uint8_t> footer = buildFooter(batchOffset, batchMetaLength, bodyLength);
+    const int32_t footerLength = static_cast<int32_t>(footer.size());
+    file.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+    file.write(reinterpret_cast<const char*>(&footerLength), 4);
+    file.write("ARROW1", 6);
+
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
@@ -0,0 +1,569 @@
+#include "Common.h"
+#include "Baseline.h"
+#include "Config.h"
+#include "TextTable.h"
+#include "TickArchive.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+    const char MAGIC[4] = { 'S', 'T', 'K', 'B' };
+    const uint16_t VERSION = 1;
+    // 同一股票的多个结果窗口和收盘归档可能同时读取、补算并保存
+    std::mutex fileMutex;
+
+    void put(std::string& out, const void* data, size_t size) {
+        out.append(static_cast<const char*>(data), size);
+    }
+
+    template <typename T>
+    void putValue(std::string& out, T value) {
+        put(out, &value, sizeof(T));
+    }
+
+    template <typename T>
+    void putVector(std::string& out, const std::vector<T>& values) {
+        putValue(out, static_cast<uint32_t>(values.size()));
+        put(out, values.data(), values.size() * sizeof(T));
+    }
+
+    // 带边界检查的顺序读取，文件不完整时抛出异常
+    class Reader {
+    public:
+        Reader(const std::string& data) : p_(data.data()), end_(data.data() + data.size()) {}
+
+        void get(void* out, size_t size) {
+            if (static_cast<size_t>(end_ - p_) < size) throw std::runtime_error("truncated baseline file");
+            memcpy(out, p_, size);
+            p_ += size;
+        }
+        template <typename T>
+        T value() {
+            T v;
+            get(&v, sizeof(T));
+            return v;
+        }
+        template <typename T>
+        std::vector<T> vector() {
+            const uint32_t n = value<uint32_t>();
+            if (static_cast<size_t>(end_ - p_) / sizeof(T) < n) throw std::runtime_error("truncated baseline file");
+            std::vector<T> v(n);
+            get(v.data(), n * sizeof(T));
+            return v;
+        }
+
+    private:
+        const char* p_;
+        const char* end_;
+    };
+
+    // values 为各基线交易日的值
+    BaselineStats describe(double value, const std::vector<double>& values) {
+        BaselineStats stats;
+        stats.value = value;
+        stats.days = values.size();
+        if (values.empty()) return stats;
+        double sum = 0, sumSquares = 0, below = 0;
+        for (double v : values) {
+            sum += v;
+            sumSquares += v * v;
+            below += (v < value) ? 1.0 : (v == value) ? 0.5 : 0.0;
+        }
+        const double n = static_cast<double>(values.size());
+        stats.mean = sum / n;
+        stats.stdev = std::sqrt((std::max)(sumSquares / n - stats.mean * stats.mean, 0.0));
+        stats.percentile = below / n * 100.0;
+        return stats;
+    }
+}
+
+double DayProfile::value(int bucket, BaselineMetric metric) const {
+    const int k = bucket - firstBucket;
+    if (k < 0 || k >= static_cast<int>(volume.size())) return 0.0;
+    switch (metric) {
+    case BASELINE_VOLUME: return volume[k];
+    case BASELINE_AMOUNT: return amount[k];
+    case BASELINE_IMBALANCE: {
+        const double total = static_cast<double>(buyAmount[k]) + sellAmount[k];
+        return total > 0 ? (static_cast<double>(buyAmount[k]) - sellAmount[k]) / total : 0.0;
+    }
+    default: return 0.0;
+    }
+}
+
+double DayProfile::total(int first, int last, BaselineMetric metric) const {
+    const int from = (std::max)(first - firstBucket, 0);
+    const int to = (std::min)(last - firstBucket, static_cast<int>(volume.size()) - 1);
+    double volumeSum = 0, amountSum = 0, buySum = 0, sellSum = 0;
+    for (int k = from; k <= to; ++k) {
+        volumeSum += volume[k];
+        amountSum += amount[k];
+        buySum += buyAmount[k];
+        sellSum += sellAmount[k];
+    }
+    switch (metric) {
+    case BASELINE_VOLUME: return volumeSum;
+    case BASELINE_AMOUNT: return amountSum;
+    case BASELINE_IMBALANCE: return (buySum + sellSum > 0) ? (buySum - sellSum) / (buySum + sellSum) : 0.0;
+    default: return 0.0;
+    }
+}
+
+BaselineStore::BaselineStore(const std::string& symbol, int bucketSeconds, const std::vector<int>& windows)
+    : path_(getBaselineFile(symbol)), symbol_(symbol), bucketSeconds_((std::max)(bucketSeconds, 60)) {
+    for (int days : windows) {
+        RollingBaseline rolling;
+        if (days <= 0) {
+            throw std::runtime_error("baseline window must be positive");
+        }
+        rolling.days = days;
+        rolling_.push_back(rolling);
+    }
+    load();
+    // 窗口配置与文件不同时按保存的分段汇总重新计算滚动合计
+    for (auto& rolling : rolling_) {
+        if (rolling.sum[0].size() != static_cast<size_t>(bucketCount())) {
+            rebuild(rolling);
+        }
+    }
+}
+
+std::string BaselineStore::getBaselineFile(const std::string& symbol) {
+    const wxString dir(Config::getInstance().getProgramDir());
+    const wxString file = dir + "/archive/" + wxString::FromUTF8(toLowerCase(symbol).c_str()) + ".tkb";
+    return std::string(file.utf8_str());
+}
+
+DayProfile BaselineStore::makeProfile(int32_t date, const TickColumns& ticks, int bucketSeconds) {
+    DayProfile profile;
+    profile.date = date;
+    if (ticks.empty()) return profile;
+    const auto [lo, hi] = std::minmax_element(ticks.time.begin(), ticks.time.end());
+    profile.firstBucket = *lo / bucketSeconds;
+    const size_t count = static_cast<size_t>(*hi / bucketSeconds - profile.firstBucket + 1);
+    profile.volume.assign(count, 0.0f);
+    profile.amount.assign(count, 0.0f);
+    profile.buyAmount.assign(count, 0.0f);
+    profile.sellAmount.assign(count, 0.0f);
+    // 先用 double 累加，最后再转成 float 保存
+    std::vector<double> sums(count * 4, 0.0);
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        double* s = &sums[static_cast<size_t>(ticks.time[i] / bucketSeconds - profile.firstBucket) * 4];
+        s[0] += ticks.volume[i];
+        s[1] += ticks.amount[i];
+        s[2] += ticks.side[i] == SIDE_BUY ? ticks.amount[i] : 0.0;
+        s[3] += ticks.side[i] == SIDE_SELL ? ticks.amount[i] : 0.0;
+    }
+    for (size_t k = 0; k < count; ++k) {
+        profile.volume[k] = static_cast<float>(sums[k * 4]);
+        profile.amount[k] = static_cast<float>(sums[k * 4 + 1]);
+        profile.buyAmount[k] = static_cast<float>(sums[k * 4 + 2]);
+        profile.sellAmount[k] = static_cast<float>(sums[k * 4 + 3]);
+    }
+    return profile;
+}
+
+const DayProfile* BaselineStore::findDay(int32_t date) const {
+    auto it = std::lower_bound(days_.begin(), days_.end(), date, [](const DayProfile& d, int32_t value) { return d.date < value; });
+    return (it != days_.end() && it->date == date) ? &*it : nullptr;
+}
+
+// 最长的窗口再多保留一天，用于比较当天已经归档时向前补一天
+size_t BaselineStore::keepDays() const {
+    int longest = 0;
+    for (const auto& rolling : rolling_) {
+        longest = (std::max)(longest, rolling.days);
+    }
+    return static_cast<size_t>(longest) + 1;
+}
+
+void BaselineStore::accumulate(RollingBaseline& rolling, const DayProfile& day, double sign) const {
+    const int last = day.firstBucket + static_cast<int>(day.volume.size());
+    for (int bucket = (std::max)(day.firstBucket, 0); bucket < (std::min)(last, bucketCount()); ++bucket) {
+        for (int m = 0; m < BASELINE_METRIC_COUNT; ++m) {
+            const double v = day.value(bucket, static_cast<BaselineMetric>(m));
+            rolling.sum[m][bucket] += sign * v;
+            rolling.sumSquares[m][bucket] += sign * v * v;
+        }
+    }
+}
+
+void BaselineStore::rebuild(RollingBaseline& rolling) const {
+    for (int m = 0; m < BASELINE_METRIC_COUNT; ++m) {
+        rolling.sum[m].assign(bucketCount(), 0.0);
+        rolling.sumSquares[m].assign(bucketCount(), 0.0);
+    }
+    rolling.dates.clear();
+    const size_t from = days_.size() > static_cast<size_t>(rolling.days) ? days_.size() - rolling.days : 0;
+    for (size_t i = from; i < days_.size(); ++i) {
+        accumulate(rolling, days_[i], 1.0);
+        rolling.dates.push_back(days_[i].date);
+    }
+}
+
+// 最新的一天只加入新日、减去移出窗口的一天；补入较早的日期或替换已有日期时按分段汇总重新计算
+void BaselineStore::insertDay(DayProfile profile) {
+    const int32_t date = profile.date;
+    auto it = std::lower_bound(days_.begin(), days_.end(), date, [](const DayProfile& d, int32_t value) { return d.date < value; });
+    const bool appended = (it == days_.end());
+    const bool replaced = !appended && it->date == date;
+    if (replaced) {
+        *it = std::move(profile);
+    }
+    else {
+        days_.insert(it, std::move(profile));
+    }
+
+    for (auto& rolling : rolling_) {
+        if (!appended) {
+            rebuild(rolling);
+            continue;
+        }
+        accumulate(rolling, days_.back(), 1.0);
+        rolling.dates.push_back(date);
+        if (rolling.dates.size() > static_cast<size_t>(rolling.days)) {
+            if (const DayProfile* oldest = findDay(rolling.dates.front())) {
+                accumulate(rolling, *oldest, -1.0);
+            }
+            rolling.dates.erase(rolling.dates.begin());
+        }
+    }
+
+    if (days_.size() > keepDays()) {
+        days_.erase(days_.begin(), days_.end() - keepDays());
+    }
+}
+
+void BaselineStore::addDay(int32_t date, const TickColumns& ticks) {
+    TRACE_SCOPE("BaselineStore::addDay");
+    if (ticks.empty()) return;
+    insertDay(makeProfile(date, ticks, bucketSeconds_));
+}
+
+bool BaselineStore::syncWithArchive() {
+    const std::string archivePath = TickArchive::getArchiveFile(symbol_);
+    if (!TickArchive::exists(archivePath)) return false;
+    TRACE_SCOPE("BaselineStore::syncWithArchive");
+    TickArchive archive(archivePath);
+    // 只需要最近 keepDays() 个完整交易日，按日期升序加入走增量路径
+    std::vector<const ArchiveBlock*> complete;
+    for (const auto& block : archive.blocks()) {
+        if (block.flags & ARCHIVE_COMPLETE) complete.push_back(&block);
+    }
+    const size_t from = complete.size() > keepDays() ? complete.size() - keepDays() : 0;
+    bool changed = false;
+    for (size_t i = from; i < complete.size(); ++i) {
+        if (findDay(complete[i]->date)) continue;
+        TickColumns ticks;
+        archive.readBlock(*complete[i], ticks);
+        addDay(complete[i]->date, ticks);
+        changed = true;
+    }
+    return changed;
+}
+
+// 文件格式：魔数、版本、时间段秒数；各交易日的分段汇总；各窗口的滚动合计
+bool BaselineStore::save() const {
+    std::string out;
+    const uint16_t version = VERSION, reserved = 0;
+    put(out, MAGIC, 4);
+    putValue(out, version);
+    putValue(out, reserved);
+    putValue(out, static_cast<int32_t>(bucketSeconds_));
+    putValue(out, static_cast<uint32_t>(days_.size()));
+    for (const auto& day : days_) {
+        putValue(out, day.date);
+        putValue(out, static_cast<int32_t>(day.firstBucket));
+        putVector(out, day.volume);
+        putVector(out, day.amount);
+        putVector(out, day.buyAmount);
+        putVector(out, day.sellAmount);
+    }
+    putValue(out, static_cast<uint32_t>(rolling_.size()));
+    for (const auto& rolling : rolling_) {
+        putValue(out, static_cast<int32_t>(rolling.days));
+        putVector(out, rolling.dates);
+        for (int m = 0; m < BASELINE_METRIC_COUNT; ++m) {
+            putVector(out, rolling.sum[m]);
+            putVector(out, rolling.sumSquares[m]);
+        }
+    }
+
+    try {
+        const std::filesystem::path target = std::filesystem::u8path(path_);
+        std::filesystem::path temp = target;
+        temp += ".tmp";
+        if (target.has_parent_path()) {
+            std::filesystem::create_directories(target.parent_path());
+        }
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+            file.write(out.data(), out.size());
+            file.close();
+            if (!file) return false;
+        }
+        std::filesystem::rename(temp, target);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+// 文件损坏或时间段长度不同时丢弃，之后从归档重新补算
+void BaselineStore::load() {
+    std::ifstream file(std::filesystem::u8path(path_), std::ios::binary);
+    if (!file.is_open()) return;
+    const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    try {
+        Reader in(data);
+        char magic[4];
+        in.get(magic, 4);
+        if (memcmp(magic, MAGIC, 4) != 0 || in.value<uint16_t>() != VERSION) return;
+        in.value<uint16_t>();
+        if (in.value<int32_t>() != bucketSeconds_) return;
+
+        std::vector<DayProfile> days(in.value<uint32_t>());
+        for (auto& day : days) {
+            day.date = in.value<int32_t>();
+            day.firstBucket = in.value<int32_t>();
+            day.volume = in.vector<float>();
+            day.amount = in.vector<float>();
+            day.buyAmount = in.vector<float>();
+            day.sellAmount = in.vector<float>();
+            const size_t n = day.volume.size();
+            if (day.amount.size() != n || day.buyAmount.size() != n || day.sellAmount.size() != n) return;
+        }
+        std::vector<RollingBaseline> saved(in.value<uint32_t>());
+        for (auto& rolling : saved) {
+            rolling.days = in.value<int32_t>();
+            rolling.dates = in.vector<int32_t>();
+            for (int m = 0; m < BASELINE_METRIC_COUNT; ++m) {
+                rolling.sum[m] = in.vector<double>();
+                rolling.sumSquares[m] = in.vector<double>();
+            }
+        }
+        days_ = std::move(days);
+        // 只沿用窗口长度相同的滚动合计
+        for (auto& rolling : rolling_) {
+            for (const auto& old : saved) {
+                if (old.days == rolling.days && old.sum[0].size() == static_cast<size_t>(bucketCount())) {
+                    rolling = old;
+                }
+            }
+        }
+    }
+    catch (const std::exception&) {
+        days_.clear();
+    }
+}
+
+std::unique_lock<std::mutex> BaselineStore::lockFiles() {
+    return std::unique_lock<std::mutex>(fileMutex);
+}
+
+void BaselineStore::onDayArchived(const std::string& symbol, int32_t date, const TickColumns& ticks) {
+    const Config& config = Config::getInstance();
+    auto lock = lockFiles();
+    BaselineStore store(symbol, config.getBaselineBucketSeconds(), config.getBaselineDays());
+    store.addDay(date, ticks);
+    store.save();
+}
+
+BaselineComparison Baseline::compare(const std::string& stockCode, const TickColumns& ticks, int stimesec, int etimesec) {
+    TRACE_SCOPE("Baseline::compare");
+    if (ticks.empty()) {
+        throw std::string(_("No data available for analysis"));
+    }
+    const Config& config = Config::getInstance();
+    auto lock = BaselineStore::lockFiles();
+    BaselineStore store(StockData::getStockSymbol(stockCode), config.getBaselineBucketSeconds(), config.getBaselineDays());
+    if (store.syncWithArchive()) {
+        store.save();
+    }
+    lock.unlock();
+
+    BaselineComparison result;
+    result.stockCode = stockCode;
+    result.date = TickArchive::currentTradingDate();
+    result.bucketSeconds = store.bucketSeconds();
+    // 只比较基本完整覆盖的时间段，否则当天不完整的首尾时间段会和基线中完整的时间段相比；
+    // 留出十分之一的余量，查询到 10:29:57 时仍包括 10:25 开始的时间段
+    const int bs = result.bucketSeconds;
+    const int slack = bs / 10;
+    result.firstBucket = ((stimesec >= 0 ? stimesec : ticks.time.front()) + bs - slack) / bs;
+    result.lastBucket = ((etimesec >= 0 ? etimesec : ticks.time.back()) + slack) / bs - 1;
+    if (result.lastBucket < result.firstBucket) {
+        throw std::string(wxString::Format(_("The time range is shorter than one %d-minute baseline bucket"), bs / 60));
+    }
+    const DayProfile today = BaselineStore::makeProfile(result.date, ticks, result.bucketSeconds);
+
+    // 每个窗口的基线交易日：分析日之前最近的 N 个
+    std::vector<const DayProfile*> previous;
+    for (const auto& day : store.days()) {
+        if (day.date < result.date) previous.push_back(&day);
+    }
+    if (previous.empty()) {
+        throw std::string(_("No archived trading days to compare with yet"));
+    }
+
+    for (const auto& rolling : store.rolling()) {
+        result.windows.push_back(rolling.days);
+        const size_t n = (std::min)(previous.size(), static_cast<size_t>(rolling.days));
+        BaselineRow row;
+        for (int m = 0; m < BASELINE_METRIC_COUNT; ++m) {
+            const BaselineMetric metric = static_cast<BaselineMetric>(m);
+            std::vector<double> values;
+            for (size_t i = previous.size() - n; i < previous.size(); ++i) {
+                values.push_back(previous[i]->total(result.firstBucket, result.lastBucket, metric));
+            }
+            row[m] = describe(today.total(result.firstBucket, result.lastBucket, metric), values);
+        }
+        result.span.push_back(row);
+    }
+
+    // 各时间段与第一个窗口比较：均值和标准差来自滚动合计，分析日已经计入时减去它再补上更早的一天
+    const RollingBaseline& rolling = store.rolling().front();
+    const size_t n = (std::min)(previous.size(), static_cast<size_t>(rolling.days));
+    std::vector<int32_t> wanted;
+    for (size_t i = previous.size() - n; i < previous.size(); ++i) {
+        wanted.push_back(previous[i]->date);
+    }
+    const DayProfile* remove = nullptr;
+    const DayProfile* add = nullptr;
+    bool useRolling = (rolling.dates == wanted);
+    if (!useRolling && !rolling.dates.empty() && rolling.dates.back() == result.date) {
+        std::vector<int32_t> adjusted(rolling.dates.begin(), rolling.dates.end() - 1);
+        const bool extend = adjusted.size() < wanted.size();
+        if (extend) {
+            adjusted.insert(adjusted.begin(), wanted.front());
+            add = store.findDay(wanted.front());
+        }
+        remove = store.findDay(result.date);
+        useRolling = (adjusted == wanted) && remove && (add || !extend);
+    }
+
+    for (int bucket = result.firstBucket; bucket <= result.lastBucket; ++bucket) {
+        BaselineRow row;
+        for (int m = 0; m < BASELINE_METRIC_COUNT; ++m) {
+            const BaselineMetric metric = static_cast<BaselineMetric>(m);
+            std::vector<double> values;
+            for (size_t i = previous.size() - n; i < previous.size(); ++i) {
+                values.push_back(previous[i]->value(bucket, metric));
+            }
+            BaselineStats stats = describe(today.value(bucket, metric), values);
+            if (useRolling && bucket >= 0 && bucket < store.bucketCount()) {
+                double sum = rolling.sum[m][bucket], sumSquares = rolling.sumSquares[m][bucket];
+                if (remove) {
+                    const double v = remove->value(bucket, metric);
+                    sum -= v;
+                    sumSquares -= v * v;
+                }
+                if (add) {
+                    const double v = add->value(bucket, metric);
+                    sum += v;
+                    sumSquares += v * v;
+                }
+                stats.mean = sum / n;
+                stats.stdev = std::sqrt((std::max)(sumSquares / n - stats.mean * stats.mean, 0.0));
+            }
+            row[m] = stats;
+        }
+        result.buckets.push_back(row);
+    }
+    return result;
+}
+
+wxString Baseline::format(const BaselineComparison& comparison) {
+    TextTable table;
+    table.reserve(comparison.buckets.size() + comparison.span.size() * BASELINE_METRIC_COUNT + 8, 10 * (comparison.buckets.size() + 12));
+    auto utf8 = [](const wxString& text) { return std::string(text.utf8_str()); };
+
+    // 人类友好
+    const int language = Config::getInstance().getLanguage();
+    const wxLanguageInfo* languageInfo = wxLocale::GetLanguageInfo(language);
+    wxString localeName = languageInfo->GetLocaleName();
+    const std::string symbol = utf8(localeName.StartsWith("zh") ? _("E4") : _("kilo"));
+    int human = localeName.StartsWith("zh") ? 10000 : 1000;
+
+    const int bs = comparison.bucketSeconds;
+    const std::string metricNames[BASELINE_METRIC_COUNT] = { utf8(_("Volume")), utf8(_("Amounts")), utf8(_("Imbalance")) };
+    // 成交量、金额按万（千）显示，失衡按百分比显示
+    auto addValue = [&](double value, int metric) {
+        if (metric == BASELINE_IMBALANCE) {
+            table.addNumber(value * 100, 0, "%");
+        }
+        else {
+            table.addNumber(value / human, 2, symbol);
+        }
+    };
+    auto addPercentile = [&](const BaselineStats& stats) {
+        if (std::isnan(stats.percentile)) {
+            table.addText("-");
+        }
+        else {
+            table.addNumber(stats.percentile, 0, "%");
+        }
+    };
+
+    table.addLine(utf8(wxString::Format(_("%s %s-%s compared with the previous trading days, %d-minute buckets"),
+        wxString::FromUTF8(comparison.stockCode.c_str()),
+        wxString::FromUTF8(StockData::secondsToTimeString(comparison.firstBucket * bs).c_str()),
+        wxString::FromUTF8(StockData::secondsToTimeString((comparison.lastBucket + 1) * bs - 1).c_str()), bs / 60)));
+    table.addLine("");
+
+    // 整个时间范围
+    const std::string spanHeaders[] = { utf8(_("Baseline")), utf8(_("Item")), utf8(_("Today")), utf8(_("Mean")), utf8(_("Stdev")), "Z", utf8(_("Percentile")) };
+    table.beginRow();
+    for (const auto& header : spanHeaders) {
+        table.addText(header);
+    }
+    for (size_t w = 0; w < comparison.span.size(); ++w) {
+        const BaselineRow& row = comparison.span[w];
+        const wxString label = wxString::Format(_("%d days (%d)"), comparison.windows[w], static_cast<int>(row[0].days));
+        for (int m = 0; m < BASELINE_METRIC_COUNT; ++m) {
+            table.beginRow();
+            table.addText(m == 0 ? utf8(label) : "");
+            table.addText(metricNames[m]);
+            addValue(row[m].value, m);
+            addValue(row[m].mean, m);
+            addValue(row[m].stdev, m);
+            table.addNumber(row[m].zScore(), 1);
+            addPercentile(row[m]);
+        }
+    }
+
+    // 各时间段与第一个窗口比较
+    if (!comparison.buckets.empty() && !comparison.windows.empty()) {
+        table.addLine("");
+        table.addLine(utf8(wxString::Format(_("By time bucket, compared with %d days"), comparison.windows.front())) + " ");
+        const std::string bucketHeaders[] = { utf8(_("Time")), metricNames[BASELINE_VOLUME], "Z", utf8(_("Pct")),
+            metricNames[BASELINE_AMOUNT], "Z", utf8(_("Pct")), metricNames[BASELINE_IMBALANCE], utf8(_("Mean")), utf8(_("Pct")) };
+        table.beginRow();
+        for (const auto& header : bucketHeaders) {
+            table.addText(header);
+        }
+        for (size_t k = 0; k < comparison.buckets.size(); ++k) {
+            const BaselineRow& row = comparison.buckets[k];
+            table.beginRow();
+            table.addText(StockData::secondsToTimeString((comparison.firstBucket + static_cast<int>(k)) * bs));
+            for (int m = BASELINE_VOLUME; m <= BASELINE_AMOUNT; ++m) {
+                addValue(row[m].value, m);
+                table.addNumber(row[m].zScore(), 1);
+                addPercentile(row[m]);
+            }
+            addValue(row[BASELINE_IMBALANCE].value, BASELINE_IMBALANCE);
+            addValue(row[BASELINE_IMBALANCE].mean, BASELINE_IMBALANCE);
+            addPercentile(row[BASELINE_IMBALANCE]);
+        }
+    }
+    const std::string text = table.render();
+    return wxString::FromUTF8(text.data(), text.size());
+}
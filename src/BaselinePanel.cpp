@@ -0,0 +1,40 @@
+#include "BaselinePanel.h"
+#include "Trace.h"
+#include <stdexcept>
+#include <thread>
+
+BaselinePanel::BaselinePanel(wxWindow* parent, const std::string& stockCode, std::shared_ptr<const TickColumns> ticks, int stimesec, int etimesec)
+    : wxPanel(parent), state_(std::make_shared<BaselineState>()) {
+    wxFont monoFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    text_ = new wxTextCtrl(this, wxID_ANY, _("Loading baseline..."), wxDefaultPosition, wxSize(640, 400), wxTE_MULTILINE | wxTE_READONLY | wxHSCROLL);
+    text_->SetFont(monoFont);
+    auto* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(text_, 1, wxEXPAND | wxALL, 5);
+    SetSizer(sizer);
+
+    // 第一次比较时可能要从归档补算多个交易日，放到后台进行
+    std::shared_ptr<BaselineState> state = state_;
+    std::thread([this, state, stockCode, ticks, stimesec, etimesec]() {
+        if (Trace::enabled()) {
+            Trace::setThreadName("Baseline");
+        }
+        wxString text;
+        try {
+            text = Baseline::format(Baseline::compare(stockCode, *ticks, stimesec, etimesec));
+        }
+        catch (const std::string& message) {
+            text = message;
+        }
+        catch (const std::exception& e) {
+            text = wxString::FromUTF8(e.what());
+        }
+        wxTheApp->CallAfter([this, state, text]() {
+            if (!state->alive) return;
+            text_->SetValue(text);
+        });
+    }).detach();
+}
+
+BaselinePanel::~BaselinePanel() {
+    state_->alive = false;
+}
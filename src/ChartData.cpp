@@ -0,0 +1,212 @@
+#include "ChartData.h"
+#include "TickView.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // 按开始时间查找桶
+    struct ByStartTime {
+        bool operator()(const ChartBucket& bucket, int32_t time) const { return bucket.endTime < time; }
+        bool operator()(int32_t time, const ChartBucket& bucket) const { return time < bucket.startTime; }
+    };
+
+    ChartBucket merge(const ChartBucket* begin, const ChartBucket* end) {
+        ChartBucket bucket = *begin;
+        for (const ChartBucket* b = begin + 1; b < end; ++b) {
+            bucket.endTime = b->endTime;
+            bucket.close = b->close;
+            bucket.low = (std::min)(bucket.low, b->low);
+            bucket.high = (std::max)(bucket.high, b->high);
+            bucket.buyMax = (std::max)(bucket.buyMax, b->buyMax);
+            bucket.sellMax = (std::max)(bucket.sellMax, b->sellMax);
+            bucket.vwap = b->vwap;
+        }
+        return bucket;
+    }
+}
+
+ChartPyramid::ChartPyramid(std::shared_ptr<const TickColumns> ticks)
+    : ticks_(std::move(ticks)) {
+    TRACE_SCOPE("ChartPyramid");
+    // 按时间二分查找，导入的文件不一定按时间排列
+    if (!std::is_sorted(ticks_->time.begin(), ticks_->time.end())) {
+        TickView view(ticks_);
+        view.sort(FIELD_TIME, true);
+        auto sorted = std::make_shared<TickColumns>();
+        sorted->reserve(view.size());
+        const TickColumns& t = *ticks_;
+        for (size_t i = 0; i < view.size(); ++i) {
+            const uint32_t r = view.row(i);
+            sorted->push(t.index[r], t.time[r], t.price[r], t.change[r], t.volume[r], t.amount[r], t.side[r]);
+        }
+        ticks_ = sorted;
+    }
+    const TickColumns& t = *ticks_;
+    const size_t n = t.size();
+
+    // 累计成交均价 = 成交额 / 股数，股数由成交额 / 价格得出，不依赖每手股数（港股、美股没有默认值）
+    vwap_.resize(n);
+    double amount = 0, shares = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (t.price[i] > 0) {
+            amount += t.amount[i];
+            shares += t.amount[i] / t.price[i];
+        }
+        vwap_[i] = shares > 0 ? static_cast<float>(amount / shares) : static_cast<float>(t.price[i]);
+    }
+
+    // 第 1 层直接由逐笔数据生成，之后逐层合并，直到只剩少量的桶
+    std::vector<ChartBucket> level;
+    level.reserve(n / FAN_OUT + 1);
+    ChartBucket group[FAN_OUT];
+    for (size_t i = 0; i < n; i += FAN_OUT) {
+        const size_t end = (std::min)(i + FAN_OUT, n);
+        for (size_t k = i; k < end; ++k) {
+            group[k - i] = tickBucket(k);
+        }
+        level.push_back(merge(group, group + (end - i)));
+    }
+    while (!level.empty()) {
+        levels_.push_back(std::move(level));
+        const std::vector<ChartBucket>& source = levels_.back();
+        if (source.size() <= FAN_OUT) break;
+        level.clear();
+        level.reserve(source.size() / FAN_OUT + 1);
+        for (size_t i = 0; i < source.size(); i += FAN_OUT) {
+            const size_t end = (std::min)(i + FAN_OUT, source.size());
+            level.push_back(merge(source.data() + i, source.data() + end));
+        }
+    }
+}
+
+ChartBucket ChartPyramid::tickBucket(size_t i) const {
+    const TickColumns& t = *ticks_;
+    const float price = static_cast<float>(t.price[i]);
+    const float volume = static_cast<float>(t.volume[i]);
+    return ChartBucket{ t.time[i], t.time[i], price, price, price, price,
+        t.side[i] == SIDE_BUY ? volume : 0.0f, t.side[i] == SIDE_SELL ? volume : 0.0f, vwap_[i] };
+}
+
+void ChartPyramid::collect(int level, int32_t t0, int32_t t1, std::vector<ChartBucket>& out) const {
+    out.clear();
+    if (level > 0) {
+        const std::vector<ChartBucket>& buckets = levels_[level - 1];
+        auto first = std::lower_bound(buckets.begin(), buckets.end(), t0, ByStartTime());
+        auto last = std::upper_bound(first, buckets.end(), t1, ByStartTime());
+        out.assign(first, last);
+        return;
+    }
+
+    const TickColumns& t = *ticks_;
+    const size_t first = std::lower_bound(t.time.begin(), t.time.end(), t0) - t.time.begin();
+    const size_t last = std::upper_bound(t.time.begin(), t.time.end(), t1) - t.time.begin();
+    out.reserve(last - first);
+    for (size_t i = first; i < last; ++i) {
+        out.push_back(tickBucket(i));
+    }
+}
+
+size_t ChartPyramid::countInRange(int level, int32_t t0, int32_t t1) const {
+    if (level == 0) {
+        const std::vector<int32_t>& time = ticks_->time;
+        return std::upper_bound(time.begin(), time.end(), t1) - std::lower_bound(time.begin(), time.end(), t0);
+    }
+    const std::vector<ChartBucket>& buckets = levels_[level - 1];
+    auto first = std::lower_bound(buckets.begin(), buckets.end(), t0, ByStartTime());
+    return std::upper_bound(first, buckets.end(), t1, ByStartTime()) - first;
+}
+
+ChartFrame ChartPyramid::frame(int32_t t0, int32_t t1, int width) const {
+    ChartFrame frame;
+    if (empty() || width <= 0 || t1 < t0) return frame;
+
+    // 选择可见桶数不超过宽度 4 倍的最精细一层
+    const size_t budget = static_cast<size_t>(width) * 4;
+    int level = 0;
+    while (level < static_cast<int>(levels_.size()) && countInRange(level, t0, t1) > budget) {
+        level++;
+    }
+    frame.level = level;
+
+    std::vector<ChartBucket> buckets;
+    collect(level, t0, t1, buckets);
+    if (buckets.empty()) return frame;
+
+    // 价格范围用桶的最高最低价，缩小到任何层都不会丢失极值
+    frame.priceMin = std::numeric_limits<float>::max();
+    frame.priceMax = std::numeric_limits<float>::lowest();
+    frame.buyVolume.assign(width, 0.0f);
+    frame.sellVolume.assign(width, 0.0f);
+    const double span = static_cast<double>(t1) - t0 + 1;
+    std::vector<ChartFrame::Point> closes;
+    closes.reserve(buckets.size());
+    for (const ChartBucket& bucket : buckets) {
+        frame.priceMin = (std::min)({ frame.priceMin, bucket.low, bucket.vwap });
+        frame.priceMax = (std::max)({ frame.priceMax, bucket.high, bucket.vwap });
+        const int x = (std::min)(static_cast<int>((bucket.startTime - t0) / span * width), width - 1);
+        const int px = (std::max)(x, 0);
+        frame.buyVolume[px] = (std::max)(frame.buyVolume[px], bucket.buyMax);
+        frame.sellVolume[px] = (std::max)(frame.sellVolume[px], bucket.sellMax);
+        frame.volumeMax = (std::max)({ frame.volumeMax, bucket.buyMax, bucket.sellMax });
+        closes.push_back(ChartFrame::Point{ bucket.startTime, bucket.close });
+    }
+
+    frame.price = lttb(closes, static_cast<size_t>(width) * 2);
+    // 均价线变化平缓，按价格线的采样时间取值
+    frame.vwap.reserve(frame.price.size());
+    size_t j = 0;
+    for (const auto& point : frame.price) {
+        while (j + 1 < buckets.size() && buckets[j].startTime < point.time) j++;
+        frame.vwap.push_back(ChartFrame::Point{ point.time, buckets[j].vwap });
+    }
+    return frame;
+}
+
+std::vector<ChartFrame::Point> ChartPyramid::lttb(const std::vector<ChartFrame::Point>& points, size_t threshold) {
+    const size_t n = points.size();
+    if (threshold >= n || threshold < 3) {
+        return points;
+    }
+
+    std::vector<ChartFrame::Point> sampled;
+    sampled.reserve(threshold);
+    sampled.push_back(points.front());
+
+    // 首尾两点固定，中间的点分成 threshold - 2 个桶，每桶选出与前一个选中点、下一桶均值构成最大三角形的点
+    const double every = static_cast<double>(n - 2) / (threshold - 2);
+    size_t a = 0;
+    for (size_t i = 0; i < threshold - 2; ++i) {
+        const size_t bucketStart = static_cast<size_t>(std::floor(i * every)) + 1;
+        const size_t bucketEnd = (std::min)(static_cast<size_t>(std::floor((i + 1) * every)) + 1, n - 1);
+
+        const size_t nextStart = bucketEnd;
+        const size_t nextEnd = (std::min)(static_cast<size_t>(std::floor((i + 2) * every)) + 1, n);
+        double avgX = 0, avgY = 0;
+        for (size_t k = nextStart; k < nextEnd; ++k) {
+            avgX += points[k].time;
+            avgY += points[k].value;
+        }
+        const size_t nextCount = (std::max)(nextEnd - nextStart, static_cast<size_t>(1));
+        avgX /= nextCount;
+        avgY /= nextCount;
+
+        const double ax = points[a].time;
+        const double ay = points[a].value;
+        double maxArea = -1;
+        size_t chosen = bucketStart;
+        for (size_t k = bucketStart; k < bucketEnd; ++k) {
+            const double area = std::fabs((ax - avgX) * (points[k].value - ay) - (ax - points[k].time) * (avgY - ay));
+            if (area > maxArea) {
+                maxArea = area;
+                chosen = k;
+            }
+        }
+        sampled.push_back(points[chosen]);
+        a = chosen;
+    }
+
+    sampled.push_back(points.back());
+    return sampled;
+}
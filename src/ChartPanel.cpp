@@ -0,0 +1,257 @@
+#include "ChartPanel.h"
+#include "Trace.h"
+#include <wx/dcbuffer.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+    // 价格区占 70%，下面是成交量区，买盘向上、卖盘向下
+    const double PRICE_AREA = 0.7;
+    const int MIN_SPAN_SECONDS = 30;
+
+    struct Color {
+        unsigned char r, g, b;
+    };
+    const Color BACKGROUND = { 255, 255, 255 };
+    const Color GRID = { 230, 230, 230 };
+    const Color PRICE = { 30, 60, 160 };
+    const Color VWAP = { 230, 140, 0 };
+    const Color BUY = { 220, 50, 50 };
+    const Color SELL = { 30, 160, 60 };
+    const Color SPIKE = { 255, 240, 205 };
+
+    // 直接写 wxImage 的像素，不依赖 GDI，可以在后台线程运行
+    class Canvas {
+    public:
+        Canvas(int width, int height) : image_(width, height), width_(width), height_(height) {
+            data_ = image_.GetData();
+            fillRect(0, 0, width, height, BACKGROUND);
+        }
+        wxImage& image() { return image_; }
+
+        void setPixel(int x, int y, Color c) {
+            if (x < 0 || y < 0 || x >= width_ || y >= height_) return;
+            unsigned char* p = data_ + (static_cast<size_t>(y) * width_ + x) * 3;
+            p[0] = c.r;
+            p[1] = c.g;
+            p[2] = c.b;
+        }
+        void fillRect(int x, int y, int w, int h, Color c) {
+            for (int j = (std::max)(y, 0); j < (std::min)(y + h, height_); ++j) {
+                for (int i = (std::max)(x, 0); i < (std::min)(x + w, width_); ++i) {
+                    setPixel(i, j, c);
+                }
+            }
+        }
+        // Bresenham 直线
+        void line(int x0, int y0, int x1, int y1, Color c) {
+            const int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+            const int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+            int err = dx + dy;
+            for (;;) {
+                setPixel(x0, y0, c);
+                if (x0 == x1 && y0 == y1) break;
+                const int e2 = 2 * err;
+                if (e2 >= dy) { err += dy; x0 += sx; }
+                if (e2 <= dx) { err += dx; y0 += sy; }
+            }
+        }
+
+    private:
+        wxImage image_;
+        unsigned char* data_;
+        int width_;
+        int height_;
+    };
+}
+
+ChartPanel::ChartPanel(wxWindow* parent, std::shared_ptr<const TickColumns> ticks, std::vector<FlowSpike> spikes)
+    : wxPanel(parent, wxID_ANY, wxDefaultPosition, wxSize(640, 400)),
+      pyramid_(std::make_shared<ChartPyramid>(std::move(ticks))),
+      spikes_(std::make_shared<const std::vector<FlowSpike>>(std::move(spikes))),
+      state_(std::make_shared<RenderState>()) {
+    SetBackgroundStyle(wxBG_STYLE_PAINT);
+    if (!pyramid_->empty()) {
+        t0_ = pyramid_->startTime();
+        t1_ = pyramid_->endTime();
+    }
+
+    Bind(wxEVT_PAINT, &ChartPanel::OnPaint, this);
+    Bind(wxEVT_SIZE, &ChartPanel::OnSize, this);
+    Bind(wxEVT_MOUSEWHEEL, &ChartPanel::OnMouseWheel, this);
+    Bind(wxEVT_LEFT_DOWN, &ChartPanel::OnMouseDown, this);
+    Bind(wxEVT_MOTION, &ChartPanel::OnMouseMove, this);
+    Bind(wxEVT_LEFT_UP, &ChartPanel::OnMouseUp, this);
+    Bind(wxEVT_MOUSE_CAPTURE_LOST, &ChartPanel::OnCaptureLost, this);
+    Bind(wxEVT_LEFT_DCLICK, &ChartPanel::OnDoubleClick, this);
+}
+
+ChartPanel::~ChartPanel() {
+    state_->alive = false;
+}
+
+wxImage ChartPanel::Render(const ChartPyramid& pyramid, int32_t t0, int32_t t1, int width, int height, float* priceMin, float* priceMax,
+    const std::vector<FlowSpike>* spikes) {
+    TRACE_SCOPE("ChartPanel::Render");
+    Canvas canvas(width, height);
+    const ChartFrame frame = pyramid.frame(t0, t1, width);
+    if (priceMin) *priceMin = frame.priceMin;
+    if (priceMax) *priceMax = frame.priceMax;
+    if (frame.price.empty()) return canvas.image();
+
+    const int priceHeight = static_cast<int>(height * PRICE_AREA);
+    const int volumeTop = priceHeight + 1;
+    const int volumeMid = volumeTop + (height - volumeTop) / 2;
+    const int volumeHalf = (std::max)((height - volumeTop) / 2 - 1, 1);
+    const double span = static_cast<double>(t1) - t0 + 1;
+    auto toX = [&](int32_t time) { return static_cast<int>((time - t0) / span * width); };
+
+    // 异常时间段的底色，至少一个像素宽
+    if (spikes) {
+        for (const auto& spike : *spikes) {
+            if (spike.end < t0 || spike.start > t1) continue;
+            const int x0 = toX(spike.start);
+            canvas.fillRect(x0, 0, (std::max)(toX(spike.end) - x0, 1), height, SPIKE);
+        }
+    }
+
+    // 网格
+    for (int k = 1; k < 4; ++k) {
+        canvas.fillRect(0, priceHeight * k / 4, width, 1, GRID);
+    }
+    canvas.fillRect(0, priceHeight, width, 1, GRID);
+    canvas.fillRect(0, volumeMid, width, 1, GRID);
+
+    // 每个像素列的最大单笔买卖量
+    if (frame.volumeMax > 0) {
+        for (int x = 0; x < width; ++x) {
+            const int buy = static_cast<int>(frame.buyVolume[x] / frame.volumeMax * volumeHalf);
+            const int sell = static_cast<int>(frame.sellVolume[x] / frame.volumeMax * volumeHalf);
+            canvas.fillRect(x, volumeMid - buy, 1, buy, BUY);
+            canvas.fillRect(x, volumeMid + 1, 1, sell, SELL);
+        }
+    }
+
+    const float priceRange = (frame.priceMax > frame.priceMin) ? frame.priceMax - frame.priceMin : 1.0f;
+    auto toY = [&](float value) { return static_cast<int>((frame.priceMax - value) / priceRange * (priceHeight - 2)) + 1; };
+    auto polyline = [&](const std::vector<ChartFrame::Point>& points, Color color) {
+        for (size_t i = 1; i < points.size(); ++i) {
+            canvas.line(toX(points[i - 1].time), toY(points[i - 1].value), toX(points[i].time), toY(points[i].value), color);
+        }
+    };
+    polyline(frame.vwap, VWAP);
+    polyline(frame.price, PRICE);
+    return canvas.image();
+}
+
+// 同一时刻只有一个后台绘制，期间的请求合并为绘制结束后的一次
+void ChartPanel::RequestRender() {
+    const wxSize size = GetClientSize();
+    if (pyramid_->empty() || size.x <= 0 || size.y <= 0) return;
+    if (rendering_) {
+        pending_ = true;
+        return;
+    }
+    rendering_ = true;
+    pending_ = false;
+
+    const int32_t t0 = static_cast<int32_t>(std::floor(t0_));
+    const int32_t t1 = static_cast<int32_t>(std::ceil(t1_));
+    std::shared_ptr<const ChartPyramid> pyramid = pyramid_;
+    std::shared_ptr<const std::vector<FlowSpike>> spikes = spikes_;
+    std::shared_ptr<RenderState> state = state_;
+    std::thread([this, pyramid, spikes, state, t0, t1, size]() {
+        float priceMin = 0, priceMax = 0;
+        wxImage image = Render(*pyramid, t0, t1, size.x, size.y, &priceMin, &priceMax, spikes.get());
+        wxTheApp->CallAfter([this, state, image, t0, t1, priceMin, priceMax]() {
+            if (!state->alive) return;
+            bitmap_ = wxBitmap(image);
+            bitmapT0_ = t0;
+            bitmapT1_ = t1;
+            priceMin_ = priceMin;
+            priceMax_ = priceMax;
+            rendering_ = false;
+            Refresh(false);
+            if (pending_) {
+                RequestRender();
+            }
+        });
+    }).detach();
+}
+
+void ChartPanel::OnPaint(wxPaintEvent& event) {
+    wxAutoBufferedPaintDC dc(this);
+    dc.SetBackground(*wxWHITE_BRUSH);
+    dc.Clear();
+    if (!bitmap_.IsOk()) return;
+    dc.DrawBitmap(bitmap_, 0, 0);
+
+    // 坐标标注在界面线程绘制，文字很少
+    const wxSize size = GetClientSize();
+    dc.SetTextForeground(wxColour(90, 90, 90));
+    dc.DrawText(wxString::Format("%.2f", priceMax_), 4, 2);
+    const wxString low = wxString::Format("%.2f", priceMin_);
+    dc.DrawText(low, 4, static_cast<int>(size.y * PRICE_AREA) - dc.GetTextExtent(low).y - 2);
+    const wxString start = StockData::secondsToTimeString(bitmapT0_);
+    const wxString end = StockData::secondsToTimeString(bitmapT1_);
+    dc.DrawText(start, 4, size.y - dc.GetTextExtent(start).y - 2);
+    dc.DrawText(end, size.x - dc.GetTextExtent(end).x - 4, size.y - dc.GetTextExtent(end).y - 2);
+}
+
+void ChartPanel::OnSize(wxSizeEvent& event) {
+    RequestRender();
+    event.Skip();
+}
+
+void ChartPanel::SetRange(double t0, double t1) {
+    if (pyramid_->empty()) return;
+    const double first = pyramid_->startTime();
+    const double last = pyramid_->endTime();
+    const double span = (std::min)((std::max)(t1 - t0, static_cast<double>(MIN_SPAN_SECONDS)), last - first);
+    t0_ = (std::max)(first, (std::min)(t0, last - span));
+    t1_ = t0_ + span;
+    RequestRender();
+}
+
+// 滚轮以鼠标位置为中心缩放
+void ChartPanel::OnMouseWheel(wxMouseEvent& event) {
+    const int width = (std::max)(GetClientSize().x, 1);
+    const double anchor = t0_ + (t1_ - t0_) * event.GetX() / width;
+    const double factor = event.GetWheelRotation() > 0 ? 0.8 : 1.25;
+    SetRange(anchor - (anchor - t0_) * factor, anchor + (t1_ - anchor) * factor);
+}
+
+void ChartPanel::OnMouseDown(wxMouseEvent& event) {
+    dragging_ = true;
+    dragX_ = event.GetX();
+    dragT0_ = t0_;
+    CaptureMouse();
+}
+
+// 拖动平移
+void ChartPanel::OnMouseMove(wxMouseEvent& event) {
+    if (!dragging_) return;
+    const int width = (std::max)(GetClientSize().x, 1);
+    const double span = t1_ - t0_;
+    const double t0 = dragT0_ - (event.GetX() - dragX_) * span / width;
+    SetRange(t0, t0 + span);
+}
+
+void ChartPanel::OnMouseUp(wxMouseEvent& event) {
+    if (!dragging_) return;
+    dragging_ = false;
+    if (HasCapture()) ReleaseMouse();
+}
+
+// 拖动中失去鼠标捕获（切换窗口、弹出对话框等）时结束拖动，wx 要求处理该事件
+void ChartPanel::OnCaptureLost(wxMouseCaptureLostEvent& event) {
+    dragging_ = false;
+}
+
+// 双击恢复全天
+void ChartPanel::OnDoubleClick(wxMouseEvent& event) {
+    if (pyramid_->empty()) return;
+    SetRange(pyramid_->startTime(), pyramid_->endTime());
+}
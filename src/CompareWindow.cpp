@@ -0,0 +1,30 @@
+#include "CompareWindow.h"
+#include "Metrics.h"
+
+CompareWindow::CompareWindow(wxWindow* parent, const std::vector<ComparisonEntry>& entries, int64_t elapsedUs)
+    : wxDialog(parent, wxID_ANY, _("Compare Stocks"), wxDefaultPosition, wxDefaultSize, wxDEFAULT_FRAME_STYLE) {
+    wxIcon appIcon("IDI_APP_ICON", wxBITMAP_TYPE_ICO_RESOURCE);
+    SetIcon(appIcon);
+
+    wxPanel* panel = new wxPanel(this);
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    panel->SetSizer(sizer);
+
+    // 各股票的取数耗时，总耗时接近其中最慢的一只
+    int64_t slowestUs = 0;
+    for (const auto& entry : entries) {
+        slowestUs = (std::max)(slowestUs, entry.metrics.fetchUs);
+        Metrics::getInstance().record(entry.metrics);
+    }
+    wxStaticText* status = new wxStaticText(panel, wxID_ANY, wxString::Format(_("%d stocks in %s (slowest %s)"),
+        static_cast<int>(entries.size()), formatDuration(elapsedUs), formatDuration(slowestUs)));
+    sizer->Add(status, 0, wxEXPAND | wxTOP | wxLEFT | wxRIGHT, 20);
+
+    wxFont monoFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    wxStaticText* table = new wxStaticText(panel, wxID_ANY, StockData::formatComparison(entries));
+    table->SetFont(monoFont);
+    sizer->Add(table, 1, wxEXPAND | wxALL, 20);
+
+    panel->Fit();
+    Fit();
+}
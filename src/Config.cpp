@@ -1,86 +1,178 @@
-#pragma once
-#include "Common.h"
-#include "Config.h"
-#include <algorithm>
-#include <fstream>
-#include <wx/stdpaths.h>
-
-Config& Config::getInstance() {
-    static Config instance;
-    return instance;
-}
-
-Config::Config() {
-    configFile_ = getProgramDir() + "/" + configFile_;
-}
-
-// 获取程序所在目录路径的静态函数实现
-std::string Config::getProgramDir() {
-    wxStandardPaths& stdPaths = wxStandardPaths::Get();
-    wxString exePath = stdPaths.GetExecutablePath();
-    return std::string(wxPathOnly(exePath).mb_str());
-}
-
-bool Config::saveConfig(const std::string& stockCode) {
-
-    if (!stockCode.empty()) {
-        // 将股票代码转换为小写形式，以便进行不区分大小写的比较
-        std::string lowerStockCode = toLowerCase(stockCode);
-
-        // 在stockHistory_中查找元素，这里通过将历史记录中的代码也转换为小写形式来进行比较
-        auto it = std::find_if(stockHistory_.begin(), stockHistory_.end(), [&lowerStockCode](const std::string& historyCode) {
-            return toLowerCase(historyCode) == lowerStockCode;
-            });
-
-        if (it != stockHistory_.end()) {
-            stockHistory_.erase(it);
-        }
-
-        // 将当前股票代码插入到stockHistory_的开头位置
-        stockHistory_.insert(stockHistory_.begin(), stockCode);
-    }
-
-    nlohmann::json j;
-    j["language"] = language_;
-    j["stock_history"] = stockHistory_;
-
-    std::ofstream file(configFile_);
-    if (!file.is_open()) return false;
-    file << j.dump(4);
-    return true;
-}
-
-bool Config::loadConfig() {
-    std::ifstream file(configFile_);
-    if (!file.is_open()) return false;
-
-    try {
-        nlohmann::json j;
-        file >> j;
-        stockHistory_ = j["stock_history"].get<std::vector<std::string>>();
-        language_ = toLowerCase(j["language"].get<std::string>());
-    } catch (...) {
-        return false;
-    }
-    return true;
-}
-
-const int Config::getLanguage() {
-    // 尝试初始化语言环境，优先配置文件中指定的语言
-    if (language_.empty()) {
-        return wxLocale::GetSystemLanguage();
-    }
-    else {
-        // 查找指定的语言信息
-        const wxLanguageInfo* language = wxLocale::FindLanguageInfo(language_);
-
-        // 找到对应的语言信息，初始化语言环境
-        if (language != nullptr) {
-            return language->Language;
-        }
-        // 如果没有找到，使用默认语言初始化语言环境
-        else {
-            return wxLocale::GetSystemLanguage();
-        }
-    }
+#pragma once
+#include "Common.h"
+#include "Config.h"
+#include <algorithm>
+#include <fstream>
+#include <wx/stdpaths.h>
+
+namespace {
+    // 窗口长度列表必须非空、为正且严格递增，否则保留默认值
+    bool readWindows(const nlohmann::json& j, const char* key, std::vector<int>& out) {
+        if (!j.contains(key) || !j[key].is_array()) return false;
+        const std::vector<int> windows = j[key].get<std::vector<int>>();
+        if (windows.empty() || windows.front() <= 0) return false;
+        for (size_t i = 1; i < windows.size(); ++i) {
+            if (windows[i] <= windows[i - 1]) return false;
+        }
+        out = windows;
+        return true;
+    }
+}
+
+Config& Config::getInstance() {
+    static Config instance;
+    return instance;
+}
+
+Config::Config() {
+    configFile_ = getProgramDir() + "/" + configFile_;
+}
+
+// 获取程序所在目录路径的静态函数实现
+std::string Config::getProgramDir() {
+    wxStandardPaths& stdPaths = wxStandardPaths::Get();
+    wxString exePath = stdPaths.GetExecutablePath();
+    return std::string(wxPathOnly(exePath).mb_str());
+}
+
+bool Config::saveConfig(const std::string& stockCode) {
+
+    if (!stockCode.empty()) {
+        // 将股票代码转换为小写形式，以便进行不区分大小写的比较
+        std::string lowerStockCode = toLowerCase(stockCode);
+
+        // 在stockHistory_中查找元素，这里通过将历史记录中的代码也转换为小写形式来进行比较
+        auto it = std::find_if(stockHistory_.begin(), stockHistory_.end(), [&lowerStockCode](const std::string& historyCode) {
+            return toLowerCase(historyCode) == lowerStockCode;
+            });
+
+        if (it != stockHistory_.end()) {
+            stockHistory_.erase(it);
+        }
+
+        // 将当前股票代码插入到stockHistory_的开头位置
+        stockHistory_.insert(stockHistory_.begin(), stockCode);
+    }
+
+    nlohmann::json j;
+    j["language"] = language_;
+    j["stock_history"] = stockHistory_;
+    j["trace"] = trace_;
+    j["archive"] = archive_;
+    j["cache_mb"] = cacheMB_;
+    j["requests_per_second"] = requestRate_;
+    j["request_burst"] = requestBurst_;
+    j["max_concurrency"] = maxConcurrency_;
+    j["fetch_retries"] = fetchRetries_;
+    j["hedge_requests"] = hedgeRequests_;
+    j["scan_request_budget"] = scanRequestBudget_;
+    j["scan_top_n"] = scanTopN_;
+    j["scan_large_amount"] = scanLargeAmount_;
+    j["scan_spike_window"] = scanSpikeWindow_;
+    j["formulas"] = nlohmann::json::array();
+    for (const auto& formula : formulas_) {
+        j["formulas"].push_back({ { "name", formula.name }, { "expression", formula.expression } });
+    }
+    j["live_poll_seconds"] = livePollSeconds_;
+    j["flow_windows"] = flowWindows_;
+    j["flow_z_threshold"] = flowZThreshold_;
+    j["flow_baseline_minutes"] = flowBaselineMinutes_;
+    j["baseline_days"] = baselineDays_;
+    j["baseline_bucket_minutes"] = baselineBucketMinutes_;
+    j["alert_rules"] = nlohmann::json::array();
+    for (const auto& rule : alertRules_) {
+        j["alert_rules"].push_back({
+            { "name", rule.name },
+            { "kind", rule.kind },
+            { "filter", rule.filter },
+            { "value", rule.value },
+            { "window", rule.window },
+            { "threshold", rule.threshold },
+            { "above_average", rule.averageMultiple },
+        });
+    }
+
+    std::ofstream file(configFile_);
+    if (!file.is_open()) return false;
+    file << j.dump(4);
+    return true;
+}
+
+bool Config::loadConfig() {
+    std::ifstream file(configFile_);
+    if (!file.is_open()) return false;
+
+    try {
+        nlohmann::json j;
+        file >> j;
+        stockHistory_ = j["stock_history"].get<std::vector<std::string>>();
+        language_ = toLowerCase(j["language"].get<std::string>());
+        trace_ = j.value("trace", false);
+        archive_ = j.value("archive", true);
+        cacheMB_ = j.value("cache_mb", static_cast<size_t>(256));
+        requestRate_ = j.value("requests_per_second", 2.0);
+        requestBurst_ = j.value("request_burst", 2.0);
+        maxConcurrency_ = (std::max)(j.value("max_concurrency", static_cast<size_t>(4)), static_cast<size_t>(1));
+        fetchRetries_ = (std::max)(j.value("fetch_retries", 3), 0);
+        hedgeRequests_ = j.value("hedge_requests", true);
+        scanRequestBudget_ = j.value("scan_request_budget", static_cast<size_t>(20000));
+        scanTopN_ = (std::max)(j.value("scan_top_n", static_cast<size_t>(50)), static_cast<size_t>(1));
+        scanLargeAmount_ = j.value("scan_large_amount", 1000000.0);
+        scanSpikeWindow_ = (std::max)(j.value("scan_spike_window", 60), 1);
+        // 没有 formulas 时保留默认公式
+        if (j.contains("formulas") && j["formulas"].is_array()) {
+            formulas_.clear();
+            for (const auto& item : j["formulas"]) {
+                formulas_.push_back({ item.value("name", ""), item.value("expression", "") });
+            }
+        }
+        livePollSeconds_ = (std::max)(j.value("live_poll_seconds", 3.0), 0.5);
+        readWindows(j, "flow_windows", flowWindows_);
+        flowZThreshold_ = j.value("flow_z_threshold", 3.0);
+        flowBaselineMinutes_ = (std::max)(j.value("flow_baseline_minutes", 30), 1);
+        readWindows(j, "baseline_days", baselineDays_);
+        baselineBucketMinutes_ = (std::max)(j.value("baseline_bucket_minutes", 5), 1);
+        if (j.contains("alert_rules") && j["alert_rules"].is_array()) {
+            alertRules_.clear();
+            for (const auto& item : j["alert_rules"]) {
+                AlertRuleEntry rule;
+                rule.name = item.value("name", "");
+                rule.kind = item.value("kind", "tick");
+                rule.filter = item.value("filter", "");
+                rule.value = item.value("value", "amount");
+                rule.window = (std::max)(item.value("window", 300), 1);
+                rule.threshold = item.value("threshold", 0.0);
+                rule.averageMultiple = item.value("above_average", 0.0);
+                alertRules_.push_back(rule);
+            }
+        }
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+bool Config::setFormulas(const std::vector<FormulaEntry>& formulas) {
+    formulas_ = formulas;
+    return saveConfig();
+}
+
+const int Config::getLanguage() {
+    // 尝试初始化语言环境，优先配置文件中指定的语言
+    if (language_.empty()) {
+        return wxLocale::GetSystemLanguage();
+    }
+    else {
+        // 查找指定的语言信息
+        const wxLanguageInfo* language = wxLocale::FindLanguageInfo(language_);
+
+        // 找到对应的语言信息，初始化语言环境
+        if (language != nullptr) {
+            return language->Language;
+        }
+        // 如果没有找到，使用默认语言初始化语言环境
+        else {
+            return wxLocale::GetSystemLanguage();
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include "Common.h"
+#include "Config.h"
+#include "Correlation.h"
+#include "TextTable.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CORRELATION_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CORRELATION_SSE2 1
+#endif
+
+namespace {
+    // 每个块的行数：两个块的标准化序列（64 行 x 240 分钟 x 8 字节）同时留在 L2 中
+    const size_t BLOCK_ROWS = 64;
+    // 序列长度按 4 个 double 对齐，补齐部分为 0，不影响点积
+    const size_t LANES = 4;
+    // 收盘竞价等稍晚于时段结束的成交计入最后一分钟
+    const int LATE_SECONDS = 60;
+
+    // a 与 b0..b3 的点积，一次读取 a 供四个累加器使用
+    void dot4(const double* a, const double* b0, const double* b1, const double* b2, const double* b3, size_t length, double out[4]) {
+#if defined(CORRELATION_AVX)
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+        for (size_t k = 0; k < length; k += 4) {
+            const __m256d x = _mm256_loadu_pd(a + k);
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(x, _mm256_loadu_pd(b0 + k)));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(x, _mm256_loadu_pd(b1 + k)));
+            s2 = _mm256_add_pd(s2, _mm256_mul_pd(x, _mm256_loadu_pd(b2 + k)));
+            s3 = _mm256_add_pd(s3, _mm256_mul_pd(x, _mm256_loadu_pd(b3 + k)));
+        }
+        // 四个累加器各自横向求和
+        const __m256d h01 = _mm256_hadd_pd(s0, s1);
+        const __m256d h23 = _mm256_hadd_pd(s2, s3);
+        const __m256d sum = _mm256_add_pd(_mm256_permute2f128_pd(h01, h23, 0x20), _mm256_permute2f128_pd(h01, h23, 0x31));
+        _mm256_storeu_pd(out, sum);
+#elif defined(CORRELATION_SSE2)
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+        for (size_t k = 0; k < length; k += 2) {
+            const __m128d x = _mm_loadu_pd(a + k);
+            s0 = _mm_add_pd(s0, _mm_mul_pd(x, _mm_loadu_pd(b0 + k)));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(x, _mm_loadu_pd(b1 + k)));
+            s2 = _mm_add_pd(s2, _mm_mul_pd(x, _mm_loadu_pd(b2 + k)));
+            s3 = _mm_add_pd(s3, _mm_mul_pd(x, _mm_loadu_pd(b3 + k)));
+        }
+        double lanes[8];
+        _mm_storeu_pd(lanes, s0);
+        _mm_storeu_pd(lanes + 2, s1);
+        _mm_storeu_pd(lanes + 4, s2);
+        _mm_storeu_pd(lanes + 6, s3);
+        for (int q = 0; q < 4; ++q) {
+            out[q] = lanes[2 * q] + lanes[2 * q + 1];
+        }
+#else
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (size_t k = 0; k < length; ++k) {
+            s0 += a[k] * b0[k];
+            s1 += a[k] * b1[k];
+            s2 += a[k] * b2[k];
+            s3 += a[k] * b3[k];
+        }
+        out[0] = s0;
+        out[1] = s1;
+        out[2] = s2;
+        out[3] = s3;
+#endif
+    }
+
+    double dot(const double* a, const double* b, size_t length) {
+        double out[4];
+        dot4(a, b, b, b, b, length, out);
+        return out[0];
+    }
+}
+
+std::vector<int> Correlation::minuteGrid(std::vector<TradingSession> sessions, int stimesec, int etimesec) {
+    const int from = (stimesec >= 0) ? stimesec / 60 * 60 : 0;
+    const int to = (etimesec >= 0) ? etimesec : 24 * 60 * 60;
+
+    // 合并重叠的时段
+    std::sort(sessions.begin(), sessions.end(), [](const TradingSession& a, const TradingSession& b) { return a.open < b.open; });
+    std::vector<TradingSession> merged;
+    for (const auto& session : sessions) {
+        if (!merged.empty() && session.open <= merged.back().close) {
+            merged.back().close = (std::max)(merged.back().close, session.close);
+        }
+        else {
+            merged.push_back(session);
+        }
+    }
+
+    std::vector<int> minutes;
+    for (const auto& session : merged) {
+        for (int minute = (std::max)(session.open, from); minute < session.close && minute <= to; minute += 60) {
+            minutes.push_back(minute);
+        }
+    }
+    return minutes;
+}
+
+// 成交按时间顺序落入开始时间不晚于它的最近一分钟；没有成交的分钟沿用上一分钟的收盘价
+MinuteSeries Correlation::buildSeries(const std::string& stockCode, const TickColumns& data, const std::vector<int>& minutes) {
+    MinuteSeries series;
+    series.stockCode = stockCode;
+    const size_t count = minutes.size();
+    series.flow.assign(count, 0.0);
+    series.returns.assign(count > 0 ? count - 1 : 0, 0.0);
+    if (count == 0) return series;
+
+    std::vector<double> close(count, 0.0);
+    size_t k = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        const int time = data.time[i];
+        if (time < minutes[0]) continue;
+        while (k + 1 < count && time >= minutes[k + 1]) k++;
+        if (time >= minutes[k] + 60 + LATE_SECONDS) continue;
+        if (data.price[i] > 0) close[k] = data.price[i];
+        series.flow[k] += data.side[i] * data.amount[i];
+    }
+    for (size_t m = 1; m < count; ++m) {
+        if (close[m] == 0.0) close[m] = close[m - 1];
+        if (close[m - 1] > 0.0) {
+            series.returns[m - 1] = std::log(close[m] / close[m - 1]);
+        }
+    }
+    return series;
+}
+
+CorrelationMatrix Correlation::compute(const std::vector<std::string>& codes, const std::vector<std::vector<double>>& rows) {
+    TRACE_SCOPE("Correlation::compute");
+    CorrelationMatrix matrix;
+    matrix.codes = codes;
+    const size_t n = rows.size();
+    matrix.values.assign(n * n, std::numeric_limits<double>::quiet_NaN());
+    if (n == 0) return matrix;
+
+    // 每行减去均值并缩放为单位长度，相关系数即为两行的点积
+    const size_t length = rows[0].size();
+    const size_t stride = (length + LANES - 1) / LANES * LANES;
+    std::vector<double> z(n * stride, 0.0);
+    std::vector<char> valid(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        const std::vector<double>& row = rows[i];
+        double mean = 0.0;
+        for (double value : row) mean += value;
+        mean /= (std::max)(length, static_cast<size_t>(1));
+        double norm = 0.0;
+        for (double value : row) norm += (value - mean) * (value - mean);
+        if (norm <= 0.0) continue;
+        const double scale = 1.0 / std::sqrt(norm);
+        double* out = &z[i * stride];
+        for (size_t k = 0; k < length; ++k) {
+            out[k] = (row[k] - mean) * scale;
+        }
+        valid[i] = 1;
+    }
+
+    // 上三角的块对 (bi, bj)，bj >= bi
+    const size_t blocks = (n + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    std::vector<std::pair<size_t, size_t>> tiles;
+    for (size_t bi = 0; bi < blocks; ++bi) {
+        for (size_t bj = bi; bj < blocks; ++bj) {
+            tiles.emplace_back(bi, bj);
+        }
+    }
+
+    double* values = matrix.values.data();
+    auto store = [&](size_t i, size_t j, double r) {
+        if (!valid[i] || !valid[j]) return;
+        r = (std::max)(-1.0, (std::min)(1.0, r));
+        values[i * n + j] = r;
+        values[j * n + i] = r;
+    };
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        for (size_t t = next++; t < tiles.size(); t = next++) {
+            const size_t iBegin = tiles[t].first * BLOCK_ROWS, iEnd = (std::min)(iBegin + BLOCK_ROWS, n);
+            const size_t jBegin = tiles[t].second * BLOCK_ROWS, jEnd = (std::min)(jBegin + BLOCK_ROWS, n);
+            for (size_t i = iBegin; i < iEnd; ++i) {
+                const double* a = &z[i * stride];
+                // 对角块只算 j >= i 的部分
+                size_t j = (iBegin == jBegin) ? i : jBegin;
+                for (; j + 4 <= jEnd; j += 4) {
+                    double out[4];
+                    dot4(a, &z[j * stride], &z[(j + 1) * stride], &z[(j + 2) * stride], &z[(j + 3) * stride], stride, out);
+                    for (int q = 0; q < 4; ++q) {
+                        store(i, j + q, out[q]);
+                    }
+                }
+                for (; j < jEnd; ++j) {
+                    store(i, j, dot(a, &z[j * stride], stride));
+                }
+            }
+        }
+    };
+
+    const size_t threads = (std::min)(tiles.size(), static_cast<size_t>((std::max)(std::thread::hardware_concurrency(), 1u)));
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    return matrix;
+}
+
+CorrelationResult Correlation::analyze(const std::vector<std::string>& stockCodes, int stimesec, int etimesec) {
+    TRACE_SCOPE("Correlation::analyze");
+    CorrelationResult result;
+
+    // 分钟网格在查询前确定，每只股票取得数据后立即压缩成分钟序列，不必同时保留所有成交明细
+    SymbolMetadata& metadata = SymbolMetadata::getInstance();
+    std::vector<TradingSession> sessions;
+    for (const auto& code : stockCodes) {
+        const SymbolInfo info = metadata.get(StockData::getStockSymbol(code));
+        sessions.insert(sessions.end(), info.sessions.begin(), info.sessions.end());
+    }
+    result.minutes = minuteGrid(sessions, stimesec, etimesec);
+    if (result.minutes.size() < 3) {
+        throw std::string(_("No data available for analysis"));
+    }
+
+    StopWatch fetchWatch;
+    std::vector<MinuteSeries> series(stockCodes.size());
+    std::vector<std::string> errors(stockCodes.size());
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        for (size_t k = next++; k < stockCodes.size(); k = next++) {
+            try {
+                const TickColumns data = StockData::queryStockData(stockCodes[k], stimesec, etimesec);
+                series[k] = buildSeries(stockCodes[k], data, result.minutes);
+            }
+            catch (const std::exception& e) {
+                errors[k] = e.what();
+            }
+            catch (const std::string& s) {
+                errors[k] = s;
+            }
+        }
+    };
+    metadata.beginBatch();
+    const size_t workers = (std::min)(stockCodes.size(), Config::getInstance().getMaxConcurrency());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    metadata.endBatch();
+    result.fetchUs = fetchWatch.elapsedUs();
+
+    StopWatch computeWatch;
+    std::vector<std::string> codes;
+    std::vector<std::vector<double>> returns, flow;
+    for (size_t k = 0; k < stockCodes.size(); ++k) {
+        if (!errors[k].empty()) {
+            result.errors.push_back(stockCodes[k] + ": " + errors[k]);
+            continue;
+        }
+        codes.push_back(stockCodes[k]);
+        returns.push_back(std::move(series[k].returns));
+        flow.push_back(std::move(series[k].flow));
+    }
+    result.returns = compute(codes, returns);
+    result.flow = compute(codes, flow);
+    result.computeUs = computeWatch.elapsedUs();
+    return result;
+}
+
+// 按收益率相关系数的绝对值排列，同时列出净买入金额的相关系数
+wxString Correlation::formatTopPairs(const CorrelationResult& result, size_t count) {
+    const CorrelationMatrix& returns = result.returns;
+    const size_t n = returns.size();
+    std::vector<std::pair<size_t, size_t>> pairs;
+    pairs.reserve(n * (n - (n > 0 ? 1 : 0)) / 2);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            if (!std::isnan(returns.at(i, j))) pairs.emplace_back(i, j);
+        }
+    }
+    count = (std::min)(count, pairs.size());
+    std::partial_sort(pairs.begin(), pairs.begin() + count, pairs.end(), [&](const auto& a, const auto& b) {
+        return std::fabs(returns.at(a.first, a.second)) > std::fabs(returns.at(b.first, b.second));
+    });
+
+    TextTable table;
+    table.reserve(count + 1, 4 * (count + 1));
+    auto utf8 = [](const wxString& text) { return std::string(text.utf8_str()); };
+    const wxString headers[] = { _("Rank"), _("Stock Pair"), _("Returns"), _("Order Flow") };
+    table.beginRow();
+    for (const wxString& header : headers) {
+        table.addText(utf8(header));
+    }
+    for (size_t k = 0; k < count; ++k) {
+        const size_t i = pairs[k].first, j = pairs[k].second;
+        table.beginRow();
+        table.addInteger(static_cast<long long>(k + 1));
+        table.addText(returns.codes[i] + " / " + returns.codes[j]);
+        table.addNumber(returns.at(i, j), 3);
+        const double flow = result.flow.at(i, j);
+        if (std::isnan(flow)) {
+            table.addText("-");
+        }
+        else {
+            table.addNumber(flow, 3);
+        }
+    }
+    for (const auto& error : result.errors) {
+        table.addLine(error);
+    }
+    const std::string text = table.render();
+    return wxString::FromUTF8(text.data(), text.size());
+}
@@ -0,0 +1,52 @@
+#include "CorrelationWindow.h"
+#include "Exporter.h"
+#include "Metrics.h"
+#include <wx/filedlg.h>
+
+CorrelationWindow::CorrelationWindow(wxWindow* parent, const CorrelationResult& result)
+    : wxDialog(parent, wxID_ANY, _("Correlation"), wxDefaultPosition, wxDefaultSize, wxDEFAULT_FRAME_STYLE),
+      result_(result) {
+    wxIcon appIcon("IDI_APP_ICON", wxBITMAP_TYPE_ICO_RESOURCE);
+    SetIcon(appIcon);
+
+    wxPanel* panel = new wxPanel(this);
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    wxBoxSizer* bar = new wxBoxSizer(wxHORIZONTAL);
+    panel->SetSizer(sizer);
+
+    wxStaticText* status = new wxStaticText(panel, wxID_ANY, wxString::Format(_("%d stocks x %d minutes, fetched in %s, computed in %s"),
+        static_cast<int>(result_.returns.size()), static_cast<int>(result_.minutes.size()),
+        formatDuration(result_.fetchUs), formatDuration(result_.computeUs)));
+    wxButton* exportButton = new wxButton(panel, wxID_ANY, _("Export..."));
+    exportButton->Bind(wxEVT_BUTTON, &CorrelationWindow::OnExport, this);
+    exportButton->Enable(result_.returns.size() > 0);
+    bar->Add(status, 1, wxALIGN_CENTER_VERTICAL | wxRIGHT, 10);
+    bar->Add(exportButton, 0);
+    sizer->Add(bar, 0, wxEXPAND | wxTOP | wxLEFT | wxRIGHT, 20);
+
+    wxFont monoFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    wxStaticText* table = new wxStaticText(panel, wxID_ANY, Correlation::formatTopPairs(result_));
+    table->SetFont(monoFont);
+    sizer->Add(table, 1, wxEXPAND | wxALL, 20);
+
+    panel->Fit();
+    Fit();
+}
+
+void CorrelationWindow::OnExport(wxCommandEvent& event) {
+    wxFileDialog dialog(this, _("Export Correlation"), "", "correlation",
+        "JSON (*.json)|*.json|CSV (*.csv)|*.csv|Arrow IPC (*.arrow)|*.arrow", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (dialog.ShowModal() != wxID_OK) return;
+
+    try {
+        const auto files = Exporter::exportCorrelation(dialog.GetPath().ToStdString(), result_);
+        wxString message = _("Exported to:");
+        for (const auto& file : files) {
+            message += "\n" + wxString(file);
+        }
+        wxMessageBox(message, _("Information"), wxICON_INFORMATION);
+    }
+    catch (const std::exception& e) {
+        wxMessageBox(e.what(), _("Error"), wxICON_ERROR);
+    }
+}
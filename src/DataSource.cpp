@@ -0,0 +1,80 @@
+#include "Common.h"
+#include "DataSource.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // 连续失败达到该次数后暂停使用，暂停时间从 30 秒起每次翻倍，最多 8 分钟
+    const int FAILURE_THRESHOLD = 3;
+    const int COOLDOWN_SECONDS = 30;
+    // 耗时滑动平均中新样本的权重
+    const double LATENCY_WEIGHT = 0.2;
+}
+
+DataSourceRouter& DataSourceRouter::getInstance() {
+    static DataSourceRouter instance;
+    return instance;
+}
+
+void DataSourceRouter::add(std::shared_ptr<DataSource> source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Health health;
+    health.source = std::move(source);
+    sources_.push_back(health);
+}
+
+std::vector<std::shared_ptr<DataSource>> DataSourceRouter::candidates() const {
+    std::vector<Health> ordered;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ordered = sources_;
+    }
+    if (ordered.empty()) {
+        throw std::runtime_error(_("No data source available"));
+    }
+
+    // 暂停中的数据源排在最后，仍然保留作为最后的选择
+    const auto now = std::chrono::steady_clock::now();
+    std::stable_sort(ordered.begin(), ordered.end(), [now](const Health& a, const Health& b) {
+        const bool aHealthy = a.retryAfter <= now;
+        const bool bHealthy = b.retryAfter <= now;
+        if (aHealthy != bHealthy) return aHealthy;
+        return a.latencyUs < b.latencyUs;
+    });
+
+    std::vector<std::shared_ptr<DataSource>> result;
+    for (const auto& health : ordered) {
+        result.push_back(health.source);
+    }
+    return result;
+}
+
+// 调用方已持有锁
+DataSourceRouter::Health* DataSourceRouter::findHealth(const DataSource& source) {
+    for (auto& health : sources_) {
+        if (health.source.get() == &source) return &health;
+    }
+    return nullptr;
+}
+
+void DataSourceRouter::reportSuccess(const DataSource& source, int64_t latencyUs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Health* health = findHealth(source);
+    if (!health) return;
+    health->failures = 0;
+    health->retryAfter = std::chrono::steady_clock::time_point();
+    health->latencyUs = (health->latencyUs == 0) ? static_cast<double>(latencyUs)
+        : health->latencyUs * (1 - LATENCY_WEIGHT) + latencyUs * LATENCY_WEIGHT;
+}
+
+void DataSourceRouter::reportFailure(const DataSource& source) {
+    Metrics::getInstance().counter("source." + source.name() + ".failures")++;
+    std::lock_guard<std::mutex> lock(mutex_);
+    Health* health = findHealth(source);
+    if (!health) return;
+    health->failures++;
+    if (health->failures >= FAILURE_THRESHOLD) {
+        const int doublings = (std::min)(health->failures - FAILURE_THRESHOLD, 4);
+        health->retryAfter = std::chrono::steady_clock::now() + std::chrono::seconds(COOLDOWN_SECONDS << doublings);
+    }
+}
@@ -0,0 +1,315 @@
+#include "Common.h"
+#include "ArrowWriter.h"
+#include "Correlation.h"
+#include "Exporter.h"
+#include "StockData.h"
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+// 汇总表中的数值字段，三种格式共用同一份字段定义
+struct SummaryField {
+    const char* name;
+    double SideSummary::* member;
+};
+
+static const SummaryField SUMMARY_FIELDS[] = {
+    { "sum_price", &SideSummary::sumPrice },
+    { "max_price", &SideSummary::maxPrice },
+    { "min_price", &SideSummary::minPrice },
+    { "avg_price", &SideSummary::avgPrice },
+    { "sum_volume", &SideSummary::sumVolume },
+    { "max_volume", &SideSummary::maxVolume },
+    { "min_volume", &SideSummary::minVolume },
+    { "avg_volume", &SideSummary::avgVolume },
+    { "sum_amount", &SideSummary::sumAmount },
+    { "max_amount", &SideSummary::maxAmount },
+    { "min_amount", &SideSummary::minAmount },
+    { "avg_amount", &SideSummary::avgAmount },
+    { "last_price", &SideSummary::lastPrice },
+    { "last_volume", &SideSummary::lastVolume },
+    { "last_amount", &SideSummary::lastAmount },
+};
+
+static const char* sideCode(int8_t side) {
+    return (side == SIDE_BUY) ? "B" : (side == SIDE_SELL) ? "S" : "M";
+}
+
+static std::ofstream openFile(const std::string& path, std::ios::openmode mode = std::ios::out) {
+    std::ofstream file(path, mode);
+    if (!file.is_open()) {
+        throw std::runtime_error(wxString::Format(_("Failed to open file: %s"), path).ToStdString());
+    }
+    return file;
+}
+
+// 拆分出不含扩展名的部分和小写的扩展名，没有扩展名时按 JSON 处理
+static void splitPath(const std::string& path, std::string& stem, std::string& ext, bool& hasExt) {
+    const size_t dot = path.find_last_of('.');
+    const size_t slash = path.find_last_of("/\\");
+    hasExt = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    stem = hasExt ? path.substr(0, dot) : path;
+    ext = hasExt ? toLowerCase(path.substr(dot)) : ".json";
+}
+
+std::vector<std::string> Exporter::exportResult(const std::string& path, const AnalysisResult& result, const TickColumns& ticks) {
+    std::string stem, ext;
+    bool hasExt = false;
+    splitPath(path, stem, ext, hasExt);
+
+    if (ext == ".csv") {
+        const std::string summaryPath = stem + "_summary.csv", ticksPath = stem + "_ticks.csv";
+        writeSummaryCsv(summaryPath, result);
+        writeTicksCsv(ticksPath, ticks);
+        return { summaryPath, ticksPath };
+    }
+    if (ext == ".arrow" || ext == ".feather") {
+        const std::string summaryPath = stem + "_summary" + ext, ticksPath = stem + "_ticks" + ext;
+        writeSummaryArrow(summaryPath, result);
+        writeTicksArrow(ticksPath, ticks);
+        return { summaryPath, ticksPath };
+    }
+
+    const std::string jsonPath = hasExt ? path : path + ext;
+    writeJson(jsonPath, result, ticks);
+    return { jsonPath };
+}
+
+void Exporter::writeJson(const std::string& path, const AnalysisResult& result, const TickColumns& ticks) {
+    auto sideJson = [](const SideSummary& side) {
+        nlohmann::json j;
+        j["count"] = side.count;
+        for (const auto& field : SUMMARY_FIELDS) {
+            j[field.name] = side.*field.member;
+        }
+        j["last_time"] = side.lastTime >= 0 ? StockData::secondsToTimeString(side.lastTime) : "";
+        return j;
+    };
+
+    nlohmann::json j;
+    j["stock_code"] = result.stockCode;
+    j["tick_count"] = result.tickCount;
+    j["first_time"] = result.firstTime >= 0 ? StockData::secondsToTimeString(result.firstTime) : "";
+    j["last_time"] = result.lastTime >= 0 ? StockData::secondsToTimeString(result.lastTime) : "";
+    j["lot_size"] = result.lotSize;
+    j["buy"] = sideJson(result.buy);
+    j["sell"] = sideJson(result.sell);
+    j["flow_spikes"] = nlohmann::json::array();
+    for (const auto& spike : result.spikes) {
+        j["flow_spikes"].push_back({
+            { "window", spike.window },
+            { "start", spike.start },
+            { "end", spike.end },
+            { "peak_z", spike.peakZ },
+            { "imbalance", spike.imbalance },
+            { "trades_per_second", spike.intensity },
+            { "max_amount", spike.maxAmount },
+        });
+    }
+
+    // 明细按列输出，时间为当天秒数，side 为 1 买 / -1 卖 / 0 中性
+    j["ticks"] = {
+        { "index", ticks.index },
+        { "time", ticks.time },
+        { "price", ticks.price },
+        { "change", ticks.change },
+        { "volume", ticks.volume },
+        { "amount", ticks.amount },
+        { "side", ticks.side },
+    };
+
+    std::ofstream file = openFile(path);
+    file << j.dump(2);
+}
+
+void Exporter::writeSummaryCsv(const std::string& path, const AnalysisResult& result) {
+    std::ofstream file = openFile(path);
+    file << "stock_code,side,count";
+    for (const auto& field : SUMMARY_FIELDS) {
+        file << "," << field.name;
+    }
+    file << ",last_time\n";
+
+    auto writeSide = [&](const char* name, const SideSummary& side) {
+        file << result.stockCode << "," << name << "," << side.count;
+        for (const auto& field : SUMMARY_FIELDS) {
+            file << "," << side.*field.member;
+        }
+        file << "," << (side.lastTime >= 0 ? StockData::secondsToTimeString(side.lastTime) : "") << "\n";
+    };
+    file.precision(10);
+    writeSide("Buy", result.buy);
+    writeSide("Sell", result.sell);
+}
+
+// 明细与解析器使用相同的字段顺序，导出的文件可以再次导入
+void Exporter::writeTicksCsv(const std::string& path, const TickColumns& ticks) {
+    std::ofstream file = openFile(path, std::ios::out | std::ios::binary);
+    file << "index,time,price,change,volume,amount,type\n";
+
+    std::string buffer;
+    buffer.reserve(1 << 20);
+    char number[64];
+    auto appendInteger = [&](int32_t value) {
+        auto result = std::to_chars(number, number + sizeof(number), value);
+        buffer.append(number, result.ptr);
+    };
+    auto appendNumber = [&](double value) {
+        auto result = std::to_chars(number, number + sizeof(number), value, std::chars_format::fixed);
+        buffer.append(number, result.ptr);
+    };
+
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        appendInteger(ticks.index[i]);
+        buffer += ',';
+        buffer += StockData::secondsToTimeString(ticks.time[i]);
+        buffer += ',';
+        appendNumber(ticks.price[i]);
+        buffer += ',';
+        appendNumber(ticks.change[i]);
+        buffer += ',';
+        appendNumber(ticks.volume[i]);
+        buffer += ',';
+        appendNumber(ticks.amount[i]);
+        buffer += ',';
+        buffer += sideCode(ticks.side[i]);
+        buffer += '\n';
+        if (buffer.size() > (1 << 20) - 256) {
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), buffer.size());
+}
+
+void Exporter::writeSummaryArrow(const std::string& path, const AnalysisResult& result) {
+    const std::vector<std::string> codes = { result.stockCode, result.stockCode };
+    const std::vector<std::string> sides = { "Buy", "Sell" };
+    const std::vector<int64_t> counts = { static_cast<int64_t>(result.buy.count), static_cast<int64_t>(result.sell.count) };
+    const std::vector<int32_t> lastTimes = { result.buy.lastTime, result.sell.lastTime };
+
+    std::vector<std::vector<double>> values;
+    values.reserve(std::size(SUMMARY_FIELDS));
+    for (const auto& field : SUMMARY_FIELDS) {
+        values.push_back({ result.buy.*field.member, result.sell.*field.member });
+    }
+
+    ArrowWriter writer;
+    writer.addUtf8("stock_code", codes);
+    writer.addUtf8("side", sides);
+    writer.addInt64("count", counts);
+    for (size_t i = 0; i < values.size(); ++i) {
+        writer.addFloat64(SUMMARY_FIELDS[i].name, values[i]);
+    }
+    writer.addTime32("last_time", lastTimes);
+    writer.write(path);
+}
+
+// 定长列直接引用 TickColumns 的内存，不做复制
+void Exporter::writeTicksArrow(const std::string& path, const TickColumns& ticks) {
+    ArrowWriter writer;
+    writer.addInt32("index", ticks.index);
+    writer.addTime32("time", ticks.time);
+    writer.addFloat64("price", ticks.price);
+    writer.addFloat64("change", ticks.change);
+    writer.addFloat64("volume", ticks.volume);
+    writer.addFloat64("amount", ticks.amount);
+    writer.addInt8("side", ticks.side);
+    writer.write(path);
+}
+
+std::vector<std::string> Exporter::exportCorrelation(const std::string& path, const CorrelationResult& result) {
+    std::string stem, ext;
+    bool hasExt = false;
+    splitPath(path, stem, ext, hasExt);
+
+    if (ext == ".csv") {
+        const std::string returnsPath = stem + "_returns.csv", flowPath = stem + "_flow.csv";
+        writeCorrelationCsv(returnsPath, result.returns);
+        writeCorrelationCsv(flowPath, result.flow);
+        return { returnsPath, flowPath };
+    }
+    if (ext == ".arrow" || ext == ".feather") {
+        const std::string returnsPath = stem + "_returns" + ext, flowPath = stem + "_flow" + ext;
+        writeCorrelationArrow(returnsPath, result.returns);
+        writeCorrelationArrow(flowPath, result.flow);
+        return { returnsPath, flowPath };
+    }
+
+    const std::string jsonPath = hasExt ? path : path + ext;
+    writeCorrelationJson(jsonPath, result);
+    return { jsonPath };
+}
+
+// 矩阵按行输出，无法计算的相关系数写为 null
+void Exporter::writeCorrelationJson(const std::string& path, const CorrelationResult& result) {
+    auto matrixJson = [](const CorrelationMatrix& matrix) {
+        nlohmann::json rows = nlohmann::json::array();
+        for (size_t i = 0; i < matrix.size(); ++i) {
+            nlohmann::json row = nlohmann::json::array();
+            for (size_t j = 0; j < matrix.size(); ++j) {
+                const double value = matrix.at(i, j);
+                row.push_back(std::isnan(value) ? nlohmann::json(nullptr) : nlohmann::json(value));
+            }
+            rows.push_back(row);
+        }
+        return rows;
+    };
+    std::vector<std::string> minutes;
+    for (int minute : result.minutes) {
+        minutes.push_back(StockData::secondsToTimeString(minute));
+    }
+
+    nlohmann::json j;
+    j["codes"] = result.returns.codes;
+    j["minutes"] = minutes;
+    j["returns"] = matrixJson(result.returns);
+    j["flow"] = matrixJson(result.flow);
+    j["errors"] = result.errors;
+
+    std::ofstream file = openFile(path);
+    file << j.dump(1);
+}
+
+// 第一行和第一列为股票代码，无法计算的相关系数留空
+void Exporter::writeCorrelationCsv(const std::string& path, const CorrelationMatrix& matrix) {
+    std::ofstream file = openFile(path, std::ios::out | std::ios::binary);
+    file << "stock_code";
+    for (const auto& code : matrix.codes) {
+        file << "," << code;
+    }
+    file << "\n";
+
+    std::string buffer;
+    char number[64];
+    for (size_t i = 0; i < matrix.size(); ++i) {
+        buffer = matrix.codes[i];
+        for (size_t j = 0; j < matrix.size(); ++j) {
+            buffer += ',';
+            const double value = matrix.at(i, j);
+            if (!std::isnan(value)) {
+                auto result = std::to_chars(number, number + sizeof(number), value, std::chars_format::fixed, 6);
+                buffer.append(number, result.ptr);
+            }
+        }
+        buffer += '\n';
+        file.write(buffer.data(), buffer.size());
+    }
+}
+
+// 每只股票一列，矩阵对称，第 j 列即第 j 行
+void Exporter::writeCorrelationArrow(const std::string& path, const CorrelationMatrix& matrix) {
+    const size_t n = matrix.size();
+    std::vector<std::vector<double>> columns(n);
+    for (size_t j = 0; j < n; ++j) {
+        columns[j].assign(matrix.values.begin() + j * n, matrix.values.begin() + (j + 1) * n);
+    }
+
+    ArrowWriter writer;
+    writer.addUtf8("stock_code", matrix.codes);
+    for (size_t j = 0; j < n; ++j) {
+        writer.addFloat64(matrix.codes[j], columns[j]);
+    }
+    writer.write(path);
+}
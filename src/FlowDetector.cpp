@@ -0,0 +1,159 @@
+#include "FlowDetector.h"
+#include "Config.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+FlowWindow::FlowWindow(int seconds, double zThreshold, int halfLife)
+    : seconds_(seconds), threshold_(zThreshold), halfLife_(halfLife) {
+    if (seconds <= 0 || halfLife <= 0) {
+        throw std::runtime_error("flow window and baseline half-life must be positive");
+    }
+}
+
+double FlowWindow::imbalance() const {
+    const double total = buy_ + sell_;
+    return total > 0 ? (buy_ - sell_) / total : 0.0;
+}
+
+// 两笔之间窗口成交量取上一笔之后的值，按经过的秒数计入基线；
+// 超过一个窗口的空档（如午间休市）最多按一个窗口计，避免把休市当作成交清淡
+void FlowWindow::sample(int time) {
+    if (lastTime_ < 0) {
+        lastTime_ = time;
+        return;
+    }
+    const int gap = (std::min)(time - lastTime_, seconds_);
+    if (gap <= 0) return;
+    lastTime_ = time;
+    if (weight_ == 0) {
+        mean_ = volume_;
+    }
+    const double alpha = 1.0 - std::exp2(-gap / halfLife_);
+    const double delta = volume_ - mean_;
+    mean_ += alpha * delta;
+    variance_ = (1.0 - alpha) * (variance_ + alpha * delta * delta);
+    weight_ += gap;
+}
+
+bool FlowWindow::add(const TickColumns& ticks, size_t i) {
+    const int time = ticks.time[i];
+    // 早于已加入成交的一笔会让窗口过期时间和基线采样出错，直接忽略
+    if (time < lastTime_) {
+        outOfOrder_++;
+        return false;
+    }
+    sample(time);
+
+    // 窗口为 (time - seconds, time]
+    const int expired = time - seconds_;
+    while (!entries_.empty() && entries_.front().time <= expired) {
+        const Entry& e = entries_.front();
+        buy_ -= e.buy;
+        sell_ -= e.sell;
+        volume_ -= e.volume;
+        entries_.pop_front();
+    }
+    // 窗口清空时归零，避免加减累积的舍入误差
+    if (entries_.empty()) {
+        buy_ = sell_ = volume_ = 0.0;
+    }
+    while (!peaks_.empty() && peaks_.front().time <= expired) {
+        peaks_.pop_front();
+    }
+
+    const double amount = ticks.amount[i];
+    const int8_t side = ticks.side[i];
+    const Entry entry = { time, side == SIDE_BUY ? amount : 0.0, side == SIDE_SELL ? amount : 0.0, ticks.volume[i] };
+    entries_.push_back(entry);
+    buy_ += entry.buy;
+    sell_ += entry.sell;
+    volume_ += entry.volume;
+    // 队列中金额单调递减，队首为窗口内的最大单笔
+    while (!peaks_.empty() && peaks_.back().amount <= amount) {
+        peaks_.pop_back();
+    }
+    peaks_.push_back(Peak{ time, amount });
+
+    // 基线至少积累 5 个窗口长度且不少于 10 分钟后才比较
+    const double stdev = std::sqrt(variance_);
+    z_ = (weight_ >= (std::max)(5.0 * seconds_, 600.0) && stdev > 0) ? (volume_ - mean_) / stdev : 0.0;
+
+    // 超过阈值开始，回落到阈值一半以下结束，避免在阈值附近反复开始
+    if (!inSpike_) {
+        if (z_ < threshold_) return false;
+        inSpike_ = true;
+        current_ = FlowSpike{ seconds_, time, time, z_, imbalance(), intensity(), maxAmount() };
+        return true;
+    }
+    if (z_ < threshold_ / 2) {
+        finish();
+        return false;
+    }
+    current_.end = time;
+    if (z_ > current_.peakZ) {
+        current_.peakZ = z_;
+        current_.imbalance = imbalance();
+        current_.intensity = intensity();
+        current_.maxAmount = maxAmount();
+    }
+    return false;
+}
+
+void FlowWindow::finish() {
+    if (!inSpike_) return;
+    inSpike_ = false;
+    spikes_.push_back(current_);
+}
+
+FlowDetector::FlowDetector() {
+    const Config& config = Config::getInstance();
+    for (int seconds : config.getFlowWindows()) {
+        windows_.emplace_back(seconds, config.getFlowZThreshold(), config.getFlowBaselineSeconds());
+    }
+}
+
+FlowDetector::FlowDetector(const std::vector<int>& windows, double zThreshold, int halfLife) {
+    for (int seconds : windows) {
+        windows_.emplace_back(seconds, zThreshold, halfLife);
+    }
+}
+
+// 各窗口依次处理整段成交，窗口的状态留在缓存中；
+// 导入的文件可能没有按时间排列，这时按时间稳定排序的下标顺序加入
+void FlowDetector::add(const TickColumns& ticks, size_t begin, size_t end) {
+    if (std::is_sorted(ticks.time.begin() + begin, ticks.time.begin() + end)) {
+        for (auto& window : windows_) {
+            for (size_t i = begin; i < end; ++i) {
+                window.add(ticks, i);
+            }
+        }
+        return;
+    }
+    std::vector<uint32_t> order(end - begin);
+    std::iota(order.begin(), order.end(), static_cast<uint32_t>(begin));
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return ticks.time[a] < ticks.time[b]; });
+    for (auto& window : windows_) {
+        for (uint32_t i : order) {
+            window.add(ticks, i);
+        }
+    }
+}
+
+void FlowDetector::finish() {
+    for (auto& window : windows_) {
+        window.finish();
+    }
+}
+
+std::vector<FlowSpike> FlowDetector::spikes() const {
+    std::vector<FlowSpike> all;
+    for (const auto& window : windows_) {
+        all.insert(all.end(), window.spikes().begin(), window.spikes().end());
+    }
+    std::sort(all.begin(), all.end(), [](const FlowSpike& a, const FlowSpike& b) {
+        return a.start != b.start ? a.start < b.start : a.window < b.window;
+    });
+    return all;
+}
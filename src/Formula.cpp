@@ -0,0 +1,623 @@
+#include "Common.h"
+#include "Formula.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace {
+    // 每条指令一次处理的行数，寄存器总大小保持在 L1/L2 内
+    const size_t CHUNK = 1024;
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    const double INF = std::numeric_limits<double>::infinity();
+
+    struct NameEntry {
+        const char* name;
+        int value;
+    };
+
+    const NameEntry COLUMNS[] = {
+        { "price", static_cast<int>(Formula::Op::LoadPrice) },
+        { "change", static_cast<int>(Formula::Op::LoadChange) },
+        { "volume", static_cast<int>(Formula::Op::LoadVolume) },
+        { "amount", static_cast<int>(Formula::Op::LoadAmount) },
+        { "time", static_cast<int>(Formula::Op::LoadTime) },
+        { "side", static_cast<int>(Formula::Op::LoadSide) },
+        { "index", static_cast<int>(Formula::Op::LoadIndex) },
+    };
+
+    const NameEntry AGGREGATES[] = {
+        { "sum", static_cast<int>(Formula::Aggregate::Sum) },
+        { "count", static_cast<int>(Formula::Aggregate::Count) },
+        { "avg", static_cast<int>(Formula::Aggregate::Avg) },
+        { "min", static_cast<int>(Formula::Aggregate::Min) },
+        { "max", static_cast<int>(Formula::Aggregate::Max) },
+        { "first", static_cast<int>(Formula::Aggregate::First) },
+        { "last", static_cast<int>(Formula::Aggregate::Last) },
+    };
+
+    const NameEntry SIDES[] = {
+        { "buy", SIDE_BUY },
+        { "sell", SIDE_SELL },
+        { "neutral", SIDE_NEUTRAL },
+    };
+
+    template <size_t N>
+    const NameEntry* findName(const NameEntry (&entries)[N], const std::string& name) {
+        for (const auto& entry : entries) {
+            if (name == entry.name) return &entry;
+        }
+        return nullptr;
+    }
+
+    // 一个聚合在一个时间段内的累加状态
+    struct Accumulator {
+        double sum = 0.0;
+        double count = 0.0;
+        double min = INF;
+        double max = -INF;
+        double first = NaN;
+        double last = NaN;
+        bool seen = false;
+    };
+
+    // [s, e) 内条件成立的行累加到 acc；各循环都是无分支的逐元素运算，编译器可以向量化
+    void accumulate(Accumulator& acc, Formula::Aggregate kind, const double* v, const double* m, size_t s, size_t e) {
+        using Aggregate = Formula::Aggregate;
+        switch (kind) {
+        case Aggregate::Sum:
+        case Aggregate::Avg: {
+            double s0 = 0, s1 = 0;
+            size_t i = s;
+            if (m) {
+                for (; i + 2 <= e; i += 2) {
+                    s0 += m[i] != 0.0 ? v[i] : 0.0;
+                    s1 += m[i + 1] != 0.0 ? v[i + 1] : 0.0;
+                }
+                for (; i < e; ++i) s0 += m[i] != 0.0 ? v[i] : 0.0;
+            }
+            else {
+                for (; i + 2 <= e; i += 2) {
+                    s0 += v[i];
+                    s1 += v[i + 1];
+                }
+                for (; i < e; ++i) s0 += v[i];
+            }
+            acc.sum += s0 + s1;
+            if (kind == Aggregate::Sum) break;
+            // avg 同时需要笔数
+            [[fallthrough]];
+        }
+        case Aggregate::Count: {
+            if (m) {
+                double c = 0;
+                for (size_t i = s; i < e; ++i) c += m[i];
+                acc.count += c;
+            }
+            else {
+                acc.count += static_cast<double>(e - s);
+            }
+            break;
+        }
+        case Aggregate::Min:
+        case Aggregate::Max: {
+            double lo = INF, hi = -INF;
+            double c = 0;
+            for (size_t i = s; i < e; ++i) {
+                const bool on = !m || m[i] != 0.0;
+                lo = (std::min)(lo, on ? v[i] : INF);
+                hi = (std::max)(hi, on ? v[i] : -INF);
+                c += on ? 1.0 : 0.0;
+            }
+            acc.min = (std::min)(acc.min, lo);
+            acc.max = (std::max)(acc.max, hi);
+            acc.count += c;
+            break;
+        }
+        case Aggregate::First: {
+            if (acc.seen) break;
+            for (size_t i = s; i < e; ++i) {
+                if (!m || m[i] != 0.0) {
+                    acc.first = v[i];
+                    acc.seen = true;
+                    break;
+                }
+            }
+            break;
+        }
+        case Aggregate::Last: {
+            for (size_t i = e; i > s; --i) {
+                if (!m || m[i - 1] != 0.0) {
+                    acc.last = v[i - 1];
+                    acc.seen = true;
+                    break;
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    double finish(const Accumulator& acc, Formula::Aggregate kind) {
+        using Aggregate = Formula::Aggregate;
+        switch (kind) {
+        case Aggregate::Sum: return acc.sum;
+        case Aggregate::Count: return acc.count;
+        case Aggregate::Avg: return acc.count > 0 ? acc.sum / acc.count : NaN;
+        case Aggregate::Min: return acc.count > 0 ? acc.min : NaN;
+        case Aggregate::Max: return acc.count > 0 ? acc.max : NaN;
+        case Aggregate::First: return acc.first;
+        case Aggregate::Last: return acc.last;
+        }
+        return NaN;
+    }
+}
+
+// 递归下降解析，边解析边生成列字节码和外层后缀指令
+class FormulaParser {
+public:
+    FormulaParser(const std::string& text, Formula& formula) : text_(text), formula_(formula) {}
+
+    void parse() {
+        parseScalar();
+        if (acceptWord("by")) {
+            formula_.bucketSeconds_ = parseDuration();
+        }
+        skipSpace();
+        if (pos_ < text_.size()) fail(_("unexpected text"));
+        if (formula_.aggregates_.empty()) fail(_("the formula needs at least one aggregate"));
+    }
+
+    void parseConditionOnly() {
+        formula_.mask_ = parseCondition();
+        skipSpace();
+        if (pos_ < text_.size()) fail(_("unexpected text"));
+    }
+
+private:
+    [[noreturn]] void fail(const wxString& message) const {
+        throw std::runtime_error(wxString::Format(_("Formula error at column %d: %s"), static_cast<int>(pos_ + 1), message).ToStdString());
+    }
+
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) pos_++;
+    }
+
+    bool peek(const char* symbol) {
+        skipSpace();
+        return text_.compare(pos_, std::strlen(symbol), symbol) == 0;
+    }
+
+    bool accept(const char* symbol) {
+        if (!peek(symbol)) return false;
+        pos_ += std::strlen(symbol);
+        return true;
+    }
+
+    void expect(const char* symbol) {
+        if (!accept(symbol)) fail(wxString::Format(_("expected '%s'"), symbol));
+    }
+
+    std::string peekWord() {
+        skipSpace();
+        size_t end = pos_;
+        while (end < text_.size() && (std::isalnum(static_cast<unsigned char>(text_[end])) || text_[end] == '_')) end++;
+        if (end == pos_ || std::isdigit(static_cast<unsigned char>(text_[pos_]))) return "";
+        return toLowerCase(text_.substr(pos_, end - pos_));
+    }
+
+    bool acceptWord(const char* word) {
+        if (peekWord() != word) return false;
+        pos_ += std::strlen(word);
+        return true;
+    }
+
+    bool peekNumber() {
+        skipSpace();
+        return pos_ < text_.size() && (std::isdigit(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '.');
+    }
+
+    // 数字、带 k/m 后缀的数字，或 HH:MM[:SS]
+    double parseNumber() {
+        skipSpace();
+        const char* start = text_.c_str() + pos_;
+        char* end = nullptr;
+        double value = std::strtod(start, &end);
+        if (end == start) fail(_("expected a number"));
+        pos_ += end - start;
+        if (pos_ < text_.size() && text_[pos_] == ':') {
+            int parts[3] = { static_cast<int>(value), 0, 0 };
+            for (int k = 1; k < 3 && pos_ < text_.size() && text_[pos_] == ':'; ++k) {
+                pos_++;
+                const size_t digits = pos_;
+                while (pos_ < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) pos_++;
+                if (pos_ == digits) fail(_("expected a number"));
+                parts[k] = std::atoi(text_.c_str() + digits);
+            }
+            return parts[0] * 3600.0 + parts[1] * 60.0 + parts[2];
+        }
+        if (pos_ < text_.size() && (text_[pos_] == 'k' || text_[pos_] == 'K')) {
+            pos_++;
+            value *= 1e3;
+        }
+        else if (pos_ < text_.size() && (text_[pos_] == 'm' || text_[pos_] == 'M')) {
+            pos_++;
+            value *= 1e6;
+        }
+        return value;
+    }
+
+    // 30s、5m、1h 或秒数
+    int parseDuration() {
+        skipSpace();
+        const char* start = text_.c_str() + pos_;
+        char* end = nullptr;
+        const long value = std::strtol(start, &end, 10);
+        if (end == start || value <= 0) fail(_("expected a duration such as 30s, 5m or 1h"));
+        pos_ += end - start;
+        int unit = 1;
+        if (pos_ < text_.size()) {
+            const char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text_[pos_])));
+            if (c == 's' || c == 'm' || c == 'h') {
+                unit = (c == 'h') ? 3600 : (c == 'm') ? 60 : 1;
+                pos_++;
+            }
+        }
+        return static_cast<int>(value) * unit;
+    }
+
+    // ---- 外层表达式：聚合结果之间的算术 ----
+
+    void emitScalar(Formula::ScalarOp op, int aggregate = -1, double constant = 0.0) {
+        formula_.scalar_.push_back(Formula::ScalarInstruction{ op, aggregate, constant });
+    }
+
+    void parseScalar() {
+        parseScalarTerm();
+        for (;;) {
+            if (accept("+")) { parseScalarTerm(); emitScalar(Formula::ScalarOp::Add); }
+            else if (accept("-")) { parseScalarTerm(); emitScalar(Formula::ScalarOp::Sub); }
+            else break;
+        }
+    }
+
+    void parseScalarTerm() {
+        parseScalarFactor();
+        for (;;) {
+            if (accept("*")) { parseScalarFactor(); emitScalar(Formula::ScalarOp::Mul); }
+            else if (accept("/")) { parseScalarFactor(); emitScalar(Formula::ScalarOp::Div); }
+            else break;
+        }
+    }
+
+    void parseScalarFactor() {
+        if (accept("-")) {
+            parseScalarFactor();
+            emitScalar(Formula::ScalarOp::Neg);
+            return;
+        }
+        if (accept("(")) {
+            parseScalar();
+            expect(")");
+            return;
+        }
+        if (peekNumber()) {
+            emitScalar(Formula::ScalarOp::PushConst, -1, parseNumber());
+            return;
+        }
+        const std::string word = peekWord();
+        const NameEntry* aggregate = findName(AGGREGATES, word);
+        if (aggregate) {
+            pos_ += word.size();
+            emitScalar(Formula::ScalarOp::PushAggregate, parseAggregate(static_cast<Formula::Aggregate>(aggregate->value)));
+            return;
+        }
+        if (findName(COLUMNS, word)) fail(wxString::Format(_("column '%s' must be inside an aggregate such as sum(%s)"), word, word));
+        if (word.empty()) fail(_("expected an aggregate or a number"));
+        fail(wxString::Format(_("unknown name '%s'"), word));
+    }
+
+    int parseAggregate(Formula::Aggregate kind) {
+        expect("(");
+        int value = -1;
+        if (!peek(")") && peekWord() != "where") {
+            value = parseColumn();
+        }
+        if (value < 0 && kind != Formula::Aggregate::Count) fail(_("expected a column expression"));
+        int mask = -1;
+        if (acceptWord("where")) {
+            mask = parseCondition();
+        }
+        expect(")");
+        formula_.aggregates_.push_back(Formula::AggregateSpec{ kind, value, mask });
+        return static_cast<int>(formula_.aggregates_.size()) - 1;
+    }
+
+    // ---- 列表达式：生成按块执行的指令 ----
+
+    int emit(Formula::Op op, int a = -1, int b = -1, double constant = 0.0) {
+        const int dst = formula_.registers_++;
+        formula_.program_.push_back(Formula::Instruction{ op, dst, a, b, constant });
+        return dst;
+    }
+
+    // 同一列、同一常数只占一个寄存器
+    int loadColumn(Formula::Op op) {
+        auto it = columns_.find(op);
+        if (it != columns_.end()) return it->second;
+        return columns_[op] = emit(op);
+    }
+
+    int loadConst(double value) {
+        auto it = constants_.find(value);
+        if (it != constants_.end()) return it->second;
+        return constants_[value] = emit(Formula::Op::Const, -1, -1, value);
+    }
+
+    int parseColumn() {
+        int left = parseColumnTerm();
+        for (;;) {
+            if (accept("+")) left = emit(Formula::Op::Add, left, parseColumnTerm());
+            else if (accept("-")) left = emit(Formula::Op::Sub, left, parseColumnTerm());
+            else return left;
+        }
+    }
+
+    int parseColumnTerm() {
+        int left = parseColumnFactor();
+        for (;;) {
+            if (accept("*")) left = emit(Formula::Op::Mul, left, parseColumnFactor());
+            else if (accept("/")) left = emit(Formula::Op::Div, left, parseColumnFactor());
+            else return left;
+        }
+    }
+
+    int parseColumnFactor() {
+        if (accept("-")) return emit(Formula::Op::Neg, parseColumnFactor());
+        if (accept("(")) {
+            const int value = parseColumn();
+            expect(")");
+            return value;
+        }
+        if (peekNumber()) return loadConst(parseNumber());
+        const std::string word = peekWord();
+        if (const NameEntry* column = findName(COLUMNS, word)) {
+            pos_ += word.size();
+            return loadColumn(static_cast<Formula::Op>(column->value));
+        }
+        if (const NameEntry* side = findName(SIDES, word)) {
+            pos_ += word.size();
+            return loadConst(side->value);
+        }
+        if (word.empty()) fail(_("expected a column or a number"));
+        fail(wxString::Format(_("unknown name '%s'"), word));
+    }
+
+    // ---- 条件：结果为 0/1 的寄存器 ----
+
+    int parseCondition() {
+        int left = parseConjunction();
+        while (acceptWord("or")) {
+            left = emit(Formula::Op::Or, left, parseConjunction());
+        }
+        return left;
+    }
+
+    int parseConjunction() {
+        int left = parseNegation();
+        while (acceptWord("and")) {
+            left = emit(Formula::Op::And, left, parseNegation());
+        }
+        return left;
+    }
+
+    int parseNegation() {
+        if (acceptWord("not")) return emit(Formula::Op::Not, parseNegation());
+        // 括号既可能包住条件也可能包住列表达式，先按比较解析，失败再按条件解析
+        if (peek("(")) {
+            const size_t pos = pos_;
+            const size_t program = formula_.program_.size();
+            const int registers = formula_.registers_;
+            const auto columns = columns_;
+            const auto constants = constants_;
+            try {
+                return parseComparison();
+            }
+            catch (const std::runtime_error&) {
+                pos_ = pos;
+                formula_.program_.resize(program);
+                formula_.registers_ = registers;
+                columns_ = columns;
+                constants_ = constants;
+            }
+            expect("(");
+            const int value = parseCondition();
+            expect(")");
+            return value;
+        }
+        return parseComparison();
+    }
+
+    int parseComparison() {
+        const int left = parseColumn();
+        if (acceptWord("between")) {
+            const int low = parseColumn();
+            if (!acceptWord("and")) fail(wxString::Format(_("expected '%s'"), "and"));
+            const int high = parseColumn();
+            return emit(Formula::Op::And, emit(Formula::Op::Ge, left, low), emit(Formula::Op::Le, left, high));
+        }
+        // 先匹配两个字符的运算符
+        static const std::pair<const char*, Formula::Op> OPERATORS[] = {
+            { "<=", Formula::Op::Le }, { ">=", Formula::Op::Ge }, { "==", Formula::Op::Eq }, { "!=", Formula::Op::Ne },
+            { "<", Formula::Op::Lt }, { ">", Formula::Op::Gt }, { "=", Formula::Op::Eq },
+        };
+        for (const auto& [symbol, op] : OPERATORS) {
+            if (accept(symbol)) return emit(op, left, parseColumn());
+        }
+        fail(_("expected a comparison"));
+    }
+
+    const std::string& text_;
+    Formula& formula_;
+    size_t pos_ = 0;
+    std::map<Formula::Op, int> columns_;
+    std::map<double, int> constants_;
+};
+
+Formula Formula::compile(const std::string& text) {
+    Formula formula;
+    formula.text_ = text;
+    FormulaParser(text, formula).parse();
+    return formula;
+}
+
+Formula Formula::compileCondition(const std::string& text) {
+    Formula formula;
+    formula.text_ = text;
+    FormulaParser(text, formula).parseConditionOnly();
+    return formula;
+}
+
+void Formula::evaluateCondition(const TickColumns& ticks, size_t begin, size_t end, std::vector<uint8_t>& out) const {
+    out.assign(end - begin, 0);
+    if (mask_ < 0 || begin >= end) return;
+    const size_t chunk = (std::min)(CHUNK, end - begin);
+    std::vector<double> storage(static_cast<size_t>(registers_) * chunk);
+    std::vector<const double*> reg(registers_);
+    for (const auto& ins : program_) {
+        double* dst = &storage[static_cast<size_t>(ins.dst) * chunk];
+        reg[ins.dst] = dst;
+        if (ins.op == Op::Const) std::fill(dst, dst + chunk, ins.constant);
+    }
+    for (size_t base = begin; base < end; base += chunk) {
+        const size_t len = (std::min)(chunk, end - base);
+        runChunk(ticks, base, len, storage.data(), chunk, reg.data());
+        const double* m = reg[mask_];
+        for (size_t i = 0; i < len; ++i) out[base - begin + i] = m[i] != 0.0;
+    }
+}
+
+// 对 [base, base + len) 依次执行各条列指令，寄存器 k 的缓冲区位于 storage + k * stride，浮点列的寄存器直接指向 ticks
+void Formula::runChunk(const TickColumns& ticks, size_t base, size_t len, double* storage, size_t stride, const double** reg) const {
+    for (const auto& ins : program_) {
+        double* out = &storage[static_cast<size_t>(ins.dst) * stride];
+        const double* a = ins.a >= 0 ? reg[ins.a] : nullptr;
+        const double* b = ins.b >= 0 ? reg[ins.b] : nullptr;
+        switch (ins.op) {
+        case Op::LoadPrice: reg[ins.dst] = ticks.price.data() + base; break;
+        case Op::LoadChange: reg[ins.dst] = ticks.change.data() + base; break;
+        case Op::LoadVolume: reg[ins.dst] = ticks.volume.data() + base; break;
+        case Op::LoadAmount: reg[ins.dst] = ticks.amount.data() + base; break;
+        case Op::LoadTime: for (size_t i = 0; i < len; ++i) out[i] = ticks.time[base + i]; break;
+        case Op::LoadSide: for (size_t i = 0; i < len; ++i) out[i] = ticks.side[base + i]; break;
+        case Op::LoadIndex: for (size_t i = 0; i < len; ++i) out[i] = ticks.index[base + i]; break;
+        case Op::Const: break;
+        case Op::Add: for (size_t i = 0; i < len; ++i) out[i] = a[i] + b[i]; break;
+        case Op::Sub: for (size_t i = 0; i < len; ++i) out[i] = a[i] - b[i]; break;
+        case Op::Mul: for (size_t i = 0; i < len; ++i) out[i] = a[i] * b[i]; break;
+        case Op::Div: for (size_t i = 0; i < len; ++i) out[i] = a[i] / b[i]; break;
+        case Op::Neg: for (size_t i = 0; i < len; ++i) out[i] = -a[i]; break;
+        case Op::Lt: for (size_t i = 0; i < len; ++i) out[i] = a[i] < b[i] ? 1.0 : 0.0; break;
+        case Op::Le: for (size_t i = 0; i < len; ++i) out[i] = a[i] <= b[i] ? 1.0 : 0.0; break;
+        case Op::Gt: for (size_t i = 0; i < len; ++i) out[i] = a[i] > b[i] ? 1.0 : 0.0; break;
+        case Op::Ge: for (size_t i = 0; i < len; ++i) out[i] = a[i] >= b[i] ? 1.0 : 0.0; break;
+        case Op::Eq: for (size_t i = 0; i < len; ++i) out[i] = a[i] == b[i] ? 1.0 : 0.0; break;
+        case Op::Ne: for (size_t i = 0; i < len; ++i) out[i] = a[i] != b[i] ? 1.0 : 0.0; break;
+        case Op::And: for (size_t i = 0; i < len; ++i) out[i] = a[i] * b[i]; break;
+        case Op::Or: for (size_t i = 0; i < len; ++i) out[i] = (std::max)(a[i], b[i]); break;
+        case Op::Not: for (size_t i = 0; i < len; ++i) out[i] = 1.0 - a[i]; break;
+        }
+    }
+}
+
+FormulaResult Formula::evaluate(const TickColumns& ticks) const {
+    TRACE_SCOPE("Formula::evaluate");
+    FormulaResult result;
+    result.grouped = bucketSeconds_ > 0;
+    const size_t n = ticks.size();
+
+    // 时间段：按整点对齐，编号从最早一笔所在的时间段开始
+    int firstBucket = 0;
+    size_t bucketCount = 1;
+    if (result.grouped && n > 0) {
+        const auto [lo, hi] = std::minmax_element(ticks.time.begin(), ticks.time.end());
+        firstBucket = *lo / bucketSeconds_;
+        bucketCount = static_cast<size_t>(*hi / bucketSeconds_ - firstBucket + 1);
+    }
+    std::vector<Accumulator> accumulators(aggregates_.size() * bucketCount);
+    std::vector<size_t> rows(bucketCount, 0);
+
+    // 寄存器：浮点列直接指向 TickColumns，其余指令写入各自的缓冲区；常数只填充一次
+    std::vector<double> storage(static_cast<size_t>(registers_) * CHUNK);
+    std::vector<const double*> reg(registers_);
+    for (const auto& ins : program_) {
+        double* out = &storage[static_cast<size_t>(ins.dst) * CHUNK];
+        reg[ins.dst] = out;
+        if (ins.op == Op::Const) std::fill(out, out + CHUNK, ins.constant);
+    }
+
+    std::vector<size_t> runStarts;
+    for (size_t base = 0; base < n; base += CHUNK) {
+        const size_t len = (std::min)(CHUNK, n - base);
+        runChunk(ticks, base, len, storage.data(), CHUNK, reg.data());
+
+        // 分组时把块切成时间段相同的连续行，明细按时间排序时每块只有一两段
+        runStarts.clear();
+        runStarts.push_back(0);
+        if (result.grouped) {
+            for (size_t i = 1; i < len; ++i) {
+                if (ticks.time[base + i] / bucketSeconds_ != ticks.time[base + i - 1] / bucketSeconds_) runStarts.push_back(i);
+            }
+        }
+        runStarts.push_back(len);
+
+        for (size_t r = 0; r + 1 < runStarts.size(); ++r) {
+            const size_t s = runStarts[r], e = runStarts[r + 1];
+            const size_t bucket = result.grouped ? static_cast<size_t>(ticks.time[base + s] / bucketSeconds_ - firstBucket) : 0;
+            rows[bucket] += e - s;
+            for (size_t k = 0; k < aggregates_.size(); ++k) {
+                const AggregateSpec& spec = aggregates_[k];
+                // count 没有取值寄存器时只看条件
+                const double* v = spec.value >= 0 ? reg[spec.value] : nullptr;
+                const double* m = spec.mask >= 0 ? reg[spec.mask] : nullptr;
+                accumulate(accumulators[bucket * aggregates_.size() + k], spec.kind, v, m, s, e);
+            }
+        }
+    }
+
+    // 每个有成交的时间段计算一次外层表达式
+    std::vector<double> stack;
+    for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+        if (result.grouped && rows[bucket] == 0) continue;
+        stack.clear();
+        for (const auto& ins : scalar_) {
+            switch (ins.op) {
+            case ScalarOp::PushAggregate:
+                stack.push_back(finish(accumulators[bucket * aggregates_.size() + ins.aggregate], aggregates_[ins.aggregate].kind));
+                break;
+            case ScalarOp::PushConst: stack.push_back(ins.constant); break;
+            case ScalarOp::Neg: stack.back() = -stack.back(); break;
+            default: {
+                const double b = stack.back();
+                stack.pop_back();
+                double& a = stack.back();
+                if (ins.op == ScalarOp::Add) a += b;
+                else if (ins.op == ScalarOp::Sub) a -= b;
+                else if (ins.op == ScalarOp::Mul) a *= b;
+                else a = (b != 0.0) ? a / b : NaN;
+                break;
+            }
+            }
+        }
+        result.values.push_back(stack.empty() ? NaN : stack.back());
+        if (result.grouped) {
+            result.bucketStart.push_back((firstBucket + static_cast<int>(bucket)) * bucketSeconds_);
+        }
+    }
+    return result;
+}
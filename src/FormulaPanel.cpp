@@ -0,0 +1,161 @@
+#include "FormulaPanel.h"
+#include "TextTable.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    enum FormulaColumn {
+        COLUMN_NAME,
+        COLUMN_EXPRESSION,
+        COLUMN_VALUE,
+    };
+
+    wxString formatValue(double value) {
+        return std::isnan(value) ? wxString("-") : wxString::Format("%.4f", value);
+    }
+
+    wxString formatBuckets(const FormulaResult& result) {
+        TextTable table;
+        table.reserve(result.values.size() + 1, 2 * (result.values.size() + 1));
+        table.beginRow();
+        table.addText(std::string(_("Time").utf8_str()));
+        table.addText(std::string(_("Value").utf8_str()));
+        for (size_t k = 0; k < result.values.size(); ++k) {
+            table.beginRow();
+            table.addText(std::string(StockData::secondsToTimeString(result.bucketStart[k]).utf8_str()));
+            if (std::isnan(result.values[k])) {
+                table.addText("-");
+            }
+            else {
+                table.addNumber(result.values[k], 4);
+            }
+        }
+        const std::string text = table.render();
+        return wxString::FromUTF8(text.data(), text.size());
+    }
+}
+
+FormulaPanel::FormulaPanel(wxWindow* parent, std::shared_ptr<const TickColumns> ticks)
+    : wxPanel(parent), ticks_(std::move(ticks)) {
+    TRACE_SCOPE("FormulaPanel");
+    wxFont monoFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+
+    list_ = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxSize(640, 200), wxLC_REPORT | wxLC_SINGLE_SEL);
+    list_->AppendColumn(_("Name"), wxLIST_FORMAT_LEFT, 160);
+    list_->AppendColumn(_("Expression"), wxLIST_FORMAT_LEFT, 340);
+    list_->AppendColumn(_("Value"), wxLIST_FORMAT_RIGHT, 120);
+
+    nameBox_ = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxSize(140, -1));
+    expressionBox_ = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
+    wxButton* addButton = new wxButton(this, wxID_ANY, _("Save"));
+    wxButton* removeButton = new wxButton(this, wxID_ANY, _("Remove"));
+
+    detail_ = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxSize(640, 160), wxTE_MULTILINE | wxTE_READONLY | wxHSCROLL);
+    detail_->SetFont(monoFont);
+
+    auto* editSizer = new wxBoxSizer(wxHORIZONTAL);
+    editSizer->Add(new wxStaticText(this, wxID_ANY, _("Name:")), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    editSizer->Add(nameBox_, 0, wxRIGHT, 10);
+    editSizer->Add(new wxStaticText(this, wxID_ANY, _("Formula:")), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    editSizer->Add(expressionBox_, 1, wxRIGHT, 10);
+    editSizer->Add(addButton, 0, wxRIGHT, 5);
+    editSizer->Add(removeButton, 0);
+
+    auto* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(list_, 1, wxEXPAND | wxALL, 5);
+    sizer->Add(editSizer, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 5);
+    sizer->Add(detail_, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 5);
+    SetSizer(sizer);
+
+    list_->Bind(wxEVT_LIST_ITEM_SELECTED, &FormulaPanel::OnSelect, this);
+    addButton->Bind(wxEVT_BUTTON, &FormulaPanel::OnAdd, this);
+    expressionBox_->Bind(wxEVT_TEXT_ENTER, &FormulaPanel::OnAdd, this);
+    removeButton->Bind(wxEVT_BUTTON, &FormulaPanel::OnRemove, this);
+
+    for (const auto& entry : Config::getInstance().getFormulas()) {
+        rows_.push_back(evaluate(entry));
+    }
+    Reload();
+}
+
+FormulaPanel::Row FormulaPanel::evaluate(const FormulaEntry& entry) const {
+    Row row;
+    row.entry = entry;
+    try {
+        const FormulaResult result = Formula::compile(entry.expression).evaluate(*ticks_);
+        if (result.grouped) {
+            row.value = wxString::Format(_("%llu periods"), static_cast<unsigned long long>(result.values.size()));
+            row.detail = formatBuckets(result);
+        }
+        else {
+            row.value = formatValue(result.values.empty() ? NAN : result.values[0]);
+        }
+    }
+    catch (const std::runtime_error& e) {
+        row.valid = false;
+        row.value = _("Error");
+        row.detail = wxString::FromUTF8(e.what());
+    }
+    return row;
+}
+
+void FormulaPanel::Reload() {
+    list_->DeleteAllItems();
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        const long item = list_->InsertItem(static_cast<long>(i), wxString::FromUTF8(rows_[i].entry.name.c_str()));
+        list_->SetItem(item, COLUMN_EXPRESSION, wxString::FromUTF8(rows_[i].entry.expression.c_str()));
+        list_->SetItem(item, COLUMN_VALUE, rows_[i].value);
+    }
+}
+
+void FormulaPanel::Save() {
+    std::vector<FormulaEntry> formulas;
+    for (const auto& row : rows_) {
+        formulas.push_back(row.entry);
+    }
+    Config::getInstance().setFormulas(formulas);
+}
+
+void FormulaPanel::OnSelect(wxListEvent& event) {
+    const long item = event.GetIndex();
+    if (item < 0 || static_cast<size_t>(item) >= rows_.size()) return;
+    const Row& row = rows_[item];
+    nameBox_->SetValue(wxString::FromUTF8(row.entry.name.c_str()));
+    expressionBox_->SetValue(wxString::FromUTF8(row.entry.expression.c_str()));
+    detail_->SetValue(row.detail);
+}
+
+// 同名公式覆盖，否则追加；语法错误时不保存
+void FormulaPanel::OnAdd(wxCommandEvent& event) {
+    FormulaEntry entry;
+    entry.name = std::string(nameBox_->GetValue().Trim().Trim(false).utf8_str());
+    entry.expression = std::string(expressionBox_->GetValue().Trim().Trim(false).utf8_str());
+    if (entry.expression.empty()) return;
+    if (entry.name.empty()) entry.name = entry.expression;
+
+    wxBusyCursor busy;
+    Row row = evaluate(entry);
+    detail_->SetValue(row.detail);
+    if (!row.valid) return;
+
+    auto it = std::find_if(rows_.begin(), rows_.end(), [&](const Row& r) { return r.entry.name == entry.name; });
+    if (it != rows_.end()) {
+        *it = std::move(row);
+    }
+    else {
+        rows_.push_back(std::move(row));
+    }
+    Reload();
+    Save();
+}
+
+void FormulaPanel::OnRemove(wxCommandEvent& event) {
+    const long item = list_->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    if (item < 0 || static_cast<size_t>(item) >= rows_.size()) return;
+    rows_.erase(rows_.begin() + item);
+    detail_->Clear();
+    Reload();
+    Save();
+}
@@ -0,0 +1,127 @@
+#include "Common.h"
+#include "LiveFeed.h"
+#include "Config.h"
+#include "SymbolMetadata.h"
+#include "TickArchive.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+LiveFeed::LiveFeed(std::vector<std::string> stockCodes, Listener listener)
+    : state_(std::make_shared<State>()) {
+    state_->listener = std::move(listener);
+    for (auto& code : stockCodes) {
+        SymbolFeed feed;
+        feed.stockCode = std::move(code);
+        state_->symbols.push_back(std::move(feed));
+    }
+    std::thread(&LiveFeed::run, state_).detach();
+}
+
+LiveFeed::~LiveFeed() {
+    stop();
+}
+
+void LiveFeed::stop() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stopping = true;
+    }
+    state_->wake.notify_all();
+}
+
+bool LiveFeed::stopping(State& state) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.stopping;
+}
+
+// 查询上次最后一笔所在秒之后的成交，同一秒内已经处理过的按序号去掉
+void LiveFeed::poll(State& state, SymbolFeed& feed, TickColumns& fresh) {
+    fresh.clear();
+    if (stopping(state)) return;
+    const int since = feed.ticks.empty() ? -1 : feed.ticks.time.back();
+    const int32_t lastIndex = feed.ticks.empty() ? -1 : feed.ticks.index.back();
+    try {
+        const TickColumns data = StockData::queryStockData(feed.stockCode, since, -1);
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (data.index[i] <= lastIndex) continue;
+            fresh.push(data.index[i], data.time[i], data.price[i], data.change[i], data.volume[i], data.amount[i], data.side[i]);
+        }
+    }
+    catch (const std::exception&) {
+        state.errors++;
+    }
+    catch (const std::string&) {
+        // 还没有新的成交
+    }
+}
+
+void LiveFeed::run(std::shared_ptr<State> state) {
+    if (Trace::enabled()) {
+        Trace::setThreadName("Live feed");
+    }
+    std::vector<SymbolFeed>& symbols = state->symbols;
+    const Config& config = Config::getInstance();
+    // 每只股票每轮至少一次请求（仍在增长的最后一页），一轮的请求数按限速需要 symbols / requests_per_second 秒；
+    // 间隔短于这个时间时各轮首尾相接，把限速全部占满，其他窗口的查询只能排队
+    const double configured = config.getLivePollSeconds();
+    const double required = static_cast<double>(symbols.size()) / (std::max)(config.getRequestRate(), 0.01);
+    const auto interval = std::chrono::microseconds(static_cast<int64_t>((std::max)(configured, required) * 1e6));
+    state->intervalUs = interval.count();
+
+    std::vector<TickColumns> fresh(symbols.size());
+    int32_t tradingDate = TickArchive::currentTradingDate();
+    for (;;) {
+        const auto started = std::chrono::steady_clock::now();
+        // 换到新的交易日后从头查询，接收方在 initial 时丢弃前一天的窗口和均价等状态
+        const int32_t today = TickArchive::currentTradingDate();
+        if (today != tradingDate) {
+            tradingDate = today;
+            for (auto& feed : symbols) {
+                feed.ticks.clear();
+                feed.primed = false;
+            }
+        }
+        {
+            TRACE_SCOPE("LiveFeed::poll");
+            // 各股票并发查询，回调仍在本线程中按顺序调用
+            std::atomic<size_t> next{ 0 };
+            auto worker = [&]() {
+                for (size_t k = next++; k < symbols.size(); k = next++) {
+                    poll(*state, symbols[k], fresh[k]);
+                }
+            };
+            SymbolMetadata& metadata = SymbolMetadata::getInstance();
+            metadata.beginBatch();
+            const size_t workers = (std::min)(symbols.size(), config.getMaxConcurrency());
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < workers; ++i) {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            metadata.endBatch();
+        }
+        state->lastRoundUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+        for (size_t k = 0; k < symbols.size(); ++k) {
+            SymbolFeed& feed = symbols[k];
+            if (fresh[k].empty()) continue;
+            // 停止后接收方可能已经不再需要结果
+            if (stopping(*state)) return;
+            const size_t begin = feed.ticks.size();
+            feed.ticks.append(fresh[k]);
+            state->ticks += fresh[k].size();
+            state->listener(feed.stockCode, feed.ticks, begin, !feed.primed);
+            feed.primed = true;
+        }
+        state->polls++;
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        if (state->wake.wait_until(lock, started + interval, [&]() { return state->stopping; })) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#include "LiveWindow.h"
+#include "Trace.h"
+#include <algorithm>
+
+namespace {
+    // 列表只保留最近的提醒
+    const int MAX_ROWS = 2000;
+
+    enum AlertColumn {
+        COLUMN_TIME,
+        COLUMN_CODE,
+        COLUMN_RULE,
+        COLUMN_DETAIL,
+    };
+}
+
+LiveWindow::LiveWindow(wxWindow* parent, const std::vector<std::string>& stockCodes)
+    : wxFrame(parent, wxID_ANY, _("Live Alerts"), wxDefaultPosition, wxSize(760, 520)), timer_(this) {
+    wxIcon appIcon("IDI_APP_ICON", wxBITMAP_TYPE_ICO_RESOURCE);
+    SetIcon(appIcon);
+
+    wxPanel* panel = new wxPanel(this);
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    panel->SetSizer(sizer);
+
+    status_ = new wxStaticText(panel, wxID_ANY, "");
+    sizer->Add(status_, 0, wxEXPAND | wxALL, 10);
+
+    list_ = new wxListCtrl(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_SINGLE_SEL);
+    list_->AppendColumn(_("Time"), wxLIST_FORMAT_LEFT, 80);
+    list_->AppendColumn(_("Stock Code"), wxLIST_FORMAT_LEFT, 100);
+    list_->AppendColumn(_("Rule"), wxLIST_FORMAT_LEFT, 160);
+    list_->AppendColumn(_("Details"), wxLIST_FORMAT_LEFT, 380);
+    sizer->Add(list_, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
+
+    try {
+        engine_ = std::make_shared<AlertEngine>(Config::getInstance().getAlertRules());
+    }
+    catch (const std::runtime_error& e) {
+        status_->SetLabel(wxString::Format(_("Invalid alert rule: %s"), wxString::FromUTF8(e.what())));
+        return;
+    }
+
+    // 回调在轮询线程中执行，只有这一个线程写入提醒队列
+    std::shared_ptr<AlertEngine> engine = engine_;
+    feed_ = std::make_unique<LiveFeed>(stockCodes, [engine](const std::string& stockCode, const TickColumns& ticks, size_t begin, bool initial) {
+        if (initial) {
+            engine->reset(stockCode);
+        }
+        engine->process(stockCode, ticks, begin, !initial);
+    });
+
+    Bind(wxEVT_TIMER, &LiveWindow::OnTimer, this);
+    timer_.Start(250);
+    status_->SetLabel(_("Waiting for ticks..."));
+}
+
+// 只通知轮询线程退出，不在界面线程等待正在进行的查询；提醒规则由回调共同持有
+LiveWindow::~LiveWindow() {
+    timer_.Stop();
+    if (feed_) {
+        feed_->stop();
+    }
+}
+
+void LiveWindow::OnTimer(wxTimerEvent& event) {
+    Alert alert;
+    bool received = false;
+    while (engine_->pop(alert)) {
+        list_->InsertItem(0, StockData::secondsToTimeString(alert.time));
+        list_->SetItem(0, COLUMN_CODE, wxString::FromUTF8(alert.stockCode.c_str()));
+        list_->SetItem(0, COLUMN_RULE, wxString::FromUTF8(alert.rule.c_str()));
+        list_->SetItem(0, COLUMN_DETAIL, AlertEngine::formatAlert(alert));
+        alerts_++;
+        received = true;
+    }
+    while (list_->GetItemCount() > MAX_ROWS) {
+        list_->DeleteItem(list_->GetItemCount() - 1);
+    }
+    if (received) {
+        RequestUserAttention(wxUSER_ATTENTION_INFO);
+    }
+
+    wxString status = wxString::Format(_("%d polls, %d ticks, %d alerts, %s"),
+        static_cast<int>(feed_->polls()), static_cast<int>(feed_->ticks()), static_cast<int>(alerts_), formatDuration(watch_.elapsedUs()));
+    // 股票多时限速不允许按 live_poll_seconds 轮询，显示实际间隔
+    const int64_t interval = (std::max)(feed_->intervalUs(), feed_->lastRoundUs());
+    if (interval > static_cast<int64_t>(Config::getInstance().getLivePollSeconds() * 1e6)) {
+        status += wxString::Format(_(" | polling every %s"), formatDuration(interval));
+    }
+    if (feed_->errors() > 0) {
+        status += wxString::Format(_(" | %d failed requests"), static_cast<int>(feed_->errors()));
+    }
+    if (engine_->dropped() > 0) {
+        status += wxString::Format(_(" | %d alerts dropped"), static_cast<int>(engine_->dropped()));
+    }
+    status_->SetLabel(status);
+}
@@ -1,174 +1,422 @@
-#pragma once
-#include "Config.h"
-#include "MainWindow.h"
-#include "ResultWindow.h"
-#include "StockData.h"
-#include <wx/regex.h>
-#include <thread>
-
-MainWindow::MainWindow()
-    : wxFrame(nullptr, wxID_ANY, _("Stock Data Analyzer"), wxDefaultPosition, wxSize(400, 150),
-        wxDEFAULT_FRAME_STYLE & ~(wxRESIZE_BORDER | wxMAXIMIZE_BOX)) {
-    // 设置主窗体图标
-    wxIcon appIcon("IDI_APP_ICON", wxBITMAP_TYPE_ICO_RESOURCE); // 从资源文件中加载图标
-    SetIcon(appIcon);
-
-    // 创建主面板和布局管理器
-    mainPanel_ = new wxPanel(this);
-    mainSizer_ = new wxBoxSizer(wxVERTICAL);
-    mainPanel_->SetSizer(mainSizer_);
-
-    // 调用方法创建股票面板
-    CreateStockPanel();
-}
-
-void MainWindow::CreateStockPanel() {
-
-
-    const auto& history = Config::getInstance().getStockHistory();
-    // 将 std::vector<std::string> 转换为 wxArrayString
-    wxArrayString stockChoices;
-    for (const auto& item : history) {
-        stockChoices.Add(item);
-    }
-
-    // 设置ComboBox样式以处理回车键
-    stockCombo_ = new wxComboBox(mainPanel_, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, stockChoices);
-    stockCombo_->SetWindowStyle(stockCombo_->GetWindowStyle() | wxTE_PROCESS_ENTER);
-    
-    auto* rSizer1 = new wxBoxSizer(wxHORIZONTAL);
-    rSizer1->Add(new wxStaticText(mainPanel_, wxID_ANY, _("Select Stock Code:"), wxDefaultPosition, wxSize(90, -1)), 0, wxALIGN_CENTER_VERTICAL | wxLEFT | wxTOP | wxRIGHT, 10);
-    rSizer1->Add(stockCombo_, 1, wxLEFT | wxTOP | wxRIGHT, 10);
-
-    stimeBox_ = new wxTextCtrl(mainPanel_, wxID_ANY, "", wxDefaultPosition, wxSize(1, 25), wxBORDER_SIMPLE);
-    etimeBox_ = new wxTextCtrl(mainPanel_, wxID_ANY,"", wxDefaultPosition, wxSize(1, 25), wxBORDER_SIMPLE);
-    actionButton_ = new wxButton(mainPanel_, wxID_ANY, _("Get Data"));
-    stimeBox_->SetMaxSize(wxSize(-1, 25));
-    etimeBox_->SetMaxSize(wxSize(-1, 25));
-    stimeBox_->SetWindowStyle(stimeBox_->GetWindowStyle() | wxTE_PROCESS_ENTER);
-    etimeBox_->SetWindowStyle(etimeBox_->GetWindowStyle() | wxTE_PROCESS_ENTER);
-
-    auto* rSizer2 = new wxBoxSizer(wxHORIZONTAL);
-    rSizer2->Add(new wxStaticText(mainPanel_, wxID_ANY, _("Set Time Span:"), wxDefaultPosition, wxSize(90,-1)), 0, wxALIGN_CENTER_VERTICAL | wxLEFT | wxTOP | wxRIGHT, 10);
-    rSizer2->Add(stimeBox_, 1, wxEXPAND | wxLEFT | wxTOP | wxRIGHT, 10);
-    rSizer2->Add(new wxStaticText(mainPanel_, wxID_ANY, "-"), 0, wxALIGN_CENTER_VERTICAL | wxTOP, 10);
-    rSizer2->Add(etimeBox_, 1, wxEXPAND | wxLEFT | wxTOP | wxRIGHT, 10);
-    rSizer2->Add(actionButton_, 0, wxTOP | wxRIGHT, 10);
-
-    mainSizer_->Add(rSizer1, 0, wxEXPAND | wxLEFT | wxTOP | wxRIGHT, 10);
-    mainSizer_->Add(rSizer2, 0, wxEXPAND | wxLEFT | wxRIGHT, 10);
-
-    // 添加版权信息标签
-    auto* copyrightLabel = new wxStaticText(mainPanel_, wxID_ANY, wxString::Format(_("Copyright %s 2024 ByteSharky All rights reserved."),wxT("\u00A9")));
-    mainSizer_->Add(copyrightLabel, 0, wxALIGN_CENTER | wxTOP, 10);
-
-    stockCombo_->Bind(wxEVT_TEXT_ENTER, &MainWindow::OnEnter, this);
-    stimeBox_->Bind(wxEVT_TEXT_ENTER, &MainWindow::OnEnter, this);
-    etimeBox_->Bind(wxEVT_TEXT_ENTER, &MainWindow::OnEnter, this);
-    actionButton_->Bind(wxEVT_BUTTON, &MainWindow::OnButton, this);
-}
-
-void MainWindow::UpdateStockComboBox(const std::vector<std::string>& newHistory) {
-    if (!stockCombo_) return; 
-
-    stockCombo_->Clear();
-
-    // 用新的项填充组合框
-    for (const auto& item : newHistory) {
-        stockCombo_->AppendString(item);
-    }
-
-    // 如果新的历史记录不为空，将第一项设置为默认选中项
-    if (!newHistory.empty()) {
-        stockCombo_->SetSelection(0);
-    }
-}
-
-// 按键事件
-void MainWindow::OnEnter(wxCommandEvent& event){
-    OnGetData();
-}
-
-// 鼠标点击按钮
-void MainWindow::OnButton(wxCommandEvent& event) {
-    OnGetData();
-}
-
-void MainWindow::OnGetData() {
-
-    std::string stockCode = stockCombo_->GetValue().ToStdString();
-    std::string stime = stimeBox_->GetValue().ToStdString();
-    std::string etime = etimeBox_->GetValue().ToStdString();
-    int stimesec = -1, etimesec = -1;
-    wxRegEx regex("^([0-1]?[0-9]|2[0-3])(:[0-5][0-9]){0,2}$");
-    wxRegEx regexhh("^([0-1]?[0-9]|2[0-3])$");
-
-
-    // 股票代码不能为空
-    if (stockCode.empty()) {
-        wxMessageBox(_("Please enter a stock code"), _("Error"), wxICON_ERROR);
-        stockCombo_->SetFocus();
-        return;
-    }
-
-    // 开始时间格式不正确，请输入格式为HH:mm:ssHH:mm或HH的时间。
-    if (stime != ""){
-        if(!regex.Matches(stime)) {
-            wxMessageBox(_("The start time format is incorrect.\nIt should be in the format of HH:mm:ss, HH:mm or HH."), _("Error"), wxICON_ERROR);
-            stimeBox_->SetFocus();
-            return;
-        }
-        stimesec = StockData::timeStringToSeconds(stime);
-    }
-
-    // 结束时间格式不正确，请输入格式为HH:mm或HH的时间。
-    if (etime != ""){
-        if (!regex.Matches(etime)) {
-            wxMessageBox(_("The end time format is incorrect.\nIt should be in the format of HH:mm:ss, HH:mm or HH."), _("Error"), wxICON_ERROR);
-            etimeBox_->SetFocus();
-            return;
-        }
-        etimesec = StockData::timeStringToSeconds(etime);
-    }
-
-    //开始时间不能晚于结束时间
-    if (stimesec > etimesec && etimesec > -1) {
-        wxMessageBox(_("Start time cannot be later than end time."), _("Error"), wxICON_ERROR);
-        etimeBox_->SetFocus();
-        return;
-    }
-
-    actionButton_->Disable();
-    actionButton_->SetLabel(_("Querying..."));
-    
-    // 使用 std::thread 启动异步任务
-    std::thread([=]() {
-
-        bool succeed = false;
-        std::vector<TickData> data;
-        try
-        {
-            data = StockData::queryStockData(stockCode, stimesec, etimesec);
-            Config::getInstance().saveConfig(stockCode);
-            succeed = true;
-        }
-        catch (const std::exception& e) {
-            wxMessageBox(e.what(), "Error", wxICON_ERROR);
-        }
-        catch (const std::string& s) {
-            wxMessageBox(s, _("Information"), wxICON_INFORMATION);
-        }
-
-        // 回到主线程更新 UI
-        wxTheApp->CallAfter([=]() {
-            actionButton_->Enable();
-            actionButton_->SetLabel(_("Get Data"));
-            if (succeed){
-                UpdateStockComboBox(Config::getInstance().getStockHistory());
-                ResultWindow* rWindow = new ResultWindow(this, wxString::Format(_("Stock Code: %s"), stockCode));
-                rWindow->ShowResult(stockCode, data);
-            }
-        });
-
-    }).detach(); // 分离线程
-}
+#pragma once
+#include "CompareWindow.h"
+#include "Config.h"
+#include "CorrelationWindow.h"
+#include "LiveWindow.h"
+#include "MainWindow.h"
+#include "MarketScanner.h"
+#include "ResultWindow.h"
+#include "ScanWindow.h"
+#include "StockData.h"
+#include "Trace.h"
+#include <wx/choicdlg.h>
+#include <wx/filedlg.h>
+#include <wx/filename.h>
+#include <wx/regex.h>
+#include <thread>
+
+MainWindow::MainWindow()
+    : wxFrame(nullptr, wxID_ANY, _("Stock Data Analyzer"), wxDefaultPosition, wxSize(720, 150),
+        wxDEFAULT_FRAME_STYLE & ~(wxRESIZE_BORDER | wxMAXIMIZE_BOX)) {
+    // 设置主窗体图标
+    wxIcon appIcon("IDI_APP_ICON", wxBITMAP_TYPE_ICO_RESOURCE); // 从资源文件中加载图标
+    SetIcon(appIcon);
+
+    // 创建主面板和布局管理器
+    mainPanel_ = new wxPanel(this);
+    mainSizer_ = new wxBoxSizer(wxVERTICAL);
+    mainPanel_->SetSizer(mainSizer_);
+
+    // 调用方法创建股票面板
+    CreateStockPanel();
+
+    // 启动时预先建立到数据源的连接
+    StockData::warmUp();
+}
+
+void MainWindow::CreateStockPanel() {
+
+
+    const auto& history = Config::getInstance().getStockHistory();
+    // 将 std::vector<std::string> 转换为 wxArrayString
+    wxArrayString stockChoices;
+    for (const auto& item : history) {
+        stockChoices.Add(item);
+    }
+
+    // 设置ComboBox样式以处理回车键
+    stockCombo_ = new wxComboBox(mainPanel_, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, stockChoices);
+    stockCombo_->SetWindowStyle(stockCombo_->GetWindowStyle() | wxTE_PROCESS_ENTER);
+    
+    auto* rSizer1 = new wxBoxSizer(wxHORIZONTAL);
+    rSizer1->Add(new wxStaticText(mainPanel_, wxID_ANY, _("Select Stock Code:"), wxDefaultPosition, wxSize(90, -1)), 0, wxALIGN_CENTER_VERTICAL | wxLEFT | wxTOP | wxRIGHT, 10);
+    rSizer1->Add(stockCombo_, 1, wxLEFT | wxTOP | wxRIGHT, 10);
+
+    // 导入本地成交明细
+    importButton_ = new wxButton(mainPanel_, wxID_ANY, _("Import..."));
+    rSizer1->Add(importButton_, 0, wxTOP | wxRIGHT, 10);
+
+    // 从历史记录中选择多只股票对比
+    compareButton_ = new wxButton(mainPanel_, wxID_ANY, _("Compare..."));
+    rSizer1->Add(compareButton_, 0, wxTOP | wxRIGHT, 10);
+
+    // 按代码列表扫描全市场
+    scanButton_ = new wxButton(mainPanel_, wxID_ANY, _("Scan..."));
+    rSizer1->Add(scanButton_, 0, wxTOP | wxRIGHT, 10);
+
+    // 按代码列表计算分钟收益率和资金流向的相关系数
+    correlateButton_ = new wxButton(mainPanel_, wxID_ANY, _("Correlate..."));
+    rSizer1->Add(correlateButton_, 0, wxTOP | wxRIGHT, 10);
+
+    // 盘中实时轮询所选股票并按提醒规则提示
+    liveButton_ = new wxButton(mainPanel_, wxID_ANY, _("Live..."));
+    rSizer1->Add(liveButton_, 0, wxTOP | wxRIGHT, 10);
+
+    stimeBox_ = new wxTextCtrl(mainPanel_, wxID_ANY, "", wxDefaultPosition, wxSize(1, 25), wxBORDER_SIMPLE);
+    etimeBox_ = new wxTextCtrl(mainPanel_, wxID_ANY,"", wxDefaultPosition, wxSize(1, 25), wxBORDER_SIMPLE);
+    actionButton_ = new wxButton(mainPanel_, wxID_ANY, _("Get Data"));
+    stimeBox_->SetMaxSize(wxSize(-1, 25));
+    etimeBox_->SetMaxSize(wxSize(-1, 25));
+    stimeBox_->SetWindowStyle(stimeBox_->GetWindowStyle() | wxTE_PROCESS_ENTER);
+    etimeBox_->SetWindowStyle(etimeBox_->GetWindowStyle() | wxTE_PROCESS_ENTER);
+
+    auto* rSizer2 = new wxBoxSizer(wxHORIZONTAL);
+    rSizer2->Add(new wxStaticText(mainPanel_, wxID_ANY, _("Set Time Span:"), wxDefaultPosition, wxSize(90,-1)), 0, wxALIGN_CENTER_VERTICAL | wxLEFT | wxTOP | wxRIGHT, 10);
+    rSizer2->Add(stimeBox_, 1, wxEXPAND | wxLEFT | wxTOP | wxRIGHT, 10);
+    rSizer2->Add(new wxStaticText(mainPanel_, wxID_ANY, "-"), 0, wxALIGN_CENTER_VERTICAL | wxTOP, 10);
+    rSizer2->Add(etimeBox_, 1, wxEXPAND | wxLEFT | wxTOP | wxRIGHT, 10);
+    rSizer2->Add(actionButton_, 0, wxTOP | wxRIGHT, 10);
+
+    mainSizer_->Add(rSizer1, 0, wxEXPAND | wxLEFT | wxTOP | wxRIGHT, 10);
+    mainSizer_->Add(rSizer2, 0, wxEXPAND | wxLEFT | wxRIGHT, 10);
+
+    // 添加版权信息标签
+    auto* copyrightLabel = new wxStaticText(mainPanel_, wxID_ANY, wxString::Format(_("Copyright %s 2024 ByteSharky All rights reserved."),wxT("\u00A9")));
+    mainSizer_->Add(copyrightLabel, 0, wxALIGN_CENTER | wxTOP, 10);
+
+    stockCombo_->Bind(wxEVT_TEXT_ENTER, &MainWindow::OnEnter, this);
+    stimeBox_->Bind(wxEVT_TEXT_ENTER, &MainWindow::OnEnter, this);
+    etimeBox_->Bind(wxEVT_TEXT_ENTER, &MainWindow::OnEnter, this);
+    actionButton_->Bind(wxEVT_BUTTON, &MainWindow::OnButton, this);
+    importButton_->Bind(wxEVT_BUTTON, &MainWindow::OnImport, this);
+    compareButton_->Bind(wxEVT_BUTTON, &MainWindow::OnCompare, this);
+    scanButton_->Bind(wxEVT_BUTTON, &MainWindow::OnScan, this);
+    correlateButton_->Bind(wxEVT_BUTTON, &MainWindow::OnCorrelate, this);
+    liveButton_->Bind(wxEVT_BUTTON, &MainWindow::OnLive, this);
+
+    // 输入股票代码时保持连接；从历史记录中选中时预取分页信息
+    stockCombo_->Bind(wxEVT_SET_FOCUS, &MainWindow::OnStockFocus, this);
+    stockCombo_->Bind(wxEVT_TEXT, &MainWindow::OnStockEdit, this);
+    stockCombo_->Bind(wxEVT_COMBOBOX, &MainWindow::OnStockEdit, this);
+}
+
+void MainWindow::OnStockFocus(wxFocusEvent& event) {
+    StockData::warmUp();
+    event.Skip();
+}
+
+void MainWindow::OnStockEdit(wxCommandEvent& event) {
+    StockData::warmUp(event.GetEventType() == wxEVT_COMBOBOX ? event.GetString().ToStdString() : "");
+    event.Skip();
+}
+
+void MainWindow::UpdateStockComboBox(const std::vector<std::string>& newHistory) {
+    if (!stockCombo_) return; 
+
+    stockCombo_->Clear();
+
+    // 用新的项填充组合框
+    for (const auto& item : newHistory) {
+        stockCombo_->AppendString(item);
+    }
+
+    // 如果新的历史记录不为空，将第一项设置为默认选中项
+    if (!newHistory.empty()) {
+        stockCombo_->SetSelection(0);
+    }
+}
+
+// 按键事件
+void MainWindow::OnEnter(wxCommandEvent& event){
+    OnGetData();
+}
+
+// 鼠标点击按钮
+void MainWindow::OnButton(wxCommandEvent& event) {
+    OnGetData();
+}
+
+// 校验并读取时间范围，格式错误时提示并返回 false
+bool MainWindow::GetTimeSpan(int& stimesec, int& etimesec) {
+    std::string stime = stimeBox_->GetValue().ToStdString();
+    std::string etime = etimeBox_->GetValue().ToStdString();
+    stimesec = -1;
+    etimesec = -1;
+    wxRegEx regex("^([0-1]?[0-9]|2[0-3])(:[0-5][0-9]){0,2}$");
+
+    // 开始时间格式不正确，请输入格式为HH:mm:ssHH:mm或HH的时间。
+    if (stime != ""){
+        if(!regex.Matches(stime)) {
+            wxMessageBox(_("The start time format is incorrect.\nIt should be in the format of HH:mm:ss, HH:mm or HH."), _("Error"), wxICON_ERROR);
+            stimeBox_->SetFocus();
+            return false;
+        }
+        stimesec = StockData::timeStringToSeconds(stime);
+    }
+
+    // 结束时间格式不正确，请输入格式为HH:mm或HH的时间。
+    if (etime != ""){
+        if (!regex.Matches(etime)) {
+            wxMessageBox(_("The end time format is incorrect.\nIt should be in the format of HH:mm:ss, HH:mm or HH."), _("Error"), wxICON_ERROR);
+            etimeBox_->SetFocus();
+            return false;
+        }
+        etimesec = StockData::timeStringToSeconds(etime);
+    }
+
+    //开始时间不能晚于结束时间
+    if (stimesec > etimesec && etimesec > -1) {
+        wxMessageBox(_("Start time cannot be later than end time."), _("Error"), wxICON_ERROR);
+        etimeBox_->SetFocus();
+        return false;
+    }
+    return true;
+}
+
+void MainWindow::OnGetData() {
+
+    std::string stockCode = stockCombo_->GetValue().ToStdString();
+    int stimesec = -1, etimesec = -1;
+
+    // 股票代码不能为空
+    if (stockCode.empty()) {
+        wxMessageBox(_("Please enter a stock code"), _("Error"), wxICON_ERROR);
+        stockCombo_->SetFocus();
+        return;
+    }
+
+    if (!GetTimeSpan(stimesec, etimesec)) {
+        return;
+    }
+
+    RunQuery(stockCode, [=](QueryMetrics* metrics) {
+        TickColumns data = StockData::queryStockData(stockCode, stimesec, etimesec, metrics);
+        Config::getInstance().saveConfig(stockCode);
+        return data;
+    });
+}
+
+// 导入本地成交明细文件
+void MainWindow::OnImport(wxCommandEvent& event) {
+    int stimesec = -1, etimesec = -1;
+    if (!GetTimeSpan(stimesec, etimesec)) {
+        return;
+    }
+
+    wxFileDialog dialog(this, _("Import Tick File"), "", "",
+        _("Tick files (*.csv;*.txt;*.tka)|*.csv;*.txt;*.tka|All files (*.*)|*.*"), wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+    if (dialog.ShowModal() != wxID_OK) {
+        return;
+    }
+
+    const std::string path(dialog.GetPath().utf8_str());
+    const std::string name = wxFileName(dialog.GetPath()).GetName().ToStdString();
+    RunQuery(name, [=](QueryMetrics* metrics) {
+        return StockData::importStockData(path, stimesec, etimesec, metrics);
+    });
+}
+
+// 从历史记录中选择多只股票，并行查询后显示对比表
+void MainWindow::OnCompare(wxCommandEvent& event) {
+    const auto& history = Config::getInstance().getStockHistory();
+    wxArrayString choices;
+    for (const auto& item : history) {
+        choices.Add(item);
+    }
+    wxMultiChoiceDialog dialog(this, _("Select the stocks to compare:"), _("Compare Stocks"), choices);
+    if (dialog.ShowModal() != wxID_OK) {
+        return;
+    }
+    const wxArrayInt selections = dialog.GetSelections();
+    if (selections.size() < 2) {
+        wxMessageBox(_("Please select at least two stocks"), _("Information"), wxICON_INFORMATION);
+        return;
+    }
+    std::vector<std::string> stockCodes;
+    for (int index : selections) {
+        stockCodes.push_back(history[index]);
+    }
+
+    int stimesec = -1, etimesec = -1;
+    if (!GetTimeSpan(stimesec, etimesec)) {
+        return;
+    }
+
+    actionButton_->Disable();
+    importButton_->Disable();
+    compareButton_->Disable();
+    actionButton_->SetLabel(_("Querying..."));
+
+    std::thread([=]() {
+        StopWatch watch;
+        const std::vector<ComparisonEntry> entries = StockData::compareStocks(stockCodes, stimesec, etimesec);
+        const int64_t elapsedUs = watch.elapsedUs();
+
+        wxTheApp->CallAfter([=]() {
+            actionButton_->Enable();
+            importButton_->Enable();
+            compareButton_->Enable();
+            actionButton_->SetLabel(_("Get Data"));
+            CompareWindow* window = new CompareWindow(this, entries, elapsedUs);
+            window->Show();
+        });
+    }).detach();
+}
+
+// 选择股票代码列表文件，在单独的窗口中扫描并显示排名
+void MainWindow::OnScan(wxCommandEvent& event) {
+    int stimesec = -1, etimesec = -1;
+    if (!GetTimeSpan(stimesec, etimesec)) {
+        return;
+    }
+
+    wxFileDialog dialog(this, _("Select Stock List"), "", "",
+        _("Stock lists (*.txt;*.csv)|*.txt;*.csv|All files (*.*)|*.*"), wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+    if (dialog.ShowModal() != wxID_OK) {
+        return;
+    }
+
+    const Config& config = Config::getInstance();
+    ScanOptions options;
+    options.listFile = std::string(dialog.GetPath().utf8_str());
+    options.stimesec = stimesec;
+    options.etimesec = etimesec;
+    options.topN = config.getScanTopN();
+    options.requestBudget = config.getScanRequestBudget();
+    options.largeAmount = config.getScanLargeAmount();
+    options.spikeWindow = config.getScanSpikeWindow();
+    ScanWindow* window = new ScanWindow(this, options);
+    window->Show();
+}
+
+// 选择股票代码列表文件，后台查询各股票并计算相关系数矩阵
+void MainWindow::OnCorrelate(wxCommandEvent& event) {
+    int stimesec = -1, etimesec = -1;
+    if (!GetTimeSpan(stimesec, etimesec)) {
+        return;
+    }
+
+    wxFileDialog dialog(this, _("Select Stock List"), "", "",
+        _("Stock lists (*.txt;*.csv)|*.txt;*.csv|All files (*.*)|*.*"), wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+    if (dialog.ShowModal() != wxID_OK) {
+        return;
+    }
+    std::vector<std::string> stockCodes;
+    try {
+        for (const auto& item : MarketScanner::loadCodeList(std::string(dialog.GetPath().utf8_str()))) {
+            stockCodes.push_back(item.first);
+        }
+    }
+    catch (const std::exception& e) {
+        wxMessageBox(e.what(), _("Error"), wxICON_ERROR);
+        return;
+    }
+    if (stockCodes.size() < 2) {
+        wxMessageBox(_("Please select at least two stocks"), _("Information"), wxICON_INFORMATION);
+        return;
+    }
+
+    correlateButton_->Disable();
+    std::thread([=]() {
+        if (Trace::enabled()) {
+            Trace::setThreadName("Correlation");
+        }
+        bool succeed = false;
+        CorrelationResult result;
+        try {
+            result = Correlation::analyze(stockCodes, stimesec, etimesec);
+            succeed = true;
+        }
+        catch (const std::exception& e) {
+            wxMessageBox(e.what(), "Error", wxICON_ERROR);
+        }
+        catch (const std::string& s) {
+            wxMessageBox(s, _("Information"), wxICON_INFORMATION);
+        }
+
+        wxTheApp->CallAfter([=]() {
+            correlateButton_->Enable();
+            if (succeed) {
+                CorrelationWindow* window = new CorrelationWindow(this, result);
+                window->Show();
+            }
+        });
+    }).detach();
+}
+
+// 在后台线程执行查询，完成后在主线程显示结果窗口
+void MainWindow::RunQuery(const std::string& stockCode, std::function<TickColumns(QueryMetrics*)> query) {
+    actionButton_->Disable();
+    importButton_->Disable();
+    compareButton_->Disable();
+    actionButton_->SetLabel(_("Querying..."));
+    
+    // 使用 std::thread 启动异步任务
+    std::thread([=]() {
+        if (Trace::enabled()) {
+            Trace::setThreadName("Query " + stockCode);
+        }
+
+        bool succeed = false;
+        std::shared_ptr<const TickColumns> data;
+        QueryMetrics metrics;
+        try
+        {
+            data = std::make_shared<TickColumns>(query(&metrics));
+            succeed = true;
+        }
+        catch (const std::exception& e) {
+            wxMessageBox(e.what(), "Error", wxICON_ERROR);
+        }
+        catch (const std::string& s) {
+            wxMessageBox(s, _("Information"), wxICON_INFORMATION);
+        }
+
+        // 回到主线程更新 UI
+        wxTheApp->CallAfter([=]() {
+            actionButton_->Enable();
+            importButton_->Enable();
+            compareButton_->Enable();
+            // 有页面失败时，再次查询只请求缺少的页
+            actionButton_->SetLabel(succeed && !metrics.missingPages.empty() ? _("Resume") : _("Get Data"));
+            if (succeed){
+                UpdateStockComboBox(Config::getInstance().getStockHistory());
+                ResultWindow* rWindow = new ResultWindow(this, wxString::Format(_("Stock Code: %s"), stockCode));
+                rWindow->ShowResult(stockCode, data, metrics);
+            }
+        });
+
+    }).detach(); // 分离线程
+}
+
+// 从历史记录中选择要盯盘的股票，在单独的窗口中显示触发的提醒
+void MainWindow::OnLive(wxCommandEvent& event) {
+    const auto& history = Config::getInstance().getStockHistory();
+    wxArrayString choices;
+    for (const auto& item : history) {
+        choices.Add(item);
+    }
+    wxMultiChoiceDialog dialog(this, _("Select the stocks to watch:"), _("Live Alerts"), choices);
+    if (dialog.ShowModal() != wxID_OK) {
+        return;
+    }
+    std::vector<std::string> stockCodes;
+    for (int index : dialog.GetSelections()) {
+        stockCodes.push_back(history[index]);
+    }
+    if (stockCodes.empty()) {
+        return;
+    }
+    LiveWindow* window = new LiveWindow(this, stockCodes);
+    window->Show();
+}
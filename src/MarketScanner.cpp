@@ -0,0 +1,411 @@
+#include "Common.h"
+#include "Config.h"
+#include "MarketScanner.h"
+#include "SymbolMetadata.h"
+#include "TextTable.h"
+#include "TickArchive.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+namespace {
+    // 每完成这么多只股票保存一次进度
+    const size_t SAVE_EVERY = 25;
+    // 进度回调的最小间隔
+    const auto PROGRESS_INTERVAL = std::chrono::milliseconds(500);
+
+    nlohmann::json scoreToJson(const ScanScore& score) {
+        return { { "code", score.stockCode }, { "buy", score.buyAmount }, { "sell", score.sellAmount },
+            { "large", score.largeTrades }, { "spike", score.volumeSpike }, { "spike_time", score.spikeTime } };
+    }
+
+    ScanScore scoreFromJson(const nlohmann::json& j) {
+        ScanScore score;
+        score.stockCode = j.value("code", "");
+        score.buyAmount = j.value("buy", 0.0);
+        score.sellAmount = j.value("sell", 0.0);
+        score.largeTrades = j.value("large", 0);
+        score.volumeSpike = j.value("spike", 0.0);
+        score.spikeTime = j.value("spike_time", -1);
+        return score;
+    }
+
+    // 本地归档中最近一个交易日的成交额，没有归档时为 0
+    double archivedAmount(const std::string& symbol) {
+        const std::string path = TickArchive::getArchiveFile(symbol);
+        if (!TickArchive::exists(path)) return 0.0;
+        try {
+            TickArchive archive(path);
+            const auto& blocks = archive.blocks();
+            return blocks.empty() ? 0.0 : blocks.back().amount;
+        }
+        catch (const std::exception&) {
+            return 0.0;
+        }
+    }
+}
+
+double ScanScore::imbalance() const {
+    const double total = buyAmount + sellAmount;
+    return total > 0 ? (buyAmount - sellAmount) / total : 0.0;
+}
+
+double ScanScore::value(ScanCriterion criterion) const {
+    switch (criterion) {
+    case SCAN_IMBALANCE: return std::fabs(buyAmount - sellAmount);
+    case SCAN_LARGE_TRADES: return largeTrades;
+    case SCAN_VOLUME_SPIKE: return volumeSpike;
+    default: return 0.0;
+    }
+}
+
+TopN::TopN(ScanCriterion criterion, size_t capacity)
+    : criterion_(criterion), capacity_((std::max)(capacity, static_cast<size_t>(1))) {
+    heap_.reserve(capacity_ + 1);
+}
+
+// 得分相同时按代码排序，使结果与完成顺序无关
+bool TopN::greater(const ScanScore& a, const ScanScore& b) const {
+    const double va = a.value(criterion_);
+    const double vb = b.value(criterion_);
+    return va != vb ? va > vb : a.stockCode < b.stockCode;
+}
+
+// 堆顶是当前第 N 名，新的得分只有超过它才替换
+void TopN::push(const ScanScore& score) {
+    auto cmp = [this](const ScanScore& a, const ScanScore& b) { return greater(a, b); };
+    if (heap_.size() < capacity_) {
+        heap_.push_back(score);
+        std::push_heap(heap_.begin(), heap_.end(), cmp);
+    }
+    else if (greater(score, heap_.front())) {
+        std::pop_heap(heap_.begin(), heap_.end(), cmp);
+        heap_.back() = score;
+        std::push_heap(heap_.begin(), heap_.end(), cmp);
+    }
+}
+
+std::vector<ScanScore> TopN::sorted() const {
+    std::vector<ScanScore> result = heap_;
+    std::sort(result.begin(), result.end(), [this](const ScanScore& a, const ScanScore& b) { return greater(a, b); });
+    return result;
+}
+
+MarketScanner::MarketScanner(const ScanOptions& options)
+    : options_(options),
+      stateFile_(Config::getInstance().getProgramDir() + "/market_scan.json"),
+      budget_(options.requestBudget),
+      leaders_{ TopN(SCAN_IMBALANCE, options.topN), TopN(SCAN_LARGE_TRADES, options.topN), TopN(SCAN_VOLUME_SPIKE, options.topN) } {
+}
+
+std::vector<std::pair<std::string, double>> MarketScanner::loadCodeList(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(wxString::Format(_("Failed to open file: %s"), wxString::FromUTF8(path.c_str())).ToStdString());
+    }
+
+    // 代码与流动性之间可以用逗号、制表符或空格分隔
+    std::vector<std::pair<std::string, double>> codes;
+    std::set<std::string> seen;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::replace(line.begin(), line.end(), '\t', ' ');
+        std::istringstream iss(line);
+        std::string code;
+        double liquidity = 0.0;
+        if (!(iss >> code) || code[0] == '#') continue;
+        if (!(iss >> liquidity)) liquidity = 0.0;
+        if (seen.insert(toLowerCase(code)).second) {
+            codes.emplace_back(code, liquidity);
+        }
+    }
+    return codes;
+}
+
+// 一次遍历统计买卖金额和大单，成交量按时间窗口滑动求和：
+// 放大倍数 = 任一 spikeWindow 秒内的最大成交量 / 有成交的各窗口的平均成交量，午间休市不计入平均
+ScanScore MarketScanner::score(const std::string& stockCode, const TickColumns& data, double largeAmount, int spikeWindow) {
+    ScanScore score;
+    score.stockCode = stockCode;
+    const size_t n = data.size();
+    double totalVolume = 0.0;
+    double windowVolume = 0.0;
+    double peakVolume = 0.0;
+    size_t activeWindows = 0;
+    int lastWindow = INT32_MIN;
+    size_t head = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double amount = data.amount[i];
+        const int8_t side = data.side[i];
+        if (side == SIDE_BUY) score.buyAmount += amount;
+        else if (side == SIDE_SELL) score.sellAmount += amount;
+        if (side != SIDE_NEUTRAL && amount >= largeAmount) score.largeTrades++;
+
+        const int32_t time = data.time[i];
+        totalVolume += data.volume[i];
+        windowVolume += data.volume[i];
+        while (data.time[head] <= time - spikeWindow) {
+            windowVolume -= data.volume[head++];
+        }
+        if (windowVolume > peakVolume) {
+            peakVolume = windowVolume;
+            score.spikeTime = data.time[head];
+        }
+        if (time / spikeWindow != lastWindow) {
+            lastWindow = time / spikeWindow;
+            activeWindows++;
+        }
+    }
+    if (activeWindows >= 2 && totalVolume > 0) {
+        score.volumeSpike = peakVolume / (totalVolume / activeWindows);
+    }
+    else {
+        score.spikeTime = -1;
+    }
+    return score;
+}
+
+std::string MarketScanner::stateKey() const {
+    std::ostringstream key;
+    key << options_.listFile << '|' << TickArchive::currentTradingDate() << '|' << options_.stimesec << '|' << options_.etimesec
+        << '|' << options_.largeAmount << '|' << options_.spikeWindow;
+    return key.str();
+}
+
+// 同一次扫描的进度才恢复，流动性记录总是保留
+void MarketScanner::loadState() {
+    std::ifstream file(stateFile_);
+    if (!file.is_open()) return;
+    try {
+        nlohmann::json j;
+        file >> j;
+        liquidity_ = j.value("liquidity", std::map<std::string, double>());
+        if (j.value("key", "") != stateKey() || j.value("finished", false)) return;
+        for (const auto& code : j.value("done", std::vector<std::string>())) {
+            done_.insert(code);
+        }
+        const nlohmann::json leaders = j.value("leaders", nlohmann::json::array());
+        for (size_t c = 0; c < leaders.size() && c < leaders_.size(); ++c) {
+            for (const auto& item : leaders[c]) {
+                leaders_[c].push(scoreFromJson(item));
+            }
+        }
+    }
+    catch (...) {
+        done_.clear();
+        leaders_ = { TopN(SCAN_IMBALANCE, options_.topN), TopN(SCAN_LARGE_TRADES, options_.topN), TopN(SCAN_VOLUME_SPIKE, options_.topN) };
+    }
+}
+
+// 调用方已持有锁
+void MarketScanner::saveState() {
+    nlohmann::json leaders = nlohmann::json::array();
+    for (const auto& top : leaders_) {
+        nlohmann::json items = nlohmann::json::array();
+        for (const auto& score : top.items()) {
+            items.push_back(scoreToJson(score));
+        }
+        leaders.push_back(items);
+    }
+    nlohmann::json j = {
+        { "key", stateKey() },
+        { "finished", queue_.empty() && !stopped_ && !budgetExhausted_ },
+        { "done", done_ },
+        { "leaders", leaders },
+        { "liquidity", liquidity_ },
+    };
+
+    // 先写临时文件再替换，中断时不会留下损坏的进度
+    const std::string temp = stateFile_ + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        if (!file.is_open()) return;
+        file << j.dump();
+        file.close();
+        if (!file) return;
+    }
+    // 直接覆盖目标文件，不先删除，任何时刻磁盘上都有一份完整的进度
+    std::error_code error;
+    std::filesystem::rename(temp, stateFile_, error);
+}
+
+// 调用方已持有锁
+ScanProgress MarketScanner::snapshot(bool finished) {
+    ScanProgress progress;
+    progress.total = total_;
+    progress.done = done_.size();
+    progress.failed = failed_;
+    progress.requests = budget_.used();
+    progress.requestBudget = options_.requestBudget;
+    progress.finished = finished;
+    progress.budgetExhausted = budgetExhausted_;
+    for (size_t c = 0; c < leaders_.size(); ++c) {
+        progress.leaders[c] = leaders_[c].sorted();
+    }
+    return progress;
+}
+
+void MarketScanner::run(const std::function<void(const ScanProgress&)>& onProgress) {
+    TRACE_SCOPE("MarketScanner::run");
+    const std::vector<std::pair<std::string, double>> codes = loadCodeList(options_.listFile);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loadState();
+        total_ = codes.size();
+        // 优先级：列表给出的流动性 > 上次扫描的成交额 > 本地归档最近一日的成交额
+        for (size_t i = 0; i < codes.size(); ++i) {
+            const std::string key = toLowerCase(codes[i].first);
+            if (done_.count(key)) continue;
+            double liquidity = codes[i].second;
+            if (liquidity <= 0) {
+                auto it = liquidity_.find(key);
+                liquidity = (it != liquidity_.end()) ? it->second : archivedAmount(StockData::getStockSymbol(key));
+            }
+            queue_.push(Task{ liquidity, i, codes[i].first });
+        }
+    }
+
+    // 每只股票都会更新分页表，扫描期间只在结束时写一次元数据文件
+    SymbolMetadata::getInstance().beginBatch();
+    auto lastProgress = std::chrono::steady_clock::now();
+    size_t sinceSave = 0;
+    auto worker = [&]() {
+        RequestBudget::Scope scope(&budget_);
+        for (;;) {
+            Task task;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stopped_ || queue_.empty()) return;
+                if (budget_.exhausted()) {
+                    budgetExhausted_ = true;
+                    return;
+                }
+                task = queue_.top();
+                queue_.pop();
+            }
+
+            QueryMetrics metrics;
+            bool scored = false, failed = false;
+            ScanScore result;
+            try {
+                const TickColumns data = StockData::queryStockData(task.stockCode, options_.stimesec, options_.etimesec, &metrics);
+                result = score(task.stockCode, data, options_.largeAmount, options_.spikeWindow);
+                scored = true;
+            }
+            catch (const RequestBudgetExceeded&) {
+                // 没有完成的股票不记为完成也不算失败，继续扫描时重新查询
+                budgetExhausted_ = true;
+                return;
+            }
+            catch (const std::exception&) {
+                failed = true;
+            }
+            catch (const std::string&) {
+                // 停牌或时间范围内没有成交
+            }
+
+            ScanProgress progress;
+            bool report = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                // 失败的股票不记为完成，继续扫描时重新查询
+                if (failed) {
+                    failed_++;
+                }
+                else {
+                    const std::string key = toLowerCase(task.stockCode);
+                    done_.insert(key);
+                    if (scored) {
+                        for (auto& top : leaders_) {
+                            top.push(result);
+                        }
+                        liquidity_[key] = result.buyAmount + result.sellAmount;
+                    }
+                }
+                if (++sinceSave >= SAVE_EVERY) {
+                    sinceSave = 0;
+                    saveState();
+                }
+                const auto now = std::chrono::steady_clock::now();
+                if (now - lastProgress >= PROGRESS_INTERVAL) {
+                    lastProgress = now;
+                    progress = snapshot(false);
+                    report = true;
+                }
+            }
+            Metrics::getInstance().counter(failed ? "scan.failed" : "scan.symbols")++;
+            if (report && onProgress) {
+                onProgress(progress);
+            }
+        }
+    };
+
+    const size_t workers = (std::max)(Config::getInstance().getMaxConcurrency(), static_cast<size_t>(1));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back([&, i]() {
+            if (Trace::enabled()) {
+                Trace::setThreadName("Scan #" + std::to_string(i));
+            }
+            worker();
+        });
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    SymbolMetadata::getInstance().endBatch();
+
+    ScanProgress progress;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        saveState();
+        progress = snapshot(true);
+    }
+    if (onProgress) {
+        onProgress(progress);
+    }
+}
+
+// 按指定依据排列的排名表，各列都显示以便对照
+wxString MarketScanner::formatLeaders(const ScanProgress& progress, ScanCriterion criterion) {
+    TextTable table;
+    const std::vector<ScanScore>& leaders = progress.leaders[criterion];
+    table.reserve(leaders.size() + 1, 8 * (leaders.size() + 1));
+    auto utf8 = [](const wxString& text) { return std::string(text.utf8_str()); };
+
+    const int language = Config::getInstance().getLanguage();
+    const wxLanguageInfo* languageInfo = wxLocale::GetLanguageInfo(language);
+    wxString localeName = languageInfo->GetLocaleName();
+    const std::string symbol = utf8(localeName.StartsWith("zh") ? _("E4") : _("kilo"));
+    int human = localeName.StartsWith("zh") ? 10000 : 1000;
+
+    const wxString headers[] = { _("Rank"), _("Stock Code"), _("Buy Amounts"), _("Sell Amounts"), _("Imbalance"),
+        _("Large Trades"), _("Volume Spike"), _("Spike Time") };
+    table.beginRow();
+    for (const wxString& header : headers) {
+        table.addText(utf8(header));
+    }
+    for (size_t i = 0; i < leaders.size(); ++i) {
+        const ScanScore& s = leaders[i];
+        table.beginRow();
+        table.addInteger(static_cast<long long>(i + 1));
+        table.addText(s.stockCode);
+        table.addNumber(s.buyAmount / human, 2, symbol);
+        table.addNumber(s.sellAmount / human, 2, symbol);
+        table.addNumber(s.imbalance() * 100, 2, "%");
+        table.addInteger(s.largeTrades);
+        table.addNumber(s.volumeSpike, 2, "x");
+        table.addText(s.spikeTime >= 0 ? StockData::secondsToTimeString(s.spikeTime) : "-");
+    }
+    const std::string text = table.render();
+    return wxString::FromUTF8(text.data(), text.size());
+}
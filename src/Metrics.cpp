@@ -0,0 +1,335 @@
+#include "Common.h"
+#include "Config.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+
+// 指标文件最多每隔这么久写一次
+static const std::chrono::seconds FLUSH_INTERVAL(5);
+
+// 微秒转成便于阅读的时长
+wxString formatDuration(int64_t us) {
+    if (us < 1000) {
+        return wxString::Format("%lldus", static_cast<long long>(us));
+    }
+    if (us < 1000 * 1000) {
+        return wxString::Format("%.1fms", us / 1000.0);
+    }
+    return wxString::Format("%.2fs", us / 1000000.0);
+}
+
+// 字节数转成便于阅读的大小
+static wxString formatBytes(size_t bytes) {
+    if (bytes < 1024) {
+        return wxString::Format("%lluB", static_cast<unsigned long long>(bytes));
+    }
+    if (bytes < 1024 * 1024) {
+        return wxString::Format("%.1fKB", bytes / 1024.0);
+    }
+    return wxString::Format("%.2fMB", bytes / (1024.0 * 1024.0));
+}
+
+size_t QueryMetrics::totalBytes() const {
+    size_t bytes = pagesRequest.bytes;
+    for (const auto& page : pages) {
+        bytes += page.bytes;
+    }
+    return bytes;
+}
+
+size_t QueryMetrics::totalTicks() const {
+    size_t ticks = 0;
+    for (const auto& page : pages) {
+        ticks += page.ticks;
+    }
+    return ticks;
+}
+
+// 生成在结果窗口状态栏显示的简要信息
+wxString QueryMetrics::summary() const {
+    int64_t dnsUs = pagesRequest.dnsUs, connectUs = pagesRequest.connectUs, tlsUs = pagesRequest.tlsUs;
+    int64_t parseUs = 0;
+    for (const auto& page : pages) {
+        dnsUs += page.dnsUs;
+        connectUs += page.connectUs;
+        tlsUs += page.tlsUs;
+        parseUs += page.parseUs;
+    }
+
+    wxString text = wxString::Format(_("%d pages, %s, %llu ticks | fetch %s (dns %s, tcp %s, tls %s) | parse %s | analyze %s | format %s"),
+        static_cast<int>(pages.size()), formatBytes(totalBytes()), static_cast<unsigned long long>(totalTicks()),
+        formatDuration(fetchUs), formatDuration(dnsUs), formatDuration(connectUs), formatDuration(tlsUs),
+        formatDuration(parseUs), formatDuration(aggregateUs), formatDuration(formatUs));
+    if (!plan.empty()) {
+        text += " | " + plan;
+    }
+    if (sharedPages > 0) {
+        text += wxString::Format(_(" | %d pages shared with concurrent queries"), static_cast<int>(sharedPages));
+    }
+    int hedged = 0, hedgeWins = 0;
+    for (const auto& page : pages) {
+        hedged += page.hedged;
+        hedgeWins += page.hedgeWon;
+    }
+    if (hedged > 0) {
+        text += wxString::Format(_(" | %d pages hedged, %d hedges won"), hedged, hedgeWins);
+    }
+    if (!missingPages.empty()) {
+        text += wxString::Format(_(" | %d pages missing, click Resume to fetch them"), static_cast<int>(missingPages.size()));
+    }
+    return text;
+}
+
+// 计算数值所在的桶：小于 32 的值各占一格，之后每个 2 的幂区间等分 32 格
+int Histogram::bucketIndex(uint64_t value) {
+    const uint64_t limit = (uint64_t(1) << MAX_BITS) - 1;
+    value = (std::min)(value, limit);
+    if (value < SUB_COUNT) {
+        return static_cast<int>(value);
+    }
+
+    int msb = SUB_BITS;
+    while (value >> (msb + 1)) {
+        msb++;
+    }
+    const int octave = msb - SUB_BITS + 1;
+    const int sub = static_cast<int>(value >> (msb - SUB_BITS)) - SUB_COUNT;
+    return octave * SUB_COUNT + sub;
+}
+
+// 桶的上界（包含）
+uint64_t Histogram::bucketUpper(int index) {
+    const int octave = index / SUB_COUNT;
+    const int sub = index % SUB_COUNT;
+    if (octave == 0) {
+        return sub;
+    }
+    const int shift = octave - 1;
+    const uint64_t lower = static_cast<uint64_t>(SUB_COUNT + sub) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+    counts_[bucketIndex(value)]++;
+    count_++;
+    sum_ += value;
+    min_ = (std::min)(min_, value);
+    max_ = (std::max)(max_, value);
+}
+
+void Histogram::merge(const Histogram& other) {
+    if (other.count_ == 0) return;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = (std::min)(min_, other.min_);
+    max_ = (std::max)(max_, other.max_);
+}
+
+void Histogram::reset() {
+    counts_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+// 返回第 p 百分位所在桶的上界，不超过实际最大值
+uint64_t Histogram::percentile(double p) const {
+    if (count_ == 0) return 0;
+
+    const uint64_t rank = (std::max)(uint64_t(1), static_cast<uint64_t>(std::ceil(p / 100.0 * count_)));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return (std::min)(bucketUpper(i), max_);
+        }
+    }
+    return max_;
+}
+
+static int64_t currentEpoch(int slotSeconds) {
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::seconds>(now).count() / slotSeconds;
+}
+
+// 进入新的时间片时清空该片的旧数据
+void RollingHistogram::rotate(int64_t epoch) {
+    const int slot = static_cast<int>(epoch % SLOT_COUNT);
+    if (epochs_[slot] != epoch) {
+        slots_[slot].reset();
+        epochs_[slot] = epoch;
+    }
+}
+
+void RollingHistogram::record(uint64_t value) {
+    const int64_t epoch = currentEpoch(SLOT_SECONDS);
+    std::lock_guard<std::mutex> lock(mutex_);
+    rotate(epoch);
+    slots_[epoch % SLOT_COUNT].record(value);
+}
+
+// 合并窗口内仍然有效的时间片
+Histogram RollingHistogram::snapshot() const {
+    const int64_t epoch = currentEpoch(SLOT_SECONDS);
+    Histogram result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        if (epochs_[i] > epoch - SLOT_COUNT) {
+            result.merge(slots_[i]);
+        }
+    }
+    return result;
+}
+
+Metrics& Metrics::getInstance() {
+    static Metrics instance;
+    return instance;
+}
+
+RollingHistogram& Metrics::histogram(const std::string& name, const std::string& unit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[name];
+    if (!entry) {
+        entry = std::make_unique<Entry>();
+        entry->unit = unit;
+    }
+    return entry->histogram;
+}
+
+std::atomic<uint64_t>& Metrics::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = counters_[name];
+    if (!entry) {
+        entry = std::make_unique<std::atomic<uint64_t>>(0);
+    }
+    return *entry;
+}
+
+// 记录一次查询的各阶段数据，指标文件稍后由后台线程写入
+void Metrics::record(const QueryMetrics& metrics) {
+    auto recordPage = [this](const std::string& prefix, const PageTiming& page) {
+        histogram(prefix + ".dns").record(page.dnsUs);
+        histogram(prefix + ".connect").record(page.connectUs);
+        histogram(prefix + ".tls").record(page.tlsUs);
+        histogram(prefix + ".transfer").record(page.transferUs);
+        histogram(prefix + ".total").record(page.totalUs);
+        histogram(prefix + ".bytes", "bytes").record(page.bytes);
+    };
+
+    recordPage("pages_request", metrics.pagesRequest);
+    for (const auto& page : metrics.pages) {
+        recordPage("page", page);
+        histogram("page.parse").record(page.parseUs);
+        histogram("page.ticks", "ticks").record(page.ticks);
+    }
+
+    histogram("query.fetch").record(metrics.fetchUs);
+    histogram("query.aggregate").record(metrics.aggregateUs);
+    histogram("query.format").record(metrics.formatUs);
+    histogram("query.bytes", "bytes").record(metrics.totalBytes());
+    histogram("query.ticks", "ticks").record(metrics.totalTicks());
+
+    scheduleFlush();
+}
+
+// 第一次记录时启动写入线程
+void Metrics::scheduleFlush() {
+    std::lock_guard<std::mutex> lock(flushMutex_);
+    dirty_ = true;
+    if (!stopping_ && !flusher_.joinable()) {
+        flusher_ = std::thread(&Metrics::flushLoop, this);
+    }
+}
+
+void Metrics::flushLoop() {
+    if (Trace::enabled()) {
+        Trace::setThreadName("Metrics");
+    }
+    std::unique_lock<std::mutex> lock(flushMutex_);
+    while (!stopping_) {
+        flushCondition_.wait_for(lock, FLUSH_INTERVAL, [this]() { return stopping_; });
+        if (!dirty_ || stopping_) continue;
+        dirty_ = false;
+        lock.unlock();
+        dump(getMetricsFile());
+        lock.lock();
+    }
+}
+
+void Metrics::flush() {
+    {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        stopping_ = true;
+    }
+    flushCondition_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    std::lock_guard<std::mutex> lock(flushMutex_);
+    if (dirty_) {
+        dirty_ = false;
+        dump(getMetricsFile());
+    }
+}
+
+// 正常退出时已经调用过 flush；这里只保证线程不会在对象销毁后运行
+Metrics::~Metrics() {
+    {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        stopping_ = true;
+    }
+    flushCondition_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+}
+
+// 将所有直方图的快照写入文本文件
+bool Metrics::dump(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    // 由后台线程写入，使用线程安全的版本
+    const std::time_t now = std::time(nullptr);
+    std::tm local;
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    file << "# StockAnalyzer metrics " << std::put_time(&local, "%Y-%m-%d %H:%M:%S")
+        << ", window " << RollingHistogram::SLOT_COUNT * RollingHistogram::SLOT_SECONDS / 60 << " min\n";
+    file << std::left << std::setw(24) << "# metric" << std::setw(7) << "unit" << std::right
+        << std::setw(10) << "count" << std::setw(12) << "min" << std::setw(12) << "p50"
+        << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "max"
+        << std::setw(14) << "mean" << "\n";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [name, entry] : entries_) {
+        const Histogram h = entry->histogram.snapshot();
+        file << std::left << std::setw(24) << name << std::setw(7) << entry->unit << std::right
+            << std::setw(10) << h.count() << std::setw(12) << h.min() << std::setw(12) << h.percentile(50)
+            << std::setw(12) << h.percentile(90) << std::setw(12) << h.percentile(99) << std::setw(12) << h.max()
+            << std::setw(14) << std::fixed << std::setprecision(1) << h.mean() << "\n";
+    }
+
+    if (!counters_.empty()) {
+        file << "\n" << std::left << std::setw(24) << "# counter" << std::right << std::setw(17) << "value" << "\n";
+        for (const auto& [name, value] : counters_) {
+            file << std::left << std::setw(24) << name << std::right << std::setw(17) << value->load() << "\n";
+        }
+    }
+    return true;
+}
+
+std::string Metrics::getMetricsFile() const {
+    return Config::getInstance().getProgramDir() + "/stock_metrics.txt";
+}
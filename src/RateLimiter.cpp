@@ -0,0 +1,81 @@
+#include "RateLimiter.h"
+#include "Trace.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+    thread_local RequestBudget* currentBudget = nullptr;
+}
+
+RateLimiter& RateLimiter::getInstance() {
+    static RateLimiter instance;
+    return instance;
+}
+
+void RateLimiter::configure(double ratePerSecond, double burst) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rate_ = (std::max)(ratePerSecond, 0.01);
+    burst_ = (std::max)(burst, 1.0);
+    tokens_ = (std::min)(tokens_, burst_);
+}
+
+// 调用方已持有锁
+void RateLimiter::refill(std::chrono::steady_clock::time_point now) {
+    const double elapsed = std::chrono::duration<double>(now - last_).count();
+    tokens_ = (std::min)(burst_, tokens_ + elapsed * rate_);
+    last_ = now;
+}
+
+void RateLimiter::acquire() {
+    TRACE_SCOPE("throttle");
+    std::unique_lock<std::mutex> lock(mutex_);
+    refill(std::chrono::steady_clock::now());
+    // 先扣除令牌再等待，排队的线程按到达顺序依次获得
+    tokens_ -= 1.0;
+    if (tokens_ >= 0.0) return;
+
+    const auto wait = std::chrono::duration<double>(-tokens_ / rate_);
+    lock.unlock();
+    std::this_thread::sleep_for(wait);
+}
+
+bool RateLimiter::tryAcquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refill(std::chrono::steady_clock::now());
+    if (tokens_ < 1.0) return false;
+    tokens_ -= 1.0;
+    return true;
+}
+
+bool RequestBudget::reserve() {
+    size_t used = used_.load(std::memory_order_relaxed);
+    do {
+        if (used >= limit_) {
+            exhausted_.store(true, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!used_.compare_exchange_weak(used, used + 1, std::memory_order_relaxed));
+    return true;
+}
+
+RequestBudget* RequestBudget::current() {
+    return currentBudget;
+}
+
+void RequestBudget::charge() {
+    if (!tryCharge()) {
+        throw RequestBudgetExceeded();
+    }
+}
+
+bool RequestBudget::tryCharge() {
+    return !currentBudget || currentBudget->reserve();
+}
+
+RequestBudget::Scope::Scope(RequestBudget* budget) : previous_(currentBudget) {
+    currentBudget = budget;
+}
+
+RequestBudget::Scope::~Scope() {
+    currentBudget = previous_;
+}
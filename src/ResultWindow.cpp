@@ -1,57 +1,117 @@
-#pragma once
-#include "ResultWindow.h"
-#include <StockData.h>
-
-ResultWindow::ResultWindow(wxWindow* parent, const wxString& title)
-    : wxDialog(parent, wxID_ANY, title, wxDefaultPosition, wxDefaultSize,
-        wxDEFAULT_FRAME_STYLE & ~(wxRESIZE_BORDER | wxMAXIMIZE_BOX)) {
-    wxIcon appIcon("IDI_APP_ICON", wxBITMAP_TYPE_ICO_RESOURCE);
-    SetIcon(appIcon);
-}
-
-void ResultWindow::analyzeData(const std::string& stockCode, const std::vector<TickData>& data) {
-    const wxString analyze = StockData::analyzeData(data);
-    wxPanel* panel = new wxPanel(this);
-    wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
-    wxBoxSizer* sizer = new wxBoxSizer(wxHORIZONTAL);
-    panel->SetSizer(mainSizer);
-
-    wxFont monoFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-
-    wxStaticText* staticCode = new wxStaticText(panel, wxID_ANY, wxString::Format(_("Stock Code: %s"), stockCode));
-    wxStaticText* staticStatus = new wxStaticText(panel, wxID_ANY, "");
-
-    sizer->Add(staticCode, 1, wxEXPAND | wxTOP | wxLEFT | wxRIGHT, 10);
-    sizer->Add(staticStatus, 1, wxEXPAND | wxTOP | wxLEFT | wxRIGHT, 10);
-    mainSizer->Add(sizer, 0, wxEXPAND | wxTOP | wxLEFT | wxRIGHT, 10);
-
-    wxStaticText* staticData = new wxStaticText(panel, wxID_ANY, analyze);
-    staticData->SetFont(monoFont);
-    mainSizer->Add(staticData, 1, wxEXPAND | wxALL, 20);
-
-
-    // ӦС
-    panel->Fit();
-    Fit();
-}
-
-void ResultWindow::ShowResult(const std::string& stockCode, const std::vector<TickData>& data) {
-    analyzeData(stockCode, data);
-    MessageBeep(MB_OK);
-    Show();
-}
-
-int ResultWindow::ShowModalResult(const std::string& stockCode, const std::vector<TickData>& data) {
-    analyzeData(stockCode, data);
-    MessageBeep(MB_OK);
-    return ShowModal();
-}
-
-// д ShowModalʱƳСť
-int ResultWindow::ShowModal() {
-    long style = GetWindowStyle();
-    SetWindowStyle(style & ~wxMINIMIZE_BOX);
-    int result = wxDialog::ShowModal();
-    SetWindowStyle(style);
-    return result;
+#pragma once
+#include "ResultWindow.h"
+#include <BaselinePanel.h>
+#include <ChartPanel.h>
+#include <Exporter.h>
+#include <FormulaPanel.h>
+#include <StockData.h>
+#include <TickGrid.h>
+#include <Trace.h>
+#include <wx/filedlg.h>
+#include <wx/notebook.h>
+
+ResultWindow::ResultWindow(wxWindow* parent, const wxString& title)
+    : wxDialog(parent, wxID_ANY, title, wxDefaultPosition, wxDefaultSize, wxDEFAULT_FRAME_STYLE) {
+    wxIcon appIcon("IDI_APP_ICON", wxBITMAP_TYPE_ICO_RESOURCE);
+    SetIcon(appIcon);
+}
+
+void ResultWindow::analyzeData(const std::string& stockCode, std::shared_ptr<const TickColumns> data, QueryMetrics metrics) {
+    TRACE_SCOPE("ResultWindow::analyzeData");
+    ticks_ = data;
+    result_ = StockData::analyzeData(stockCode, *ticks_, &metrics);
+    const wxString analyze = StockData::formatResult(result_, &metrics);
+    wxPanel* panel = new wxPanel(this);
+    wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
+    wxBoxSizer* sizer = new wxBoxSizer(wxHORIZONTAL);
+    panel->SetSizer(mainSizer);
+
+    wxFont monoFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+
+    wxStaticText* staticCode = new wxStaticText(panel, wxID_ANY, wxString::Format(_("Stock Code: %s"), stockCode));
+    wxStaticText* staticStatus = new wxStaticText(panel, wxID_ANY, "");
+    if (!metrics.pages.empty() || !metrics.plan.empty()) {
+        staticStatus->SetLabel(metrics.summary());
+        Metrics::getInstance().record(metrics);
+    }
+
+    sizer->Add(staticCode, 1, wxEXPAND | wxTOP | wxLEFT | wxRIGHT, 10);
+    sizer->Add(staticStatus, 1, wxEXPAND | wxTOP | wxLEFT | wxRIGHT, 10);
+
+    // 导出结构化结果
+    wxButton* exportButton = new wxButton(panel, wxID_ANY, _("Export..."));
+    exportButton->Bind(wxEVT_BUTTON, &ResultWindow::OnExport, this);
+    sizer->Add(exportButton, 0, wxTOP | wxLEFT | wxRIGHT, 10);
+    mainSizer->Add(sizer, 0, wxEXPAND | wxTOP | wxLEFT | wxRIGHT, 10);
+
+    // 汇总和成交明细分页显示
+    wxNotebook* notebook = new wxNotebook(panel, wxID_ANY);
+    wxPanel* summaryPage = new wxPanel(notebook);
+    wxBoxSizer* summarySizer = new wxBoxSizer(wxVERTICAL);
+    wxStaticText* staticData = new wxStaticText(summaryPage, wxID_ANY, analyze);
+    staticData->SetFont(monoFont);
+    summarySizer->Add(staticData, 1, wxEXPAND | wxALL, 10);
+    summaryPage->SetSizer(summarySizer);
+    notebook->AddPage(summaryPage, _("Summary"));
+    notebook->AddPage(new TickGrid(notebook, ticks_), _("Ticks"));
+    notebook->AddPage(new ChartPanel(notebook, ticks_, result_.spikes), _("Chart"));
+    notebook->AddPage(new FormulaPanel(notebook, ticks_), _("Formulas"));
+    notebook->AddPage(new BaselinePanel(notebook, stockCode, ticks_, result_.firstTime, result_.lastTime), _("Baseline"));
+    mainSizer->Add(notebook, 1, wxEXPAND | wxALL, 10);
+
+
+    // 自适应大小
+    {
+        TRACE_SCOPE("Fit");
+        panel->Fit();
+        Fit();
+    }
+}
+
+void ResultWindow::ShowResult(const std::string& stockCode, std::shared_ptr<const TickColumns> data, const QueryMetrics& metrics) {
+    analyzeData(stockCode, data, metrics);
+    MessageBeep(MB_OK);
+    {
+        TRACE_SCOPE("Show");
+        Show();
+    }
+    if (Trace::enabled()) {
+        Trace::write(Trace::getTraceFile());
+    }
+}
+
+int ResultWindow::ShowModalResult(const std::string& stockCode, std::shared_ptr<const TickColumns> data, const QueryMetrics& metrics) {
+    analyzeData(stockCode, data, metrics);
+    MessageBeep(MB_OK);
+    return ShowModal();
+}
+
+// 导出汇总和明细，格式由文件扩展名决定
+void ResultWindow::OnExport(wxCommandEvent& event) {
+    if (!ticks_ || result_.tickCount == 0) return;
+
+    wxFileDialog dialog(this, _("Export Analysis"), "", result_.stockCode,
+        "JSON (*.json)|*.json|CSV (*.csv)|*.csv|Arrow IPC (*.arrow)|*.arrow", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (dialog.ShowModal() != wxID_OK) return;
+
+    try {
+        const auto files = Exporter::exportResult(dialog.GetPath().ToStdString(), result_, *ticks_);
+        wxString message = _("Exported to:");
+        for (const auto& file : files) {
+            message += "\n" + wxString(file);
+        }
+        wxMessageBox(message, _("Information"), wxICON_INFORMATION);
+    }
+    catch (const std::exception& e) {
+        wxMessageBox(e.what(), _("Error"), wxICON_ERROR);
+    }
+}
+
+// 重写 ShowModal，临时移除最小化按钮
+int ResultWindow::ShowModal() {
+    long style = GetWindowStyle();
+    SetWindowStyle(style & ~wxMINIMIZE_BOX);
+    int result = wxDialog::ShowModal();
+    SetWindowStyle(style);
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "ScanWindow.h"
+#include "Trace.h"
+#include <thread>
+
+ScanWindow::ScanWindow(wxWindow* parent, const ScanOptions& options)
+    : wxFrame(parent, wxID_ANY, _("Market Scan"), wxDefaultPosition, wxSize(760, 560)),
+      options_(options), state_(std::make_shared<ScanState>()) {
+    wxIcon appIcon("IDI_APP_ICON", wxBITMAP_TYPE_ICO_RESOURCE);
+    SetIcon(appIcon);
+
+    wxPanel* panel = new wxPanel(this);
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    panel->SetSizer(sizer);
+
+    status_ = new wxStaticText(panel, wxID_ANY, "");
+    sizer->Add(status_, 0, wxEXPAND | wxTOP | wxLEFT | wxRIGHT, 10);
+
+    // 排名依据，顺序与 ScanCriterion 一致
+    wxBoxSizer* bar = new wxBoxSizer(wxHORIZONTAL);
+    const wxString criteria[SCAN_CRITERION_COUNT] = { _("Imbalance"), _("Large Trades"), _("Volume Spike") };
+    criterion_ = new wxChoice(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, SCAN_CRITERION_COUNT, criteria);
+    criterion_->SetSelection(SCAN_IMBALANCE);
+    stopButton_ = new wxButton(panel, wxID_ANY, _("Stop"));
+    bar->Add(new wxStaticText(panel, wxID_ANY, _("Rank by:")), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    bar->Add(criterion_, 0, wxRIGHT, 10);
+    bar->AddStretchSpacer();
+    bar->Add(stopButton_, 0);
+    sizer->Add(bar, 0, wxEXPAND | wxALL, 10);
+
+    wxFont monoFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    table_ = new wxTextCtrl(panel, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, wxTE_MULTILINE | wxTE_READONLY | wxTE_DONTWRAP);
+    table_->SetFont(monoFont);
+    sizer->Add(table_, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
+
+    criterion_->Bind(wxEVT_CHOICE, &ScanWindow::OnCriterion, this);
+    stopButton_->Bind(wxEVT_BUTTON, &ScanWindow::OnStop, this);
+
+    Start();
+}
+
+// 关闭窗口时停止扫描，进度由扫描线程保存
+ScanWindow::~ScanWindow() {
+    state_->alive = false;
+    if (scanner_) {
+        scanner_->stop();
+    }
+}
+
+// 每次开始都新建扫描器，从保存的进度继续
+void ScanWindow::Start() {
+    scanner_ = std::make_shared<MarketScanner>(options_);
+    running_ = true;
+    watch_ = StopWatch();
+    stopButton_->SetLabel(_("Stop"));
+    status_->SetLabel(_("Scanning..."));
+
+    std::shared_ptr<MarketScanner> scanner = scanner_;
+    std::shared_ptr<ScanState> state = state_;
+    std::thread([this, scanner, state]() {
+        if (Trace::enabled()) {
+            Trace::setThreadName("Scan");
+        }
+        auto deliver = [this, state](const ScanProgress& progress) {
+            wxTheApp->CallAfter([this, state, progress]() {
+                if (!state->alive) return;
+                progress_ = progress;
+                if (progress.finished) {
+                    running_ = false;
+                    stopButton_->SetLabel(_("Resume"));
+                    stopButton_->Enable(progress.done < progress.total);
+                }
+                ShowProgress();
+            });
+        };
+        try {
+            scanner->run(deliver);
+        }
+        catch (const std::exception& e) {
+            const std::string message = e.what();
+            wxTheApp->CallAfter([this, state, message]() {
+                if (!state->alive) return;
+                running_ = false;
+                stopButton_->SetLabel(_("Resume"));
+                wxMessageBox(wxString::FromUTF8(message), _("Error"), wxICON_ERROR);
+            });
+        }
+    }).detach();
+}
+
+void ScanWindow::ShowProgress() {
+    wxString status = wxString::Format(_("%d / %d scanned, %d failed, %d / %d requests, %s"),
+        static_cast<int>(progress_.done), static_cast<int>(progress_.total), static_cast<int>(progress_.failed),
+        static_cast<int>(progress_.requests), static_cast<int>(progress_.requestBudget), formatDuration(watch_.elapsedUs()));
+    if (progress_.budgetExhausted) {
+        status += _(" | request budget used up, click Resume to continue");
+    }
+    else if (progress_.finished && progress_.done >= progress_.total) {
+        status += _(" | finished");
+    }
+    status_->SetLabel(status);
+    table_->ChangeValue(MarketScanner::formatLeaders(progress_, static_cast<ScanCriterion>(criterion_->GetSelection())));
+}
+
+void ScanWindow::OnCriterion(wxCommandEvent& event) {
+    ShowProgress();
+}
+
+// 运行中点击停止；停止后点击从断点继续
+void ScanWindow::OnStop(wxCommandEvent& event) {
+    if (running_) {
+        scanner_->stop();
+        stopButton_->Disable();
+    }
+    else {
+        stopButton_->Enable();
+        Start();
+    }
+}
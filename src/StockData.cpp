@@ -1,502 +1,1009 @@
-#pragma once
-#include "Common.h"
-#include "Config.h"
-#include "StockData.h"
-#include <algorithm>
-#include <chrono>
-#include <curl/curl.h>
-#include <iomanip>
-#include <numeric>
-#include <sstream>
-#include <thread>
-#include <tuple>
-#include <wx/msgdlg.h>
-#include <wx/string.h>
-#include <wx/textctrl.h>
-#include <locale.h>
-#ifdef _WIN32
-#include <windows.h>
-#else
-#include <unistd.h>
-#endif
-
-// 配置参数
-const char* BASE_URL = "https://stock.gtimg.cn/data/index.php";
-const int MAX_PAGE = 100;
-const int SLEEP_TIME = 500; 
-
-// 统一股票代码
-std::string StockData::getStockSymbol(const std::string stockCode) {
-    int pos = stockCode.find('.');
-    std::string symbol = stockCode;
-    if (pos > 0) {
-        symbol = stockCode.substr(pos + 1);
-        symbol += stockCode.substr(0, pos);
-    }
-    return symbol;
-}
-
-// 分析数据
-wxString StockData::analyzeData(const std::vector<TickData>& data) {
-    if (data.empty()) {
-        wxMessageBox(_("No data available for analysis"), _("Information"), wxICON_INFORMATION);
-        return "";
-    }
-
-    // 分离买入和卖出订单，忽略中性订单
-    std::vector<TickData> buyOrders, sellOrders;
-    for (const auto& tick : data) {
-        if (tick.type == "Buy") {
-            buyOrders.push_back(tick);
-        }
-        else if (tick.type == "Sell") {
-            sellOrders.push_back(tick);
-        }
-    }
-
-    // 数量分析函数
-    auto analyzeVolume = [](const std::vector<TickData>& orders) {
-        if (orders.empty()) return std::make_tuple(0.0, 0.0, 0.0, 0.0);
-
-        double maxVolume = orders[0].volume;
-        double minVolume = orders[0].volume;
-        double sumVolume = 0.0;
-
-        for (const auto& order : orders) {
-            maxVolume = (std::max)(maxVolume, static_cast<double>(order.volume));
-            minVolume = (std::min)(minVolume, static_cast<double>(order.volume));
-            sumVolume += order.volume;
-        }
-
-        return std::make_tuple(sumVolume, maxVolume, minVolume, sumVolume / orders.size());
-    };
-
-    // 价格分析函数
-    auto analyzePrices = [](const std::vector<TickData>& orders) {
-        if (orders.empty()) return std::make_tuple(0.0, 0.0, 0.0);
-
-        double maxPrice = orders[0].price;
-        double minPrice = orders[0].price;
-        double sumPrice = 0.0;
-
-        for (const auto& order : orders) {
-            maxPrice = (std::max)(maxPrice, order.price);
-            minPrice = (std::min)(minPrice, order.price);
-            sumPrice += order.price;
-        }
-
-        return std::make_tuple(sumPrice, maxPrice, minPrice);
-    };
-
-    // 交易金额分析函数
-    auto analyzeAmount = [](const std::vector<TickData>& orders, const int sumVolume) {
-        if (orders.empty()) return std::make_tuple(0.0, 0.0, 0.0, 0.0, 0.0);
-
-        double onhand = orders[0].onehand();
-        double maxAmount = orders[0].amount;
-        double minAmount = orders[0].amount;
-        double sumAmount = 0.0;
-
-        for (const auto& order : orders) {
-            double amount = order.amount;
-            maxAmount = (std::max)(maxAmount, amount);
-            minAmount = (std::min)(minAmount, amount);
-            sumAmount += amount;
-        }
-
-        return std::make_tuple(sumAmount, maxAmount, minAmount, sumAmount / orders.size(), sumAmount / sumVolume / onhand);
-    };
-
-    // 分析买入和卖出订单
-    auto [buySumVolume, buyMaxVolume, buyMinVolume, buyAvgVolume] = analyzeVolume(buyOrders);
-    auto [buySumPrice, buyMaxPrice, buyMinPrice] = analyzePrices(buyOrders);
-    auto [buySumAmount, buyMaxAmount, buyMinAmount, buyAvgAmount, buyAvgPrice] = analyzeAmount(buyOrders, buySumVolume);
-
-
-    auto [sellSumVolume, sellMaxVolume, sellMinVolume, sellAvgVolume] = analyzeVolume(sellOrders);
-    auto [sellSumPrice, sellMaxPrice, sellMinPrice] = analyzePrices(sellOrders);
-    auto [sellSumAmount, sellMaxAmount, sellMinAmount, sellAvgAmount, sellAvgPrice] = analyzeAmount(sellOrders, sellSumVolume);
-
-    // 获取最近的买入和卖出订单
-    TickData lastBuy = buyOrders.empty() ? TickData{} : buyOrders.back();
-    TickData lastSell = sellOrders.empty() ? TickData{} : sellOrders.back();
-
-    // 生成表格
-    auto makeTable = [=]() {
-        // 设置输出精度为保留两位小数
-        std::stringstream ss;
-        ss << std::fixed << std::setprecision(2);
-
-        // 人类友好
-        const int language = Config::getInstance().getLanguage();
-         const wxLanguageInfo* languageInfo = wxLocale::GetLanguageInfo(language);
-        wxString localeName = languageInfo->GetLocaleName();
-        wxString symbol = localeName.StartsWith("zh") ? _("E4") : _("kilo");
-        int human = localeName.StartsWith("zh") ? 10000 : 1000;
-
-        // 输出买订单分析结果
-        ss << _("Buy Orders Analysis") << " (" << _("Count: ") << buyOrders.size() << ") \n";
-        ss << _("| Analysis Item | Count | Max | Min | Avg |") << " \n";
-        ss << _("| Prices |") << (buySumPrice / human) << symbol << " |" << buyMaxPrice << " |" << buyMinPrice << " | " << buyAvgPrice << " |\n";
-        ss << _("| Volume |") << (buySumVolume / human) << symbol << " |" << buyMaxVolume << " | " << buyMinVolume << " | " << buyAvgVolume << " |\n";
-        ss << _("| Amounts | ") << (buySumAmount / human) << symbol << " |" << buyMaxAmount << " | " << buyMinAmount << " | " << buyAvgAmount << " |\n";
-        ss << "\n";
-
-        // 输出卖订单分析结果
-        ss << _("Sell Orders Analysis") << " (" << _("Count: ") << sellOrders.size() << ") \n";
-        ss << _("| Analysis Item | Count | Max | Min | Avg |") << " \n";
-        ss << _("| Prices |") << (sellSumPrice / human) << symbol << " | " << sellMaxPrice << " | " << sellMinPrice << " | " << sellAvgPrice << " |\n";
-        ss << _("| Volume |") << (sellSumVolume / human) << symbol << " | " << sellMaxVolume << " | " << sellMinVolume << " | " << sellAvgVolume << " |\n";
-        ss << _("| Amounts | ") << (sellSumAmount / human) << symbol << " | " << sellMaxAmount << " | " << sellMinAmount << " | " << sellAvgAmount << " |\n";
-        ss << "\n";
-
-        // 最近交易
-        ss << _("Last Transaction") << " \n";
-        ss << _("| Transaction | Price | Volume | Amounts |") << " \n";
-        ss << _("| Buy Orders |") << lastBuy.price << " | " << static_cast<double>(lastBuy.volume) << " | " << static_cast<double>(lastBuy.amount) << " |\n";
-        ss << _("| Sell Orders |") << lastSell.price << " | " << static_cast<double>(lastSell.volume) << " | " << static_cast<double>(lastSell.amount) << " |\n";
-
-        return ss;
-        };
-    
-    return formatTableData(makeTable());
-}
-
-// 格式化成表格
-wxString StockData::formatTableData(std::stringstream ss) {
-    std::vector<std::string> rows;
-    std::string row;
-    while (std::getline(ss, row)) {
-        rows.push_back(row);
-    }
-
-    // 计算每列的最大宽度，只考虑包含分隔符的行
-    std::vector<int> columnWidths;
-    for (const auto& r : rows) {
-        if (r.find('|') != std::string::npos) {
-            // 去除行首尾的空格和|后再进行列宽计算
-            std::string trimmedRow = r;
-            while (trimmedRow.front() == ' ' || trimmedRow.front() == '|') {
-                trimmedRow.erase(trimmedRow.begin());
-            }
-            while (trimmedRow.back() == ' ' || trimmedRow.back() == '|') {
-                trimmedRow.erase(trimmedRow.end() - 1);
-            }
-
-            std::stringstream rowSs(trimmedRow);
-            std::string cell;
-            int colIndex = 0;
-            while (std::getline(rowSs, cell, '|')) {
-                if (columnWidths.size() <= colIndex) {
-                    columnWidths.push_back(cell.length());
-                }
-                else {
-                    columnWidths[colIndex] = (std::max)(columnWidths[colIndex], static_cast<int>(cell.length()));
-                }
-                colIndex++;
-            }
-        }
-    }
-
-    // 构建对齐后的表格字符串
-    std::stringstream outputSs;
-    for (const auto& r : rows) {
-        if (r.find('|') != std::string::npos) {
-            // 去除行首尾的空格和|后进行对齐处理
-            std::string trimmedRow = r;
-            while (trimmedRow.front() == ' ' || trimmedRow.front() == '|') {
-                trimmedRow.erase(trimmedRow.begin());
-            }
-            while (trimmedRow.back() == ' ' || trimmedRow.back() == '|') {
-                trimmedRow.erase(trimmedRow.end() - 1);
-            }
-
-            std::stringstream rowSs(trimmedRow);
-            std::string cell;
-            int colIndex = 0;
-            while (std::getline(rowSs, cell, '|')) {
-                outputSs << "| " << std::setw(columnWidths[colIndex]) << cell << " ";
-                colIndex++;
-            }
-            outputSs << "|\n";
-        }
-        else {
-            outputSs << r << "\n";
-        }
-    }
-
-    // 去除末尾多余的换行符
-    std::string outputStr = outputSs.str();
-    if (!outputStr.empty() && outputStr.back() == '\n') {
-        outputStr.pop_back();
-    }
-
-    // 再次检查列宽，确保每列至少有一个字符宽度（避免空列导致格式错乱）
-    for (size_t i = 0; i < columnWidths.size(); ++i) {
-        columnWidths[i] = (std::max)(1, columnWidths[i]);
-    }
-
-    // 重新构建输出字符串，根据调整后的列宽再次精确对齐
-    std::stringstream finalOutputSs;
-    for (const auto& r : rows) {
-        if (r.find('|') != std::string::npos) {
-            // 去除行首尾的空格和|后进行最终对齐处理
-            std::string trimmedRow = r;
-            while (trimmedRow.front() == ' ' || trimmedRow.front() == '|') {
-                trimmedRow.erase(trimmedRow.begin());
-            }
-            while (trimmedRow.back() == ' ' || trimmedRow.back() == '|') {
-                trimmedRow.erase(trimmedRow.end() - 1);
-            }
-
-            std::stringstream rowSs(trimmedRow);
-            std::string cell;
-            int colIndex = 0;
-            while (std::getline(rowSs, cell, '|')) {
-                finalOutputSs << "| " << std::setw(columnWidths[colIndex]) << cell << " ";
-                colIndex++;
-            }
-            finalOutputSs << "|\n";
-        }
-        else {
-            finalOutputSs << r << "\n";
-        }
-    }
-
-    // 将std::string转换回wxString并返回
-    return wxString(finalOutputSs.str());
-}
-
-// 用于获取页面数据的函数
-std::string StockData::fetchPageData(const std::string& symbol, int page, const std::string& action) {
-    MemoryBlock chunk;
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        throw std::runtime_error(_("Failed to initialize CURL"));
-    }
-
-    std::string lowerSymbol = toLowerCase(symbol);
-
-    wxString url = wxString::Format("%s?appn=detail&action=%s&c=%s&p=%d", BASE_URL, action, lowerSymbol, page);
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.ToStdString().c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&chunk);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 10L);
-
-    CURLcode res = curl_easy_perform(curl);
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_easy_cleanup(curl);
-
-
-    // 只在非200状态码时抛出异常
-    if (res != CURLE_OK) {
-        throw std::runtime_error(wxString::Format(_("CURL request failed: %s"), curl_easy_strerror(res)).ToStdString());
-    }
-
-    if (http_code != 200) {
-        throw std::runtime_error(wxString::Format(_("HTTP request failed with status code: %d"), http_code).ToStdString());
-    }
-
-    // 200状态码时，即使数据为空也返回空字符串
-    return std::string(chunk.data, chunk.size);
-}
-
-// 提取响应中引号内的内容
-std::string  StockData::getResponseText(const std::string& response) {
-    // 如果响应为空或不包含数据，直接返回空结果
-    if (response.empty() || response.find('[') == std::string::npos) {
-        throw std::exception("Extraction failed.");
-    }
-
-    size_t start = response.find('"');
-    start++;
-
-    size_t end = response.find('"', start);
-
-    if (end == std::string::npos) {
-        throw std::exception("Extraction failed.");
-    }
-
-    return response.substr(start, end - start);
-}
-
-// 从响应中解析股票数据
-std::vector<TickData>  StockData::parseStockData(const std::string& response, int stimesec, int etimesec) {
-    std::vector<TickData> result;
-    
-    // 默认为一整天
-    const std::string data = getResponseText(response);
-    const int stimesec_ = (stimesec == -1) ? 0 : stimesec;
-    const int etimesec_ = (etimesec == -1) ? 24 * 60 * 60 : etimesec;
-
-    std::istringstream stream(data);
-    std::string item;
-
-    while (std::getline(stream, item, '|')) {
-        if (item.empty()) continue;
-
-        //// 输出分割记录的调试信息
-        //wxMessageBox(wxString::Format("Processing Record: %s", item), "Info", wxICON_INFORMATION);
-
-        std::istringstream item_stream(item);
-        std::string index_str, time, price_str, change_str, volume_str, amount_str, type_str;
-
-        // 逐字段解析
-        if (!std::getline(item_stream, index_str, '/') ||
-            !std::getline(item_stream, time, '/') ||
-            !std::getline(item_stream, price_str, '/') ||
-            !std::getline(item_stream, change_str, '/') ||
-            !std::getline(item_stream, volume_str, '/') ||
-            !std::getline(item_stream, amount_str, '/') ||
-            !std::getline(item_stream, type_str, '/')) {
-            wxMessageBox(_("Error: Missing fields in data"), _("Error"), wxICON_ERROR);
-            continue;
-        }
-
-        //// 输出解析的字段信息
-        //wxMessageBox(wxString::Format(
-        //    "Parsed Fields:\nIndex: %s\nTime: %s\nPrice: %s\nChange: %s\nVolume: %s\nAmount: %s\nType: %s",
-        //    index_str, time, price_str, change_str, volume_str, amount_str, type_str),
-        //    "Info", wxICON_INFORMATION);
-
-        // 尝试将字段转换为所需类型
-        TickData tick;
-        try {
-            tick.index = std::stoi(index_str);          // 转换序号为 int
-            tick.time = time;                           // 时间为字符串
-            tick.price = std::stod(price_str);          // 转换价格为 double
-            tick.change = std::stod(change_str);        // 转换涨跌幅为 double
-            tick.volume = std::stoi(volume_str);        // 转换成交量为 int
-            tick.amount = std::stoi(amount_str);        // 转换成交金额为 int
-            tick.type = (type_str == "S") ? "Sell" :    // 类型判断
-                (type_str == "B") ? "Buy" : "Neutral";
-
-            int time_ = timeStringToSeconds(time);
-
-
-            //wxMessageBox(wxString::Format(_("%s %d %d %d"), time, time_, stimesec, etimesec), _("Error"), wxICON_ERROR);
-
-            if (time_ >= stimesec_ && time_ <= etimesec_) {
-                result.push_back(tick);  // 添加到结果列表
-            }
-        }
-        catch (const std::exception& e) {
-            // 捕获转换异常，输出错误提示
-            wxMessageBox(wxString::Format(_("Error parsing data: %s"), e.what()), _("Error"), wxICON_ERROR);
-            continue;
-        }
-    }
-
-    return result;
-}
-
-// 获取股票交易明细
-std::vector<TickData> StockData::queryStockData(const std::string& stockCode, int stimesec, int etimesec) {
-
-    // 根据时间获取分页数据
-    std::vector<int> pages = StockData::getTimePages(stockCode);
-    int sindex = (stimesec >= 0) ? StockData::findIndexForTime(pages, stimesec) : -1;
-    int eindex = (etimesec >= 0) ? StockData::findIndexForTime(pages, etimesec) : -1;
-
-    // 结束时间早于开盘时间
-    if (etimesec >= 0 && eindex == -1) {
-        throw std::string(_("No data available for analysis"));
-    }
-    // 开始时间大于收盘时间
-    // 这里会得到有效的页码，在后续查询接口返回无数据
-    const int page_start = (sindex >= 0) ? sindex : 0;
-    const int page_end = (eindex >= 0)? eindex : 100;
-
-    std::vector<TickData> allData;
-    const std::string symbol = getStockSymbol(stockCode);
-
-    for (int page = page_start; page <= page_end; page++) {
-        try {
-            std::string response = fetchPageData(symbol, page);
-            // 如果没有数据，跳出循环
-            if (response.empty()) {
-                break;
-            }
-            auto pageData = parseStockData(response, stimesec, etimesec);
-            allData.insert(allData.end(), pageData.begin(), pageData.end());
-            // 防止频繁请求
-            std::this_thread::sleep_for(std::chrono::milliseconds(SLEEP_TIME));
-        }
-        catch (const std::exception& e) {
-                wxMessageBox(wxString::Format(_("Error occurred while fetching data on page %d: %s"), page, e.what()),
-                _("Error"), wxICON_ERROR);
-            break;
-        }
-    }
-
-    if (!allData.empty()) {
-        return allData;
-    }
-    else {
-        throw std::string(_("No data available for analysis"));
-    }
-}
-
-// 用于将时间字符串转换为从当天0点开始的秒数
-int  StockData::timeStringToSeconds(const std::string& timeStr) {
-    int hours = 0, minutes = 0, seconds = 0;
-    std::istringstream iss(timeStr);
-
-    char delimiter;
-    iss >> hours >> delimiter >> minutes >> delimiter >> seconds;
-
-    return hours * 3600 + minutes * 60 + seconds;
-}
-
-// 用于分割原始字符串并存储时间段信息，以秒数形式存储时间
-std::vector<int>  StockData::getTimePages(const std::string& stockCode) {
-    std::vector<int> timePeriods;
-    std::string segment;
-
-    const std::string symbol = getStockSymbol(stockCode);
-    const std::string response = fetchPageData(symbol, 0, "");
-    const std::string data = getResponseText(response);
-    std::string stime, etime;
-    std::istringstream iss(data);
-    while (std::getline(iss, segment, '|')) {
-        int second;
-        std::istringstream subIss(segment);
-        std::getline(subIss, stime, '~');
-        std::getline(subIss, etime, '~');
-        timePeriods.push_back(timeStringToSeconds(stime));
-    }
-    timePeriods.push_back(timeStringToSeconds(etime));
-    timePeriods.push_back(24 * 60 * 60);
-    return timePeriods;
-}
-
-// 函数用于判断给定时间是否在某个时间段内，并返回索引
-int  StockData::findIndexForTime(const std::vector<int>& timeSeconds, const std::string& givenTime) {
-
-    int givenSeconds = timeStringToSeconds(givenTime);
-
-    return findIndexForTime(timeSeconds, givenSeconds);
-
-}
-
-int  StockData::findIndexForTime(const std::vector<int>& timeSeconds, int givenSecond) {
-
-    for (size_t i = 0; i < timeSeconds.size() - 1; ++i) {
-        const int& second = timeSeconds[i];
-        const int& nextSecond = timeSeconds[i+1];
-
-        if (givenSecond >= second){
-            if (givenSecond <= nextSecond) {
-                return static_cast<int>(i);
-            }
-        }
-        else {
-            break;
-        }
-    }
-
-    return -1;
-}
+#pragma once
+#include "Common.h"
+#include "Baseline.h"
+#include "Config.h"
+#include "DataSource.h"
+#include "FlowDetector.h"
+#include "MappedFile.h"
+#include "MetricPipeline.h"
+#include "RateLimiter.h"
+#include "StockData.h"
+#include "SingleFlight.h"
+#include "SymbolMetadata.h"
+#include "TextTable.h"
+#include "TickArchive.h"
+#include "TickCache.h"
+#include "TickParser.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <wx/msgdlg.h>
+#include <wx/string.h>
+#include <wx/textctrl.h>
+#include <locale.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// 配置参数
+const int MAX_PAGE = 100;
+
+// 被跳过的记录在界面线程汇总后提示一次；取数和导入都在工作线程中进行，不能直接弹出对话框
+static void reportSkippedRecords(size_t skipped) {
+    static std::atomic<size_t> pending{ 0 };
+    // 已经有待显示的提示时只累加数量
+    if (pending.fetch_add(skipped) != 0 || !wxTheApp) return;
+    wxTheApp->CallAfter([]() {
+        const size_t count = pending.exchange(0);
+        wxMessageBox(wxString::Format(_("%llu malformed records were skipped."), static_cast<unsigned long long>(count)),
+            _("Information"), wxICON_INFORMATION);
+    });
+}
+
+void TickColumns::reserve(size_t n) {
+    index.reserve(n);
+    time.reserve(n);
+    price.reserve(n);
+    change.reserve(n);
+    volume.reserve(n);
+    amount.reserve(n);
+    side.reserve(n);
+}
+
+void TickColumns::resize(size_t n) {
+    index.resize(n);
+    time.resize(n);
+    price.resize(n);
+    change.resize(n);
+    volume.resize(n);
+    amount.resize(n);
+    side.resize(n);
+}
+
+void TickColumns::clear() {
+    index.clear();
+    time.clear();
+    price.clear();
+    change.clear();
+    volume.clear();
+    amount.clear();
+    side.clear();
+}
+
+void TickColumns::push(int32_t index_, int32_t time_, double price_, double change_, double volume_, double amount_, int8_t side_) {
+    index.push_back(index_);
+    time.push_back(time_);
+    price.push_back(price_);
+    change.push_back(change_);
+    volume.push_back(volume_);
+    amount.push_back(amount_);
+    side.push_back(side_);
+}
+
+void TickColumns::append(const TickColumns& other) {
+    index.insert(index.end(), other.index.begin(), other.index.end());
+    time.insert(time.end(), other.time.begin(), other.time.end());
+    price.insert(price.end(), other.price.begin(), other.price.end());
+    change.insert(change.end(), other.change.begin(), other.change.end());
+    volume.insert(volume.end(), other.volume.begin(), other.volume.end());
+    amount.insert(amount.end(), other.amount.begin(), other.amount.end());
+    side.insert(side.end(), other.side.begin(), other.side.end());
+}
+
+// 追加时间在 [stimesec, etimesec] 内的行，返回追加的笔数
+size_t TickColumns::appendRange(const TickColumns& other, int stimesec, int etimesec) {
+    if (stimesec < 0 && etimesec < 0) {
+        append(other);
+        return other.size();
+    }
+    const int stimesec_ = (stimesec == -1) ? 0 : stimesec;
+    const int etimesec_ = (etimesec == -1) ? 24 * 60 * 60 : etimesec;
+    size_t count = 0;
+    for (size_t i = 0; i < other.size(); ++i) {
+        if (other.time[i] >= stimesec_ && other.time[i] <= etimesec_) {
+            push(other.index[i], other.time[i], other.price[i], other.change[i], other.volume[i], other.amount[i], other.side[i]);
+            count++;
+        }
+    }
+    return count;
+}
+
+// 取出一行，供需要整行数据的地方使用
+TickData TickColumns::row(size_t i) const {
+    TickData tick;
+    tick.index = index[i];
+    tick.time = StockData::secondsToTimeString(time[i]);
+    tick.price = price[i];
+    tick.change = change[i];
+    tick.volume = volume[i];
+    tick.amount = amount[i];
+    tick.type = (side[i] == SIDE_BUY) ? "Buy" : (side[i] == SIDE_SELL) ? "Sell" : "Neutral";
+    return tick;
+}
+
+size_t TickColumns::memoryBytes() const {
+    return size() * (sizeof(int32_t) * 2 + sizeof(double) * 4 + sizeof(int8_t));
+}
+
+// 统一股票代码
+std::string StockData::getStockSymbol(const std::string stockCode) {
+    int pos = stockCode.find('.');
+    std::string symbol = stockCode;
+    if (pos > 0) {
+        symbol = stockCode.substr(pos + 1);
+        symbol += stockCode.substr(0, pos);
+    }
+    return symbol;
+}
+
+// 分析数据，一次遍历同时统计买卖两个方向，忽略中性订单
+AnalysisResult StockData::analyzeData(const std::string& stockCode, const TickColumns& data, QueryMetrics* metrics) {
+    TRACE_SCOPE("analyzeData");
+    AnalysisResult result;
+    result.stockCode = stockCode;
+    if (data.empty()) {
+        wxMessageBox(_("No data available for analysis"), _("Information"), wxICON_INFORMATION);
+        return result;
+    }
+
+    StopWatch aggregateWatch;
+    result.tickCount = data.size();
+    result.firstTime = data.time.front();
+    result.lastTime = data.time.back();
+
+    const size_t n = data.size();
+    metric::BySide<metric::SummaryMetrics> sides;
+    sides.accumulate(data, 0, n);
+
+    // 成交量单位为手，已查询过的股票直接用记录的每手股数，否则按第一笔非零成交推算
+    SymbolInfo info;
+    if (SymbolMetadata::getInstance().find(getStockSymbol(stockCode), info)) {
+        result.lotSize = info.lotSize;
+    }
+    for (size_t i = 0; i < n && result.lotSize == 0; ++i) {
+        if (data.volume[i] > 0 && data.price[i] > 0) {
+            result.lotSize = data.row(i).onehand();
+        }
+    }
+
+    metric::fillSummary(sides.buy, data, result.lotSize, result.buy);
+    metric::fillSummary(sides.sell, data, result.lotSize, result.sell);
+
+    // 滚动窗口内的成交量异常
+    FlowDetector detector;
+    detector.add(data, 0, n);
+    detector.finish();
+    result.spikes = detector.spikes();
+
+    if (metrics) {
+        metrics->aggregateUs = aggregateWatch.elapsedUs();
+    }
+    return result;
+}
+
+// 将分析结果渲染为文本表格
+wxString StockData::formatResult(const AnalysisResult& result, QueryMetrics* metrics) {
+    if (result.tickCount == 0) {
+        return "";
+    }
+
+    StopWatch formatWatch;
+    TextTable table;
+    table.reserve(26, 106);
+    auto utf8 = [](const wxString& text) { return std::string(text.utf8_str()); };
+
+    // 人类友好
+    const int language = Config::getInstance().getLanguage();
+    const wxLanguageInfo* languageInfo = wxLocale::GetLanguageInfo(language);
+    wxString localeName = languageInfo->GetLocaleName();
+    const std::string symbol = utf8(localeName.StartsWith("zh") ? _("E4") : _("kilo"));
+    int human = localeName.StartsWith("zh") ? 10000 : 1000;
+
+    const std::string itemHeaders[] = { utf8(_("Analysis Item")), utf8(_("Count")), utf8(_("Max")), utf8(_("Min")), utf8(_("Avg")) };
+    auto addHeader = [&table](const std::string* headers, size_t count) {
+        table.beginRow();
+        for (size_t i = 0; i < count; ++i) {
+            table.addText(headers[i]);
+        }
+    };
+    auto addStats = [&](const wxString& label, double sum, double max, double min, double avg) {
+        table.beginRow();
+        table.addText(utf8(label));
+        table.addNumber(sum / human, 2, symbol);
+        table.addNumber(max);
+        table.addNumber(min);
+        table.addNumber(avg);
+    };
+    auto addSide = [&](const wxString& title, const SideSummary& s) {
+        table.addLine(utf8(wxString::Format("%s (%s%d) ", title, _("Count: "), static_cast<int>(s.count))));
+        addHeader(itemHeaders, 5);
+        addStats(_("Prices"), s.sumPrice, s.maxPrice, s.minPrice, s.avgPrice);
+        addStats(_("Volume"), s.sumVolume, s.maxVolume, s.minVolume, s.avgVolume);
+        addStats(_("Amounts"), s.sumAmount, s.maxAmount, s.minAmount, s.avgAmount);
+        table.addLine("");
+    };
+    auto addLast = [&](const wxString& label, const SideSummary& s) {
+        table.beginRow();
+        table.addText(utf8(label));
+        table.addNumber(s.lastPrice);
+        table.addNumber(s.lastVolume);
+        table.addNumber(s.lastAmount);
+    };
+
+    // 输出买卖订单分析结果
+    addSide(_("Buy Orders Analysis"), result.buy);
+    addSide(_("Sell Orders Analysis"), result.sell);
+
+    // 最近交易
+    const std::string lastHeaders[] = { utf8(_("Transaction")), utf8(_("Price")), utf8(_("Volume")), utf8(_("Amounts")) };
+    table.addLine(utf8(_("Last Transaction")) + " ");
+    addHeader(lastHeaders, 4);
+    addLast(_("Buy Orders"), result.buy);
+    addLast(_("Sell Orders"), result.sell);
+
+    // z 值最高的若干段异常，按时间顺序列出
+    if (!result.spikes.empty()) {
+        std::vector<FlowSpike> spikes = result.spikes;
+        const size_t count = (std::min)(spikes.size(), static_cast<size_t>(10));
+        std::partial_sort(spikes.begin(), spikes.begin() + count, spikes.end(), [](const FlowSpike& a, const FlowSpike& b) {
+            return a.peakZ > b.peakZ;
+        });
+        spikes.resize(count);
+        std::sort(spikes.begin(), spikes.end(), [](const FlowSpike& a, const FlowSpike& b) { return a.start < b.start; });
+
+        table.addLine("");
+        table.addLine(utf8(wxString::Format(_("Flow Spikes (%d)"), static_cast<int>(result.spikes.size()))) + " ");
+        const std::string spikeHeaders[] = { utf8(_("Window")), utf8(_("Time")), utf8(_("Peak Z")), utf8(_("Imbalance")), utf8(_("Trades/s")), utf8(_("Max Amount")) };
+        addHeader(spikeHeaders, 6);
+        for (const auto& spike : spikes) {
+            table.beginRow();
+            table.addText(utf8(wxString::Format(_("%ds"), spike.window)));
+            table.addText(secondsToTimeString(spike.start) + "-" + secondsToTimeString(spike.end));
+            table.addNumber(spike.peakZ, 1);
+            table.addNumber(spike.imbalance * 100, 0, "%");
+            table.addNumber(spike.intensity, 1);
+            table.addNumber(spike.maxAmount / human, 2, symbol);
+        }
+    }
+
+    wxString text = formatTableData(table);
+    if (metrics) {
+        metrics->formatUs = formatWatch.elapsedUs();
+    }
+    return text;
+}
+
+// 渲染表格并转换为 wxString
+wxString StockData::formatTableData(const TextTable& table) {
+    TRACE_SCOPE("formatTableData");
+    const std::string text = table.render();
+    return wxString::FromUTF8(text.data(), text.size());
+}
+
+// 导入本地成交明细文件（CSV/TXT），内存映射后并行解析；.tka 归档文件直接解码
+TickColumns StockData::importStockData(const std::string& path, int stimesec, int etimesec, QueryMetrics* metrics) {
+    TRACE_SCOPE("importStockData");
+    StopWatch importWatch;
+
+    const std::string lowerPath = toLowerCase(path);
+    const bool isArchive = lowerPath.size() > 4 && lowerPath.compare(lowerPath.size() - 4, 4, ".tka") == 0;
+    size_t skipped = 0, bytes = 0;
+    TickColumns data;
+    if (isArchive) {
+        TickArchive archive(path);
+        data = archive.read(0, INT32_MAX, stimesec, etimesec);
+        bytes = archive.fileSize();
+    }
+    else {
+        MappedFile file(path);
+        data = TickParser::parseParallel(file.data(), file.size(), stimesec, etimesec, &skipped);
+        bytes = file.size();
+    }
+
+    if (metrics) {
+        PageTiming timing;
+        timing.page = 0;
+        timing.bytes = bytes;
+        timing.ticks = data.size();
+        timing.parseUs = importWatch.elapsedUs();
+        metrics->pages.push_back(timing);
+        metrics->fetchUs = timing.parseUs;
+    }
+
+    if (data.empty()) {
+        throw std::string(_("No data available for analysis"));
+    }
+    if (skipped > 0) {
+        reportSkippedRecords(skipped);
+    }
+    return data;
+}
+
+// 查询计划的简要说明，如 "14 pages from RAM, 2 from disk, 1 from network"
+wxString QueryPlan::describe() const {
+    if (diskDay) {
+        return _("whole day from disk");
+    }
+    size_t counts[3] = { 0, 0, 0 };
+    for (const auto& page : pages) {
+        counts[static_cast<int>(page.source)]++;
+    }
+    return wxString::Format(_("%d pages from RAM, %d from disk, %d from network"),
+        static_cast<int>(counts[0]), static_cast<int>(counts[1]), static_cast<int>(counts[2]));
+}
+
+// 获取股票交易明细：按页选择内存缓存、本地归档或网络中代价最低的来源，
+// 只请求缺少的页和仍在增长的最后一页，网络请求并发执行
+TickColumns StockData::queryStockData(const std::string& stockCode, int stimesec, int etimesec, QueryMetrics* metrics) {
+    TRACE_SCOPE("queryStockData");
+    StopWatch fetchWatch;
+
+    const std::string symbol = getStockSymbol(stockCode);
+    const int32_t date = TickArchive::currentTradingDate();
+    // 优先使用当前最快的健康数据源，分页发现失败时切换到下一个
+    DataSourceRouter& router = DataSourceRouter::getInstance();
+    const std::vector<std::shared_ptr<DataSource>> sources = router.candidates();
+    std::shared_ptr<DataSource> source = sources.front();
+    TickCache& cache = TickCache::getInstance();
+    const std::shared_ptr<const CachedDay> cached = cache.find(symbol, date, source->name());
+
+    // 本地归档中当天的数据，文件损坏时只用网络。查询范围内的成交先解码出来并立即释放映射，
+    // 网络请求期间一直持有会使收盘后的归档无法替换文件
+    std::optional<ArchiveBlock> archived;
+    TickColumns archivedTicks;
+    const std::string archivePath = TickArchive::getArchiveFile(symbol);
+    if (TickArchive::exists(archivePath)) {
+        try {
+            TickArchive archive(archivePath);
+            if (const ArchiveBlock* block = archive.findBlock(date)) {
+                archive.readBlock(*block, archivedTicks, stimesec, etimesec);
+                archived = *block;
+            }
+        }
+        catch (const std::exception&) {
+            archived.reset();
+            archivedTicks.clear();
+        }
+    }
+
+    QueryPlan plan;
+    TickColumns allData;
+
+    // 收盘后归档的整日数据按时间范围直接读取，不再请求网络
+    if (!(cached && cached->complete) && archived && (archived->flags & ARCHIVE_COMPLETE)) {
+        plan.diskDay = true;
+        allData = std::move(archivedTicks);
+        if (metrics) {
+            metrics->diskPages = 1;
+            metrics->plan = plan.describe();
+            metrics->fetchUs = fetchWatch.elapsedUs();
+        }
+        if (allData.empty()) {
+            throw std::string(_("No data available for analysis"));
+        }
+        return allData;
+    }
+
+    // 收盘后取得的完整数据连分页信息也不再请求
+    SymbolMetadata& metadata = SymbolMetadata::getInstance();
+    SymbolInfo info = metadata.get(symbol);
+    auto day = std::make_shared<CachedDay>();
+    if (cached && cached->complete) {
+        *day = *cached;
+    }
+    else {
+        day->complete = info.isClosed(date);
+        // 当天的分页表除最后一个边界外不会变化，交易中直接复用，新增的页在后面探测；收盘后再取一次完整的分页表
+        if (info.hasPages(date, source->name())) {
+            day->timePages = info.timePages;
+        }
+        else {
+            for (size_t i = 0; ; ++i) {
+                try {
+                    RequestBudget::charge();
+                    StopWatch discoverWatch;
+                    day->timePages = sources[i]->getTimePages(symbol, metrics ? &metrics->pagesRequest : nullptr);
+                    router.reportSuccess(*sources[i], discoverWatch.elapsedUs());
+                    source = sources[i];
+                    break;
+                }
+                catch (const RequestBudgetExceeded&) {
+                    throw;
+                }
+                catch (const std::exception&) {
+                    router.reportFailure(*sources[i]);
+                    if (i + 1 >= sources.size()) throw;
+                    Metrics::getInstance().counter("source.failover")++;
+                }
+            }
+            info.pagesDate = date;
+            info.pagesSource = source->name();
+            info.timePages = day->timePages;
+            info.pagesComplete = day->complete;
+            metadata.update(info);
+        }
+        // 各数据源的分页方式不同，切换数据源后缓存的页不能沿用
+        if (cached && source == sources.front()) {
+            day->pages = cached->pages;
+        }
+    }
+
+    // 根据时间获取分页数据
+    const std::vector<int>& pages = day->timePages;
+    const int lastPage = static_cast<int>(pages.size()) - 3;
+    int sindex = (stimesec >= 0) ? StockData::findIndexForTime(pages, stimesec) : -1;
+    int eindex = (etimesec >= 0) ? StockData::findIndexForTime(pages, etimesec) : -1;
+
+    // 结束时间早于开盘时间
+    if (etimesec >= 0 && eindex == -1) {
+        throw std::string(_("No data available for analysis"));
+    }
+    // 开始时间大于收盘时间
+    // 这里会得到有效的页码，在后续查询接口返回无数据
+    const int page_start = (sindex >= 0) ? sindex : 0;
+    // 结束时间晚于分页表末尾时，交易中可能已经有多个新页
+    const int page_end = (eindex >= 0 && (day->complete || eindex <= lastPage)) ? eindex : MAX_PAGE;
+
+    // 逐页选择来源：内容不会再变化的缓存页 > 结束时间早于归档末尾的页 > 网络
+    for (int page = page_start; page <= (std::min)(page_end, lastPage); page++) {
+        const bool inMemory = page < static_cast<int>(day->pages.size()) && day->pages[page].ticks && day->pages[page].final;
+        const bool onDisk = archived && pages[page + 1] < archived->maxTime;
+        plan.pages.push_back(PlannedPage{ page, inMemory ? PageSource::Memory : onDisk ? PageSource::Disk : PageSource::Network });
+    }
+    // 收盘前分页信息取得之后可能又有新的页
+    const int probeFrom = (!day->complete && page_end > lastPage) ? (std::max)(page_start, lastPage + 1) : -1;
+
+    // 查询中每页只请求一次，失败的页在返回后由后台线程退避重试，不拖慢本次查询
+    auto fetchPage = [&](int page, PageTiming* timing, bool* shared) {
+        return fetchTicks(*source, symbol, page, timing, shared);
+    };
+
+    // 并发请求网络页
+    struct PageResult {
+        std::shared_ptr<const TickColumns> ticks;
+        PageTiming timing;
+        bool shared = false;
+        bool overBudget = false;
+        std::string error;
+    };
+    std::vector<PageResult> results(plan.pages.size());
+    std::vector<size_t> networkSlots;
+    for (size_t i = 0; i < plan.pages.size(); ++i) {
+        if (plan.pages[i].source == PageSource::Network) networkSlots.push_back(i);
+    }
+    {
+        TRACE_SCOPE("fetchPages");
+        std::atomic<size_t> next{ 0 };
+        RequestBudget* budget = RequestBudget::current();
+        auto worker = [&]() {
+            for (size_t k = next++; k < networkSlots.size(); k = next++) {
+                PageResult& result = results[networkSlots[k]];
+                try {
+                    result.ticks = fetchPage(plan.pages[networkSlots[k]].page, &result.timing, &result.shared);
+                }
+                catch (const RequestBudgetExceeded&) {
+                    result.overBudget = true;
+                }
+                catch (const std::exception& e) {
+                    result.error = e.what();
+                }
+            }
+        };
+        const size_t workers = (std::min)(networkSlots.size(), Config::getInstance().getMaxConcurrency());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < workers; ++i) {
+            threads.emplace_back([&, i]() {
+                if (Trace::enabled()) {
+                    Trace::setThreadName("Fetch " + symbol + " #" + std::to_string(i));
+                }
+                RequestBudget::Scope scope(budget);
+                worker();
+            });
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // 按页码顺序拼接；不同来源衔接处可能有同一秒内重复的成交，按序号去掉
+    PageSource lastSource = PageSource::Memory;
+    auto appendPiece = [&](const TickColumns& piece, PageSource source) {
+        const bool dedupe = !allData.empty() && source != lastSource;
+        const int32_t lastIndex = dedupe ? allData.index.back() : 0;
+        const int stimesec_ = (stimesec == -1) ? 0 : stimesec;
+        const int etimesec_ = (etimesec == -1) ? 24 * 60 * 60 : etimesec;
+        size_t count = 0;
+        for (size_t i = 0; i < piece.size(); ++i) {
+            if (dedupe && piece.index[i] <= lastIndex) continue;
+            if (piece.time[i] < stimesec_ || piece.time[i] > etimesec_) continue;
+            allData.push(piece.index[i], piece.time[i], piece.price[i], piece.change[i], piece.volume[i], piece.amount[i], piece.side[i]);
+            count++;
+        }
+        lastSource = source;
+        return count;
+    };
+    auto storePage = [&](int page, const std::shared_ptr<const TickColumns>& ticks) {
+        // 最后一页之前的页已经写满
+        if (static_cast<int>(day->pages.size()) <= page) {
+            day->pages.resize(page + 1);
+        }
+        day->pages[page] = CachedPage{ ticks, day->complete || page < lastPage };
+    };
+    auto recordNetwork = [&](PageTiming timing, bool shared, size_t count) {
+        if (!metrics) return;
+        if (shared) {
+            metrics->sharedPages++;
+        }
+        else {
+            timing.ticks = count;
+            metrics->pages.push_back(timing);
+        }
+    };
+
+    // 请求预算用完时不返回缺页的结果，已取得的页留在缓存中，继续时不再请求
+    if (std::any_of(results.begin(), results.end(), [](const PageResult& r) { return r.overBudget; })) {
+        for (size_t slot : networkSlots) {
+            if (results[slot].ticks) storePage(plan.pages[slot].page, results[slot].ticks);
+        }
+        cache.put(symbol, date, source->name(), day);
+        throw RequestBudgetExceeded();
+    }
+
+    bool complete = true;
+    bool fetched = false;
+    bool ended = false;
+    // 失败的页不中断查询，已取得的页都保存在缓存中，再次查询时只请求缺少的页
+    std::vector<int> missing;
+    std::string lastError;
+    // 网络返回的末尾数据，用于更新分页表的最后一个边界
+    std::vector<int> probedStarts;
+    int tailTime = -1;
+    for (size_t i = 0; i < plan.pages.size() && !ended; ++i) {
+        const int page = plan.pages[i].page;
+        switch (plan.pages[i].source) {
+        case PageSource::Memory: {
+            const TickColumns& ticks = *day->pages[page].ticks;
+            appendPiece(ticks, PageSource::Memory);
+            if (metrics) {
+                metrics->cachedPages++;
+                metrics->cachedTicks += ticks.size();
+            }
+            break;
+        }
+        case PageSource::Disk: {
+            // 连续的归档页一次读取
+            size_t last = i;
+            while (last + 1 < plan.pages.size() && plan.pages[last + 1].source == PageSource::Disk) last++;
+            const int rangeStart = (std::max)(stimesec, pages[page]);
+            const int rangeEnd = (etimesec >= 0) ? (std::min)(etimesec, pages[plan.pages[last].page + 1]) : pages[plan.pages[last].page + 1];
+            TickColumns piece;
+            piece.appendRange(archivedTicks, rangeStart, rangeEnd);
+            appendPiece(piece, PageSource::Disk);
+            if (metrics) {
+                metrics->diskPages += last - i + 1;
+            }
+            i = last;
+            break;
+        }
+        case PageSource::Network: {
+            const PageResult& result = results[i];
+            if (!result.error.empty()) {
+                missing.push_back(page);
+                lastError = wxString::Format(_("Error occurred while fetching data on page %d: %s"), page, result.error).ToStdString();
+                complete = false;
+                break;
+            }
+            // 如果没有数据，后面的页也不会有
+            if (!result.ticks) {
+                ended = true;
+                break;
+            }
+            recordNetwork(result.timing, result.shared, appendPiece(*result.ticks, PageSource::Network));
+            storePage(page, result.ticks);
+            if (page == lastPage && !result.ticks->empty()) {
+                tailTime = result.ticks->time.back();
+            }
+            fetched = true;
+            break;
+        }
+        }
+    }
+
+    // 顺序探测分页信息之后新增的页，直到返回空数据
+    for (int page = probeFrom; !ended && probeFrom >= 0 && page <= page_end; page++) {
+        try {
+            PageTiming timing;
+            bool shared = false;
+            std::shared_ptr<const TickColumns> ticks = fetchPage(page, &timing, &shared);
+            // 如果没有数据，跳出循环
+            if (!ticks) {
+                break;
+            }
+            plan.pages.push_back(PlannedPage{ page, PageSource::Network });
+            recordNetwork(timing, shared, appendPiece(*ticks, PageSource::Network));
+            storePage(page, ticks);
+            fetched = true;
+            if (ticks->empty()) {
+                break;
+            }
+            probedStarts.push_back(ticks->time.front());
+            tailTime = ticks->time.back();
+            // 已经超过结束时间，后面的页不需要
+            if (etimesec >= 0 && ticks->time.front() > etimesec) {
+                break;
+            }
+        }
+        catch (const RequestBudgetExceeded&) {
+            cache.put(symbol, date, source->name(), day);
+            throw;
+        }
+        catch (const std::exception& e) {
+            missing.push_back(page);
+            lastError = wxString::Format(_("Error occurred while fetching data on page %d: %s"), page, e.what()).ToStdString();
+            complete = false;
+            break;
+        }
+    }
+
+    // 交易中只有末尾在增长：保留已有边界，接上探测到的新页和最后一笔成交的时间
+    if (!day->complete && lastPage >= 0 && (!probedStarts.empty() || tailTime > pages[lastPage + 1])) {
+        std::vector<int> grown(pages.begin(), pages.begin() + lastPage + 1);
+        grown.insert(grown.end(), probedStarts.begin(), probedStarts.end());
+        grown.push_back((std::max)(tailTime, grown.back()));
+        grown.push_back(24 * 60 * 60);
+        // 新的最后一页之前的页已经写满
+        const int grownLast = static_cast<int>(grown.size()) - 3;
+        for (int page = lastPage; page < grownLast && page < static_cast<int>(day->pages.size()); page++) {
+            day->pages[page].final = day->pages[page].ticks != nullptr;
+        }
+        day->timePages = grown;
+        if (info.pagesDate == date) {
+            info.timePages = grown;
+            metadata.update(info);
+        }
+    }
+
+    // 每手股数按第一笔非零成交推算一次并记录
+    if (info.lotSize == 0) {
+        for (size_t i = 0; i < allData.size(); ++i) {
+            if (allData.volume[i] > 0 && allData.price[i] > 0) {
+                info.lotSize = static_cast<int>(allData.amount[i] / allData.volume[i] / allData.price[i] + 0.5);
+                metadata.update(info);
+                break;
+            }
+        }
+    }
+
+    if (fetched) {
+        cache.put(symbol, date, source->name(), day);
+    }
+
+    if (metrics) {
+        metrics->plan = plan.describe();
+        metrics->fetchUs = fetchWatch.elapsedUs();
+        metrics->missingPages = missing;
+    }
+
+    // 已写满的缺页在后台重试并放入缓存，之后“继续”时直接从内存读取；
+    // 受请求预算约束的扫描不在后台发出请求，由扫描的继续重新查询
+    std::vector<int> retry;
+    for (int page : missing) {
+        if (page < lastPage) retry.push_back(page);
+    }
+    if (!retry.empty() && !RequestBudget::current()) {
+        retryPages(source, symbol, date, day, retry);
+    }
+
+    // 只归档未按时间过滤且没有出错的整日数据
+    if (complete && fetched && stimesec < 0 && etimesec < 0 && !allData.empty()) {
+        archiveStockData(symbol, allData, day->complete);
+    }
+
+    if (!allData.empty()) {
+        return allData;
+    }
+    else if (!missing.empty()) {
+        throw std::runtime_error(lastError);
+    }
+    else {
+        throw std::string(_("No data available for analysis"));
+    }
+}
+
+// 并行查询并分析多只股票，请求频率仍受共享的限速约束，总耗时接近最慢的一只
+std::vector<ComparisonEntry> StockData::compareStocks(const std::vector<std::string>& stockCodes, int stimesec, int etimesec) {
+    TRACE_SCOPE("compareStocks");
+    std::vector<ComparisonEntry> entries(stockCodes.size());
+    // 各线程都会更新分页表，结束时只写一次元数据文件
+    SymbolMetadata::getInstance().beginBatch();
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        for (size_t k = next++; k < entries.size(); k = next++) {
+            ComparisonEntry& entry = entries[k];
+            entry.stockCode = stockCodes[k];
+            try {
+                const TickColumns data = queryStockData(entry.stockCode, stimesec, etimesec, &entry.metrics);
+                entry.result = analyzeData(entry.stockCode, data, &entry.metrics);
+            }
+            catch (const std::exception& e) {
+                entry.error = e.what();
+            }
+            catch (const std::string& s) {
+                entry.error = s;
+            }
+        }
+    };
+
+    const size_t workers = (std::min)(entries.size(), Config::getInstance().getMaxConcurrency());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    SymbolMetadata::getInstance().endBatch();
+    return entries;
+}
+
+// 对比表：每只股票一列
+wxString StockData::formatComparison(const std::vector<ComparisonEntry>& entries) {
+    TextTable table;
+    table.reserve(12, 12 * (entries.size() + 1));
+    auto utf8 = [](const wxString& text) { return std::string(text.utf8_str()); };
+
+    const int language = Config::getInstance().getLanguage();
+    const wxLanguageInfo* languageInfo = wxLocale::GetLanguageInfo(language);
+    wxString localeName = languageInfo->GetLocaleName();
+    const std::string symbol = utf8(localeName.StartsWith("zh") ? _("E4") : _("kilo"));
+    int human = localeName.StartsWith("zh") ? 10000 : 1000;
+
+    table.beginRow();
+    table.addText(utf8(_("Analysis Item")));
+    for (const auto& entry : entries) {
+        table.addText(entry.stockCode);
+    }
+
+    // 查询失败的股票该列留空
+    auto addRow = [&](const wxString& label, const std::function<void(const AnalysisResult&)>& cell) {
+        table.beginRow();
+        table.addText(utf8(label));
+        for (const auto& entry : entries) {
+            if (entry.error.empty() && entry.result.tickCount > 0) {
+                cell(entry.result);
+            }
+            else {
+                table.addText("-");
+            }
+        }
+    };
+    addRow(_("Count"), [&](const AnalysisResult& r) { table.addInteger(static_cast<long long>(r.tickCount)); });
+    addRow(_("Buy Amounts"), [&](const AnalysisResult& r) { table.addNumber(r.buy.sumAmount / human, 2, symbol); });
+    addRow(_("Sell Amounts"), [&](const AnalysisResult& r) { table.addNumber(r.sell.sumAmount / human, 2, symbol); });
+    addRow(_("Buy Volume"), [&](const AnalysisResult& r) { table.addNumber(r.buy.sumVolume / human, 2, symbol); });
+    addRow(_("Sell Volume"), [&](const AnalysisResult& r) { table.addNumber(r.sell.sumVolume / human, 2, symbol); });
+    // 成交均价只计买卖盘，成交量单位为手
+    addRow(_("VWAP"), [&](const AnalysisResult& r) {
+        const double volume = (r.buy.sumVolume + r.sell.sumVolume) * r.lotSize;
+        table.addNumber(volume > 0 ? (r.buy.sumAmount + r.sell.sumAmount) / volume : 0.0);
+    });
+    // 买卖失衡：(买盘金额 - 卖盘金额) / (买盘金额 + 卖盘金额)
+    addRow(_("Imbalance"), [&](const AnalysisResult& r) {
+        const double total = r.buy.sumAmount + r.sell.sumAmount;
+        table.addNumber(total > 0 ? (r.buy.sumAmount - r.sell.sumAmount) / total * 100 : 0.0, 2, "%");
+    });
+    addRow(_("Largest Buy"), [&](const AnalysisResult& r) { table.addNumber(r.buy.maxAmount / human, 2, symbol); });
+    addRow(_("Largest Sell"), [&](const AnalysisResult& r) { table.addNumber(r.sell.maxAmount / human, 2, symbol); });
+
+    for (const auto& entry : entries) {
+        if (!entry.error.empty()) {
+            table.addLine(entry.stockCode + ": " + entry.error);
+        }
+    }
+    return formatTableData(table);
+}
+
+// 后台预热：建立到数据源的长连接；给出股票代码时顺便取得当天的分页表，之后的查询只需请求数据页
+void StockData::warmUp(const std::string& stockCode) {
+    // 连接预热最多 15 秒一次，输入时频繁触发也只发出一次请求
+    static std::atomic<int64_t> lastWarmUp{ 0 };
+    const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    const bool connect = now - lastWarmUp >= 15;
+    if (!connect && stockCode.empty()) return;
+    if (connect) lastWarmUp = now;
+
+    std::thread([stockCode, connect]() {
+        try {
+            const std::shared_ptr<DataSource> source = DataSourceRouter::getInstance().candidates().front();
+            if (connect) {
+                source->warmUp();
+            }
+            if (stockCode.empty()) return;
+
+            const std::string symbol = getStockSymbol(stockCode);
+            const int32_t date = TickArchive::currentTradingDate();
+            SymbolMetadata& metadata = SymbolMetadata::getInstance();
+            SymbolInfo info = metadata.get(symbol);
+            // 预取占用限速令牌，没有令牌时放弃，不影响正式查询
+            if (info.hasPages(date, source->name()) || !RateLimiter::getInstance().tryAcquire()) return;
+            info.timePages = source->getTimePages(symbol);
+            info.pagesDate = date;
+            info.pagesSource = source->name();
+            info.pagesComplete = info.isClosed(date);
+            metadata.update(info);
+            Metrics::getInstance().counter("warmup.prefetch")++;
+        }
+        catch (const std::exception&) {
+        }
+    }).detach();
+}
+
+// 请求并解析一页数据，响应为空时返回 nullptr
+// 同一数据源同一股票同一页的并发请求只发送一次，其余调用者共享结果，shared 为 true
+std::shared_ptr<const TickColumns> StockData::fetchTicks(DataSource& source, const std::string& symbol, int page, PageTiming* timing, bool* shared) {
+    struct FetchedPage {
+        std::shared_ptr<const TickColumns> ticks;
+        PageTiming timing;
+    };
+    static SingleFlight<std::tuple<std::string, std::string, int>, std::shared_ptr<const FetchedPage>> flight;
+
+    // 请求预算属于调用者的线程，在合并之前由每个调用者各自扣除：共享结果的调用者同样用掉了这一页，
+    // 发起请求者的预算也不能决定没有预算的调用者是否失败
+    RequestBudget::charge();
+    const std::shared_ptr<const FetchedPage> result = flight.run({ source.name(), toLowerCase(symbol), page }, [&]() {
+        // 限速只针对实际发出的请求
+        RateLimiter::getInstance().acquire();
+        auto fetched = std::make_shared<FetchedPage>();
+        std::string response;
+        try {
+            response = source.fetchPage(symbol, page, &fetched->timing);
+        }
+        catch (const std::exception&) {
+            DataSourceRouter::getInstance().reportFailure(source);
+            throw;
+        }
+        DataSourceRouter::getInstance().reportSuccess(source, fetched->timing.totalUs);
+        if (!response.empty()) {
+            StopWatch parseWatch;
+            auto ticks = std::make_shared<TickColumns>();
+            size_t skipped = 0;
+            fetched->timing.ticks = source.decodePage(response, *ticks, &skipped);
+            fetched->timing.parseUs = parseWatch.elapsedUs();
+            fetched->timing.skipped = skipped;
+            fetched->ticks = ticks;
+            if (skipped > 0) {
+                Metrics::getInstance().counter("fetch.skipped") += skipped;
+                reportSkippedRecords(skipped);
+            }
+        }
+        return std::shared_ptr<const FetchedPage>(fetched);
+    }, shared);
+
+    if (shared && *shared) {
+        Metrics::getInstance().counter("singleflight.shared")++;
+    }
+    if (timing) {
+        *timing = result->timing;
+    }
+    return result->ticks;
+}
+
+// 后台按 0.5s、1s、2s ... 退避重试缺少的页，每取得一页就合并进缓存中的当天数据
+// 同一股票同一交易日同时只有一个重试线程
+void StockData::retryPages(std::shared_ptr<DataSource> source, const std::string& symbol, int32_t date, std::shared_ptr<const CachedDay> day, std::vector<int> pages) {
+    static std::mutex mutex;
+    static std::set<std::string> running;
+    const std::string key = source->name() + "/" + toLowerCase(symbol) + "/" + std::to_string(date);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running.insert(key).second) return;
+    }
+
+    std::thread([source, symbol, date, day, pages, key]() {
+        if (Trace::enabled()) {
+            Trace::setThreadName("Retry " + symbol);
+        }
+        const int retries = Config::getInstance().getFetchRetries();
+        TickCache& cache = TickCache::getInstance();
+        for (int page : pages) {
+            for (int attempt = 0; attempt < retries; ++attempt) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(500 << (std::min)(attempt, 4)));
+                Metrics::getInstance().counter("fetch.retries")++;
+                std::shared_ptr<const TickColumns> ticks;
+                try {
+                    ticks = fetchTicks(*source, symbol, page, nullptr, nullptr);
+                }
+                catch (const std::exception&) {
+                    continue;
+                }
+                if (!ticks) break;
+                // 以缓存中最新的当天数据为准，期间可能有其他查询更新过
+                std::shared_ptr<const CachedDay> current = cache.find(symbol, date, source->name());
+                auto merged = std::make_shared<CachedDay>(current ? *current : *day);
+                if (static_cast<int>(merged->pages.size()) <= page) {
+                    merged->pages.resize(page + 1);
+                }
+                merged->pages[page] = CachedPage{ ticks, true };
+                cache.put(symbol, date, source->name(), merged);
+                break;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        running.erase(key);
+    }).detach();
+}
+
+// 将当日成交明细写入本地归档，归档失败不影响本次查询，只计入指标文件
+void StockData::archiveStockData(const std::string& symbol, const TickColumns& data, bool complete) {
+    if (!Config::getInstance().getArchive()) return;
+    TRACE_SCOPE("archiveStockData");
+    try {
+        const int32_t date = TickArchive::currentTradingDate();
+        if (TickArchive::writeDay(TickArchive::getArchiveFile(symbol), date, data, complete) && complete) {
+            BaselineStore::onDayArchived(symbol, date, data);
+        }
+    }
+    catch (const std::exception&) {
+        Metrics::getInstance().counter(complete ? "archive.failed.complete" : "archive.failed")++;
+    }
+}
+
+// 用于将时间字符串转换为从当天0点开始的秒数
+int  StockData::timeStringToSeconds(const std::string& timeStr) {
+    int hours = 0, minutes = 0, seconds = 0;
+    std::istringstream iss(timeStr);
+
+    char delimiter;
+    iss >> hours >> delimiter >> minutes >> delimiter >> seconds;
+
+    return hours * 3600 + minutes * 60 + seconds;
+}
+
+// 将当天秒数转换为 HH:MM:SS
+std::string StockData::secondsToTimeString(int seconds) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d", seconds / 3600, seconds / 60 % 60, seconds % 60);
+    return buffer;
+}
+
+// 函数用于判断给定时间是否在某个时间段内，并返回索引
+int  StockData::findIndexForTime(const std::vector<int>& timeSeconds, const std::string& givenTime) {
+
+    int givenSeconds = timeStringToSeconds(givenTime);
+
+    return findIndexForTime(timeSeconds, givenSeconds);
+
+}
+
+int  StockData::findIndexForTime(const std::vector<int>& timeSeconds, int givenSecond) {
+
+    for (size_t i = 0; i < timeSeconds.size() - 1; ++i) {
+        const int& second = timeSeconds[i];
+        const int& nextSecond = timeSeconds[i+1];
+
+        if (givenSecond >= second){
+            if (givenSecond <= nextSecond) {
+                return static_cast<int>(i);
+            }
+        }
+        else {
+            break;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,180 @@
+#include "Common.h"
+#include "Config.h"
+#include "SymbolMetadata.h"
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+    // 按代码前缀区分市场
+    struct MarketInfo {
+        const char* prefix;
+        const char* exchange;
+        int lotSize;
+        std::vector<TradingSession> sessions;
+    };
+
+    const int H = 3600;
+    const int M = 60;
+
+    const MarketInfo MARKETS[] = {
+        { "sh", "SSE", 100, { { 9 * H + 15 * M, 11 * H + 30 * M }, { 13 * H, 15 * H } } },
+        { "sz", "SZSE", 100, { { 9 * H + 15 * M, 11 * H + 30 * M }, { 13 * H, 15 * H } } },
+        { "bj", "BSE", 100, { { 9 * H + 15 * M, 11 * H + 30 * M }, { 13 * H, 15 * H } } },
+        { "hk", "HKEX", 0, { { 9 * H + 30 * M, 12 * H }, { 13 * H, 16 * H + 10 * M } } },
+        { "us", "US", 0, {} },
+    };
+
+    // 收盘后留出的时间，等待接口数据落定
+    const int CLOSE_MARGIN = 5 * M;
+
+    int32_t todayDate(int& secondsOfDay) {
+        std::time_t now = std::time(nullptr);
+        std::tm local;
+#ifdef _WIN32
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        secondsOfDay = local.tm_hour * H + local.tm_min * M + local.tm_sec;
+        return (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+    }
+}
+
+bool SymbolInfo::isClosed(int32_t date) const {
+    if (sessions.empty()) return false;
+    int secondsOfDay = 0;
+    const int32_t today = todayDate(secondsOfDay);
+    return date < today || secondsOfDay >= sessions.back().close + CLOSE_MARGIN;
+}
+
+bool SymbolInfo::hasPages(int32_t date, const std::string& source) const {
+    return pagesDate == date && pagesSource == source && timePages.size() >= 3 && (pagesComplete || !isClosed(date));
+}
+
+SymbolMetadata& SymbolMetadata::getInstance() {
+    static SymbolMetadata instance;
+    return instance;
+}
+
+SymbolMetadata::SymbolMetadata() {
+    metadataFile_ = Config::getInstance().getProgramDir() + "/" + metadataFile_;
+}
+
+bool SymbolMetadata::load() {
+    std::ifstream file(metadataFile_);
+    if (!file.is_open()) return false;
+
+    try {
+        nlohmann::json j;
+        file >> j;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [key, item] : j.items()) {
+            SymbolInfo info;
+            info.symbol = key;
+            info.exchange = item.value("exchange", "");
+            info.lotSize = item.value("lot_size", 0);
+            for (const auto& session : item.value("sessions", nlohmann::json::array())) {
+                info.sessions.push_back(TradingSession{ session.at(0).get<int>(), session.at(1).get<int>() });
+            }
+            info.pagesDate = item.value("pages_date", 0);
+            info.pagesSource = item.value("pages_source", "");
+            info.timePages = item.value("time_pages", std::vector<int>());
+            info.pagesComplete = item.value("pages_complete", false);
+            symbols_[key] = info;
+        }
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+// 写临时文件再替换；持有 fileMutex_ 期间取快照，后取的快照一定后写入
+bool SymbolMetadata::save() const {
+    std::lock_guard<std::mutex> fileLock(fileMutex_);
+    nlohmann::json j = nlohmann::json::object();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [key, info] : symbols_) {
+            nlohmann::json sessions = nlohmann::json::array();
+            for (const auto& session : info.sessions) {
+                sessions.push_back({ session.open, session.close });
+            }
+            j[key] = {
+                { "exchange", info.exchange },
+                { "lot_size", info.lotSize },
+                { "sessions", sessions },
+                { "pages_date", info.pagesDate },
+                { "pages_source", info.pagesSource },
+                { "time_pages", info.timePages },
+                { "pages_complete", info.pagesComplete },
+            };
+        }
+    }
+
+    const std::string temp = metadataFile_ + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        if (!file.is_open()) return false;
+        file << j.dump(1);
+        file.close();
+        if (!file) return false;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, metadataFile_, error);
+    return !error;
+}
+
+SymbolInfo SymbolMetadata::get(const std::string& symbol) const {
+    SymbolInfo info;
+    if (find(symbol, info)) {
+        return info;
+    }
+
+    info.symbol = toLowerCase(symbol);
+    for (const auto& market : MARKETS) {
+        if (info.symbol.compare(0, 2, market.prefix) == 0) {
+            info.exchange = market.exchange;
+            info.lotSize = market.lotSize;
+            info.sessions = market.sessions;
+            break;
+        }
+    }
+    return info;
+}
+
+bool SymbolMetadata::find(const std::string& symbol, SymbolInfo& info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = symbols_.find(toLowerCase(symbol));
+    if (it == symbols_.end()) return false;
+    info = it->second;
+    return true;
+}
+
+void SymbolMetadata::update(const SymbolInfo& info) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        symbols_[toLowerCase(info.symbol)] = info;
+        if (batchDepth_ > 0) {
+            dirty_ = true;
+            return;
+        }
+    }
+    save();
+}
+
+void SymbolMetadata::beginBatch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batchDepth_++;
+}
+
+void SymbolMetadata::endBatch() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--batchDepth_ > 0 || !dirty_) return;
+        dirty_ = false;
+    }
+    save();
+}
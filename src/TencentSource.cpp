@@ -0,0 +1,310 @@
+#include "Common.h"
+#include "Config.h"
+#include "RateLimiter.h"
+#include "TencentSource.h"
+#include "TickParser.h"
+#include "Trace.h"
+#include <algorithm>
+#include <curl/curl.h>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+const char* BASE_URL = "https://stock.gtimg.cn/data/index.php";
+
+namespace {
+
+    // 所有请求共享 DNS 缓存、TLS 会话和连接池，保持长连接，后续请求不再重复握手
+    class SharedConnections {
+    public:
+        SharedConnections() {
+            share_ = curl_share_init();
+            if (!share_) return;
+            curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, lock);
+            curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, unlock);
+            curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        }
+        ~SharedConnections() {
+            if (share_) curl_share_cleanup(share_);
+        }
+        CURLSH* get() const { return share_; }
+
+    private:
+        static void lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+            static_cast<SharedConnections*>(userptr)->mutexes_[data].lock();
+        }
+        static void unlock(CURL*, curl_lock_data data, void* userptr) {
+            static_cast<SharedConnections*>(userptr)->mutexes_[data].unlock();
+        }
+
+        CURLSH* share_ = nullptr;
+        std::mutex mutexes_[CURL_LOCK_DATA_LAST];
+    };
+
+    CURLSH* sharedConnections() {
+        static SharedConnections connections;
+        return connections.get();
+    }
+
+    // 创建请求，响应写入 chunk；fresh 为 true 时不复用已有连接
+    CURL* createRequest(const std::string& url, MemoryBlock& chunk, bool fresh = false) {
+        CURL* curl = curl_easy_init();
+        if (!curl) {
+            throw std::runtime_error(_("Failed to initialize CURL"));
+        }
+
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&chunk);
+        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 10L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        if (CURLSH* share = sharedConnections()) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, share);
+        }
+        if (fresh) {
+            curl_easy_setopt(curl, CURLOPT_FRESH_CONNECT, 1L);
+        }
+        return curl;
+    }
+
+    // 创建一页数据的请求，响应写入 chunk
+    CURL* createPageRequest(const std::string& symbol, int page, const std::string& action, MemoryBlock& chunk, bool fresh = false) {
+        std::string lowerSymbol = toLowerCase(symbol);
+
+        wxString url = wxString::Format("%s?appn=detail&action=%s&c=%s&p=%d", BASE_URL, action, lowerSymbol, page);
+        return createRequest(url.ToStdString(), chunk, fresh);
+    }
+
+    // 单次请求实际耗时的直方图，供对冲判断使用；所有取数路径都经过这里，不依赖界面是否记录查询指标
+    RollingHistogram& attemptLatency() {
+        static RollingHistogram& histogram = Metrics::getInstance().histogram("page.attempt");
+        return histogram;
+    }
+
+    // 记录耗时并释放请求，出错时抛出异常
+    // primary 为 false 时是赢得对冲的第二个请求，它的耗时从对冲时刻算起，不计入 page.attempt
+    std::string finishPageRequest(CURL* curl, CURLcode res, const MemoryBlock& chunk, int page, PageTiming* timing, bool primary = true) {
+        long http_code = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+        if (primary && res == CURLE_OK && http_code == 200) {
+            curl_off_t total = 0;
+            curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+            attemptLatency().record(static_cast<uint64_t>(total));
+        }
+
+        // 记录各阶段耗时，curl 给出的是自请求开始的累计时间
+        if (timing) {
+            curl_off_t namelookup = 0, connect = 0, appconnect = 0, total = 0;
+            curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &namelookup);
+            curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+            curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appconnect);
+            curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+
+            const curl_off_t ready = (std::max)(connect, appconnect);
+            timing->page = page;
+            timing->dnsUs = namelookup;
+            timing->connectUs = (std::max)(curl_off_t(0), connect - namelookup);
+            timing->tlsUs = appconnect > 0 ? (std::max)(curl_off_t(0), appconnect - connect) : 0;
+            timing->transferUs = (std::max)(curl_off_t(0), total - ready);
+            timing->totalUs = total;
+            timing->bytes = chunk.size;
+        }
+        curl_easy_cleanup(curl);
+
+
+        // 只在非200状态码时抛出异常
+        if (res != CURLE_OK) {
+            throw std::runtime_error(wxString::Format(_("CURL request failed: %s"), curl_easy_strerror(res)).ToStdString());
+        }
+
+        if (http_code != 200) {
+            throw std::runtime_error(wxString::Format(_("HTTP request failed with status code: %d"), http_code).ToStdString());
+        }
+
+        // 200状态码时，即使数据为空也返回空字符串
+        return std::string(chunk.data, chunk.size);
+    }
+
+    // 对冲等待时间：最近单页请求耗时的 p95，样本太少时不对冲
+    int64_t hedgeDelayUs() {
+        if (!Config::getInstance().getHedgeRequests()) return 0;
+        const Histogram latency = attemptLatency().snapshot();
+        if (latency.count() < 20) return 0;
+        return (std::max)(static_cast<int64_t>(latency.percentile(95)), static_cast<int64_t>(50000));
+    }
+}
+
+// 用于获取页面数据的函数
+std::string TencentSource::fetchPageData(const std::string& symbol, int page, const std::string& action, PageTiming* timing) {
+    TRACE_SCOPE_ARG("fetchPageData", page);
+    MemoryBlock chunk;
+    CURL* curl = createPageRequest(symbol, page, action, chunk);
+    CURLcode res = curl_easy_perform(curl);
+    return finishPageRequest(curl, res, chunk, page, timing);
+}
+
+// 对冲请求：超过最近 p95 耗时仍未完成时，在新连接上再发一次相同的请求，先成功的结果生效，另一个被取消
+// 对冲请求同样消耗限速令牌，没有令牌时不发出
+std::string TencentSource::fetchPageHedged(const std::string& symbol, int page, PageTiming* timing) {
+    const int64_t delayUs = hedgeDelayUs();
+    if (delayUs <= 0) {
+        return fetchPageData(symbol, page, "data", timing);
+    }
+    TRACE_SCOPE_ARG("fetchPageHedged", page);
+    Metrics& registry = Metrics::getInstance();
+    registry.counter("hedge.eligible")++;
+
+    struct Attempt {
+        CURL* curl = nullptr;
+        MemoryBlock chunk;
+        bool running = false;
+    };
+    struct Requests {
+        CURLM* multi = curl_multi_init();
+        Attempt attempts[2];
+        // 未完成的请求在这里取消
+        ~Requests() {
+            for (Attempt& attempt : attempts) {
+                if (!attempt.curl) continue;
+                if (attempt.running) curl_multi_remove_handle(multi, attempt.curl);
+                curl_easy_cleanup(attempt.curl);
+            }
+            if (multi) curl_multi_cleanup(multi);
+        }
+    } requests;
+    if (!requests.multi) {
+        throw std::runtime_error(_("Failed to initialize CURL"));
+    }
+
+    // 对冲请求使用新的连接，避开可能已经变慢的那条
+    auto launch = [&](int i) {
+        Attempt& attempt = requests.attempts[i];
+        attempt.curl = createPageRequest(symbol, page, "data", attempt.chunk, i == 1);
+        curl_multi_add_handle(requests.multi, attempt.curl);
+        attempt.running = true;
+    };
+    launch(0);
+
+    StopWatch watch;
+    int winner = -1;
+    CURLcode winnerResult = CURLE_OK;
+    while (winner < 0) {
+        int stillRunning = 0;
+        curl_multi_perform(requests.multi, &stillRunning);
+
+        CURLMsg* msg = nullptr;
+        int queued = 0;
+        while (winner < 0 && (msg = curl_multi_info_read(requests.multi, &queued))) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            const int i = (msg->easy_handle == requests.attempts[0].curl) ? 0 : 1;
+            Attempt& attempt = requests.attempts[i];
+            curl_multi_remove_handle(requests.multi, attempt.curl);
+            attempt.running = false;
+
+            long http_code = 0;
+            curl_easy_getinfo(attempt.curl, CURLINFO_RESPONSE_CODE, &http_code);
+            const bool ok = msg->data.result == CURLE_OK && http_code == 200;
+            // 失败的一方不影响另一个仍在进行的请求
+            if (ok || !requests.attempts[1 - i].running) {
+                winner = i;
+                winnerResult = msg->data.result;
+            }
+        }
+        if (winner >= 0) break;
+
+        // 主请求超时仍未完成，发出对冲请求
+        const bool hedged = requests.attempts[1].curl != nullptr;
+        if (!hedged && requests.attempts[0].running && watch.elapsedUs() >= delayUs && RequestBudget::tryCharge() && RateLimiter::getInstance().tryAcquire()) {
+            launch(1);
+            registry.counter("hedge.sent")++;
+            continue;
+        }
+        const int64_t waitUs = hedged ? 100000 : (std::max)(delayUs - watch.elapsedUs(), static_cast<int64_t>(10000));
+        curl_multi_poll(requests.multi, nullptr, 0, static_cast<int>((std::min)(waitUs, static_cast<int64_t>(100000)) / 1000), nullptr);
+    }
+
+    if (timing) {
+        timing->hedged = requests.attempts[1].curl != nullptr;
+        timing->hedgeWon = winner == 1;
+    }
+    if (winner == 1) {
+        registry.counter("hedge.wins")++;
+        // 被取消的主请求至少用了这么久，按此记录，避免对冲后的快速结果拉低 p95
+        if (requests.attempts[0].running) {
+            attemptLatency().record(static_cast<uint64_t>(watch.elapsedUs()));
+        }
+    }
+
+    // 结果交给 finishPageRequest 释放，另一个请求由 requests 析构时取消
+    Attempt& attempt = requests.attempts[winner];
+    CURL* curl = attempt.curl;
+    attempt.curl = nullptr;
+    return finishPageRequest(curl, winnerResult, attempt.chunk, page, timing, winner == 0);
+}
+
+// 提取响应中引号内的内容
+std::string  TencentSource::getResponseText(const std::string& response) {
+    // 如果响应为空或不包含数据，直接返回空结果
+    if (response.empty() || response.find('[') == std::string::npos) {
+        throw std::exception("Extraction failed.");
+    }
+
+    size_t start = response.find('"');
+    start++;
+
+    size_t end = response.find('"', start);
+
+    if (end == std::string::npos) {
+        throw std::exception("Extraction failed.");
+    }
+
+    return response.substr(start, end - start);
+}
+
+// 从响应中解析股票数据，与本地文件导入共用同一个解析器
+size_t TencentSource::decodePage(const std::string& response, TickColumns& out, size_t* skipped) {
+    TRACE_SCOPE("parseStockData");
+
+    const std::string data = getResponseText(response);
+    return TickParser::parseRange(data.data(), data.data() + data.size(), out, -1, -1, skipped);
+}
+
+// 用于分割原始字符串并存储时间段信息，以秒数形式存储时间
+std::vector<int> TencentSource::getTimePages(const std::string& symbol, PageTiming* timing) {
+    TRACE_SCOPE("getTimePages");
+    std::vector<int> timePeriods;
+    std::string segment;
+
+    const std::string response = fetchPageData(symbol, 0, "", timing);
+    const std::string data = getResponseText(response);
+    std::string stime, etime;
+    std::istringstream iss(data);
+    while (std::getline(iss, segment, '|')) {
+        std::istringstream subIss(segment);
+        std::getline(subIss, stime, '~');
+        std::getline(subIss, etime, '~');
+        timePeriods.push_back(StockData::timeStringToSeconds(stime));
+    }
+    timePeriods.push_back(StockData::timeStringToSeconds(etime));
+    timePeriods.push_back(24 * 60 * 60);
+    return timePeriods;
+}
+
+std::string TencentSource::fetchPage(const std::string& symbol, int page, PageTiming* timing) {
+    return fetchPageHedged(symbol, page, timing);
+}
+
+// 解析域名并建立 TLS 连接，连接留在共享连接池中供随后的请求复用
+void TencentSource::warmUp() {
+    TRACE_SCOPE("warmUp");
+    MemoryBlock chunk;
+    CURL* curl = createRequest(BASE_URL, chunk);
+    curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+    curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+}
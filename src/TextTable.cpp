@@ -0,0 +1,141 @@
+#include "TextTable.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+// 判断码点是否为东亚宽字符（汉字、假名、谚文、全角符号等）
+static bool isWideCodePoint(uint32_t cp) {
+    return (cp >= 0x1100 && cp <= 0x115F) ||
+        (cp >= 0x2E80 && cp <= 0x303E) ||
+        (cp >= 0x3041 && cp <= 0x33FF) ||
+        (cp >= 0x3400 && cp <= 0x4DBF) ||
+        (cp >= 0x4E00 && cp <= 0x9FFF) ||
+        (cp >= 0xA000 && cp <= 0xA4CF) ||
+        (cp >= 0xAC00 && cp <= 0xD7A3) ||
+        (cp >= 0xF900 && cp <= 0xFAFF) ||
+        (cp >= 0xFE30 && cp <= 0xFE4F) ||
+        (cp >= 0xFF00 && cp <= 0xFF60) ||
+        (cp >= 0xFFE0 && cp <= 0xFFE6) ||
+        (cp >= 0x20000 && cp <= 0x3FFFD);
+}
+
+int TextTable::displayWidth(const char* text, size_t length) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+    const unsigned char* end = p + length;
+    int width = 0;
+
+    while (p < end) {
+        const unsigned char c = *p;
+        if (c < 0x80) {
+            width++;
+            p++;
+            continue;
+        }
+
+        int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+        uint32_t cp = (extra == 3) ? (c & 0x07) : (extra == 2) ? (c & 0x0F) : (c & 0x1F);
+        p++;
+        for (; extra > 0 && p < end; --extra, ++p) {
+            cp = (cp << 6) | (*p & 0x3F);
+        }
+
+        // 组合附加符号不占宽度
+        if (cp >= 0x0300 && cp <= 0x036F) continue;
+        width += isWideCodePoint(cp) ? 2 : 1;
+    }
+    return width;
+}
+
+void TextTable::reserve(size_t rows, size_t cells) {
+    rows_.reserve(rows);
+    cells_.reserve(cells);
+    arena_.reserve(cells * 12);
+}
+
+void TextTable::addLine(const std::string& text) {
+    rows_.push_back(Row{ false, static_cast<uint32_t>(arena_.size()), static_cast<uint32_t>(text.size()) });
+    arena_ += text;
+}
+
+void TextTable::beginRow() {
+    rows_.push_back(Row{ true, static_cast<uint32_t>(cells_.size()), 0 });
+}
+
+// 记录 arena_ 中从 offset 到末尾的单元格，并更新所在列的宽度
+void TextTable::pushCell(uint32_t offset, uint32_t width) {
+    Row& row = rows_.back();
+    const uint32_t column = row.count++;
+    cells_.push_back(Cell{ offset, static_cast<uint32_t>(arena_.size()) - offset, width });
+
+    if (columnWidths_.size() <= column) {
+        columnWidths_.push_back(1);
+    }
+    columnWidths_[column] = (std::max)(columnWidths_[column], width);
+}
+
+void TextTable::addText(const std::string& text) {
+    const uint32_t offset = static_cast<uint32_t>(arena_.size());
+    arena_ += text;
+    pushCell(offset, displayWidth(text.data(), text.size()));
+}
+
+void TextTable::addNumber(double value, int precision, const std::string& suffix) {
+    const uint32_t offset = static_cast<uint32_t>(arena_.size());
+    char buffer[64];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, precision);
+    const size_t length = (result.ec == std::errc()) ? static_cast<size_t>(result.ptr - buffer) : 0;
+    arena_.append(buffer, length);
+    arena_ += suffix;
+    pushCell(offset, static_cast<uint32_t>(length) + displayWidth(suffix.data(), suffix.size()));
+}
+
+void TextTable::addInteger(long long value) {
+    const uint32_t offset = static_cast<uint32_t>(arena_.size());
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    const size_t length = static_cast<size_t>(result.ptr - buffer);
+    arena_.append(buffer, length);
+    pushCell(offset, static_cast<uint32_t>(length));
+}
+
+// 先算出输出的总长度，再一次性写入，单元格右对齐
+std::string TextTable::render() const {
+    size_t total = 0;
+    for (const auto& row : rows_) {
+        if (!row.isTable) {
+            total += row.count + 1;
+            continue;
+        }
+        for (uint32_t i = 0; i < row.count; ++i) {
+            const Cell& cell = cells_[row.first + i];
+            total += 3 + (columnWidths_[i] - cell.width) + cell.length;
+        }
+        total += 2;
+    }
+
+    std::string output(total, ' ');
+    char* out = &output[0];
+    for (const auto& row : rows_) {
+        if (!row.isTable) {
+            memcpy(out, arena_.data() + row.first, row.count);
+            out += row.count;
+            *out++ = '\n';
+            continue;
+        }
+        for (uint32_t i = 0; i < row.count; ++i) {
+            const Cell& cell = cells_[row.first + i];
+            *out++ = '|';
+            out += 1 + (columnWidths_[i] - cell.width);
+            memcpy(out, arena_.data() + cell.offset, cell.length);
+            out += cell.length + 1;
+        }
+        *out++ = '|';
+        *out++ = '\n';
+    }
+
+    // 去除末尾多余的换行符
+    if (!output.empty() && output.back() == '\n') {
+        output.pop_back();
+    }
+    return output;
+}
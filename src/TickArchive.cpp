@@ -0,0 +1,671 @@
+#include "Common.h"
+#include "Config.h"
+#include "TickArchive.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+// 文件结构（小端）：
+//   文件头  "STKA" + 版本号(u16) + 保留(u16)
+//   数据块  每个交易日一个，各列编码后依次存放，末尾是按颗粒划分的稀疏时间索引
+//   目录    ArchiveBlock 数组，按日期升序
+//   文件尾  目录偏移(u64) + 数据块数(u32) + 目录 CRC32(u32) + "STKA"
+
+namespace {
+
+    const char MAGIC[4] = { 'S', 'T', 'K', 'A' };
+    const uint16_t VERSION = 2;
+    const uint16_t MIN_VERSION = 1;     // 版本 1 没有稀疏索引，整块作为一个颗粒读取
+    const size_t HEADER_SIZE = 8;
+    const size_t TAIL_SIZE = 20;
+
+    enum Column { COL_INDEX, COL_TIME, COL_PRICE, COL_CHANGE, COL_VOLUME, COL_AMOUNT, COL_SIDE, COLUMN_COUNT };
+
+    enum Encoding : uint8_t {
+        ENC_DELTA = 1,      // 与前一个值的差做 zigzag varint
+        ENC_VARINT = 2,     // 整数值直接做 zigzag varint
+        ENC_RAW = 3,        // 原始 double
+        ENC_SIDE = 4,       // 每个 2 位
+        ENC_AMOUNT = 5,     // 与 价格 × 数量 × 每手股数 的差做 zigzag varint
+    };
+
+    const uint8_t NO_DIGITS = 0xFF;
+    const int MAX_DIGITS = 4;
+    const int64_t POW10[] = { 1, 10, 100, 1000, 10000 };
+
+    // 每个颗粒的行数，必须是 4 的倍数以便定位买卖方向列
+    const uint16_t GRANULE_ROWS = 512;
+
+    // 稀疏时间索引项：每个颗粒开头记录各列的字节偏移，差分在颗粒开头从 0 重新开始，
+    // 因此可以从任意颗粒开始解码
+    struct GranuleIndex {
+        int32_t minTime;
+        int32_t maxTime;
+        uint32_t offset[COLUMN_COUNT];
+    };
+
+    static_assert(sizeof(ArchiveBlock) == 112, "ArchiveBlock layout is part of the file format");
+    static_assert(sizeof(GranuleIndex) == 36, "GranuleIndex layout is part of the file format");
+    static_assert(GRANULE_ROWS % 4 == 0, "side column packs 4 rows per byte");
+
+    // CRC32（IEEE 802.3），slicing-by-8
+    struct Crc32Table {
+        uint32_t table[8][256];
+        Crc32Table() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+                }
+                table[0][i] = c;
+            }
+            for (uint32_t i = 0; i < 256; ++i) {
+                for (int t = 1; t < 8; ++t) {
+                    table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+                }
+            }
+        }
+    };
+
+    uint32_t crc32(const uint8_t* p, size_t n) {
+        static const Crc32Table crc;
+        const auto& t = crc.table;
+        uint32_t c = 0xFFFFFFFFu;
+        while (n >= 8) {
+            uint32_t lo, hi;
+            memcpy(&lo, p, 4);
+            memcpy(&hi, p + 4, 4);
+            lo ^= c;
+            c = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+                t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+            p += 8;
+            n -= 8;
+        }
+        while (n--) {
+            c = t[0][(c ^ *p++) & 0xFF] ^ (c >> 8);
+        }
+        return c ^ 0xFFFFFFFFu;
+    }
+
+    inline uint64_t zigzag(int64_t v) {
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+
+    inline int64_t unzigzag(uint64_t v) {
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    inline void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v) | 0x80);
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    [[noreturn]] void corrupted() {
+        throw std::runtime_error("Corrupted archive block");
+    }
+
+    // 大部分差值只占一个字节，单独走快速路径
+    inline uint64_t getVarint(const uint8_t*& p, const uint8_t* end) {
+        if (p >= end) corrupted();
+        uint64_t value = *p++;
+        if (value < 0x80) return value;
+        value &= 0x7F;
+        for (int shift = 7; p < end && shift < 64; shift += 7) {
+            const uint64_t b = *p++;
+            value |= (b & 0x7F) << shift;
+            if (b < 0x80) return value;
+        }
+        corrupted();
+    }
+
+    // 能以 10^digits 定点数精确还原时返回 true
+    inline bool toFixed(double v, int64_t scale, int64_t& fixed) {
+        const double scaled = v * static_cast<double>(scale);
+        if (!(std::fabs(scaled) < 9.0e15)) return false;
+        fixed = std::llround(scaled);
+        return static_cast<double>(fixed) / static_cast<double>(scale) == v;
+    }
+
+    inline bool isInteger(double v) {
+        return std::fabs(v) < 9.0e15 && v == std::floor(v);
+    }
+
+    // 金额预测值 round(价格 × 数量 × 每手股数)，全部使用整数运算保证编解码一致
+    inline int64_t predictAmount(int64_t priceFixed, int64_t volume, int64_t lot, int64_t scale) {
+        const int64_t product = priceFixed * volume * lot;
+        return product >= 0 ? (product + scale / 2) / scale : -((-product + scale / 2) / scale);
+    }
+
+    template <typename T>
+    void putRaw(std::vector<uint8_t>& out, const T& value) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    // 编码一个交易日的数据，填写摘要中除偏移外的字段
+    std::vector<uint8_t> encodeBlock(int32_t date, const TickColumns& ticks, ArchiveBlock& info) {
+        const size_t n = ticks.size();
+        memset(&info, 0, sizeof(info));
+        info.date = date;
+        info.rows = static_cast<uint32_t>(n);
+        info.firstIndex = ticks.index[0];
+        info.minTime = *std::min_element(ticks.time.begin(), ticks.time.end());
+        info.maxTime = *std::max_element(ticks.time.begin(), ticks.time.end());
+        info.minPrice = *std::min_element(ticks.price.begin(), ticks.price.end());
+        info.maxPrice = *std::max_element(ticks.price.begin(), ticks.price.end());
+        for (size_t i = 0; i < n; ++i) {
+            info.volume += ticks.volume[i];
+            info.amount += ticks.amount[i];
+            if (info.lotSize == 0 && ticks.volume[i] > 0 && ticks.price[i] > 0) {
+                info.lotSize = ticks.row(i).onehand();
+            }
+        }
+
+        // 选出能精确表示所有价格和涨跌的最小小数位数
+        std::vector<int64_t> priceFixed(n), changeFixed(n);
+        info.priceDigits = NO_DIGITS;
+        for (int digits = 0; digits <= MAX_DIGITS && info.priceDigits == NO_DIGITS; ++digits) {
+            bool exact = true;
+            for (size_t i = 0; i < n && exact; ++i) {
+                exact = toFixed(ticks.price[i], POW10[digits], priceFixed[i]) &&
+                    toFixed(ticks.change[i], POW10[digits], changeFixed[i]);
+            }
+            if (exact) info.priceDigits = static_cast<uint8_t>(digits);
+        }
+        const bool fixedPrice = info.priceDigits != NO_DIGITS;
+        const bool integerVolume = std::all_of(ticks.volume.begin(), ticks.volume.end(), isInteger);
+        const bool integerAmount = std::all_of(ticks.amount.begin(), ticks.amount.end(), isInteger);
+        const bool predictable = fixedPrice && integerVolume && integerAmount && info.lotSize > 0 &&
+            info.maxPrice * (std::max)(1.0, info.volume) * info.lotSize * POW10[info.priceDigits] < 1.0e18;
+
+        // 稀疏时间索引：每个颗粒的时间范围
+        const size_t granules = (n + GRANULE_ROWS - 1) / GRANULE_ROWS;
+        std::vector<GranuleIndex> granuleIndex(granules);
+        for (size_t g = 0; g < granules; ++g) {
+            const auto first = ticks.time.begin() + g * GRANULE_ROWS;
+            const auto last = ticks.time.begin() + (std::min)(n, (g + 1) * GRANULE_ROWS);
+            granuleIndex[g].minTime = *std::min_element(first, last);
+            granuleIndex[g].maxTime = *std::max_element(first, last);
+        }
+        info.granuleRows = GRANULE_ROWS;
+        info.flags = std::is_sorted(ticks.time.begin(), ticks.time.end()) ? ARCHIVE_SORTED : 0;
+
+        std::vector<uint8_t> out;
+        out.reserve(n * 10 + granules * sizeof(GranuleIndex));
+        size_t columnStart = 0;
+        auto finishColumn = [&](Column column, Encoding encoding) {
+            info.encoding[column] = encoding;
+            info.columnSize[column] = static_cast<uint32_t>(out.size() - columnStart);
+            columnStart = out.size();
+        };
+        // 到达颗粒开头时记录该列的偏移，返回 true 表示差分需要重新开始
+        auto granuleStart = [&](Column column, size_t i) {
+            if (i % GRANULE_ROWS != 0) return false;
+            granuleIndex[i / GRANULE_ROWS].offset[column] = static_cast<uint32_t>(out.size() - columnStart);
+            return true;
+        };
+
+        int64_t prev = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (granuleStart(COL_INDEX, i)) prev = 0;
+            putVarint(out, zigzag(static_cast<int64_t>(ticks.index[i]) - prev));
+            prev = ticks.index[i];
+        }
+        finishColumn(COL_INDEX, ENC_DELTA);
+
+        for (size_t i = 0; i < n; ++i) {
+            if (granuleStart(COL_TIME, i)) prev = 0;
+            putVarint(out, zigzag(static_cast<int64_t>(ticks.time[i]) - prev));
+            prev = ticks.time[i];
+        }
+        finishColumn(COL_TIME, ENC_DELTA);
+
+        auto putFixedColumn = [&](Column column, const std::vector<int64_t>& fixed, const std::vector<double>& raw) {
+            for (size_t i = 0; i < n; ++i) {
+                if (granuleStart(column, i)) prev = 0;
+                if (fixedPrice) {
+                    putVarint(out, zigzag(fixed[i] - prev));
+                    prev = fixed[i];
+                }
+                else {
+                    putRaw(out, raw[i]);
+                }
+            }
+            finishColumn(column, fixedPrice ? ENC_DELTA : ENC_RAW);
+        };
+        putFixedColumn(COL_PRICE, priceFixed, ticks.price);
+        putFixedColumn(COL_CHANGE, changeFixed, ticks.change);
+
+        for (size_t i = 0; i < n; ++i) {
+            granuleStart(COL_VOLUME, i);
+            if (integerVolume) {
+                putVarint(out, zigzag(static_cast<int64_t>(ticks.volume[i])));
+            }
+            else {
+                putRaw(out, ticks.volume[i]);
+            }
+        }
+        finishColumn(COL_VOLUME, integerVolume ? ENC_VARINT : ENC_RAW);
+
+        const int64_t scale = fixedPrice ? POW10[info.priceDigits] : 1;
+        for (size_t i = 0; i < n; ++i) {
+            granuleStart(COL_AMOUNT, i);
+            if (predictable) {
+                const int64_t predicted = predictAmount(priceFixed[i], static_cast<int64_t>(ticks.volume[i]), info.lotSize, scale);
+                putVarint(out, zigzag(static_cast<int64_t>(ticks.amount[i]) - predicted));
+            }
+            else if (integerAmount) {
+                putVarint(out, zigzag(static_cast<int64_t>(ticks.amount[i])));
+            }
+            else {
+                putRaw(out, ticks.amount[i]);
+            }
+        }
+        finishColumn(COL_AMOUNT, predictable ? ENC_AMOUNT : integerAmount ? ENC_VARINT : ENC_RAW);
+
+        for (size_t i = 0; i < n; i += 4) {
+            granuleStart(COL_SIDE, i);
+            uint8_t packed = 0;
+            for (size_t k = 0; k < 4 && i + k < n; ++k) {
+                packed |= static_cast<uint8_t>((ticks.side[i + k] + 1) & 0x3) << (k * 2);
+            }
+            out.push_back(packed);
+        }
+        finishColumn(COL_SIDE, ENC_SIDE);
+
+        for (const auto& entry : granuleIndex) putRaw(out, entry);
+
+        info.size = static_cast<uint32_t>(out.size());
+        info.crc = crc32(out.data(), out.size());
+        return out;
+    }
+
+    // 差分列每 restart 行从 0 重新累加
+    void decodeDelta(const uint8_t* p, const uint8_t* end, size_t n, size_t restart, int32_t* out) {
+        for (size_t start = 0; start < n; start += restart) {
+            const size_t stop = (std::min)(n, start + restart);
+            int64_t value = 0;
+            for (size_t i = start; i < stop; ++i) {
+                value += unzigzag(getVarint(p, end));
+                out[i] = static_cast<int32_t>(value);
+            }
+        }
+    }
+
+    void decodeRaw(const uint8_t* p, const uint8_t* end, size_t n, double* out) {
+        if (static_cast<size_t>(end - p) < n * sizeof(double)) corrupted();
+        memcpy(out, p, n * sizeof(double));
+    }
+
+    // 定点差分还原为 double；除法保证与直接解析文本得到的值一致
+    void decodeFixed(const uint8_t* p, const uint8_t* end, size_t n, size_t restart, int64_t scale, double* out, int64_t* fixed) {
+        const double divisor = static_cast<double>(scale);
+        for (size_t start = 0; start < n; start += restart) {
+            const size_t stop = (std::min)(n, start + restart);
+            int64_t value = 0;
+            for (size_t i = start; i < stop; ++i) {
+                value += unzigzag(getVarint(p, end));
+                out[i] = static_cast<double>(value) / divisor;
+                if (fixed) fixed[i] = value;
+            }
+        }
+    }
+
+    void decodeVarint(const uint8_t* p, const uint8_t* end, size_t n, double* out) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<double>(unzigzag(getVarint(p, end)));
+        }
+    }
+
+    void decodeSide(const uint8_t* p, const uint8_t* end, size_t n, int8_t* out) {
+        if (static_cast<size_t>(end - p) < (n + 3) / 4) corrupted();
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<int8_t>(((p[i / 4] >> ((i % 4) * 2)) & 0x3) - 1);
+        }
+    }
+
+    std::filesystem::path toPath(const std::string& path) {
+        return std::filesystem::u8path(path);
+    }
+}
+
+// 每个归档文件一把读写锁，数量不超过查询过的股票数，不再释放
+std::shared_mutex& TickArchive::fileLock(const std::string& path) {
+    static std::mutex mutex;
+    static std::map<std::string, std::unique_ptr<std::shared_mutex>> locks;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = locks[path];
+    if (!entry) {
+        entry = std::make_unique<std::shared_mutex>();
+    }
+    return *entry;
+}
+
+TickArchive::TickArchive(const std::string& path)
+    : lock_(fileLock(path)), file_(path) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(file_.data());
+    const size_t size = file_.size();
+    if (size < HEADER_SIZE + TAIL_SIZE || memcmp(data, MAGIC, 4) != 0) {
+        throw std::runtime_error("Invalid archive file: " + path);
+    }
+    uint16_t version;
+    memcpy(&version, data + 4, 2);
+    if (version < MIN_VERSION || version > VERSION) {
+        throw std::runtime_error("Unsupported archive version: " + path);
+    }
+
+    const uint8_t* tail = data + size - TAIL_SIZE;
+    uint64_t directoryOffset;
+    uint32_t count, directoryCrc;
+    memcpy(&directoryOffset, tail, 8);
+    memcpy(&count, tail + 8, 4);
+    memcpy(&directoryCrc, tail + 12, 4);
+    if (memcmp(tail + 16, MAGIC, 4) != 0 || directoryOffset < HEADER_SIZE ||
+        directoryOffset + static_cast<uint64_t>(count) * sizeof(ArchiveBlock) != size - TAIL_SIZE) {
+        throw std::runtime_error("Invalid archive file: " + path);
+    }
+    if (crc32(data + directoryOffset, count * sizeof(ArchiveBlock)) != directoryCrc) {
+        throw std::runtime_error("Archive directory checksum mismatch: " + path);
+    }
+
+    blocks_.resize(count);
+    if (count > 0) {
+        memcpy(blocks_.data(), data + directoryOffset, count * sizeof(ArchiveBlock));
+    }
+    for (auto& block : blocks_) {
+        uint64_t columns = 0;
+        for (uint32_t size : block.columnSize) columns += size;
+        if (version < 2) {
+            block.granuleRows = 0;
+            block.flags = 0;
+        }
+        const uint64_t granules = block.granuleRows ? (block.rows + block.granuleRows - 1) / block.granuleRows : 0;
+        if (block.offset < HEADER_SIZE || block.offset + block.size > directoryOffset ||
+            block.granuleRows % 4 != 0 || columns + granules * sizeof(GranuleIndex) != block.size) {
+            throw std::runtime_error("Invalid archive file: " + path);
+        }
+    }
+    verified_.reset(new std::atomic<bool>[count]());
+}
+
+const ArchiveBlock* TickArchive::findBlock(int32_t date) const {
+    auto it = std::lower_bound(blocks_.begin(), blocks_.end(), date,
+        [](const ArchiveBlock& block, int32_t d) { return block.date < d; });
+    return (it != blocks_.end() && it->date == date) ? &*it : nullptr;
+}
+
+TickColumns TickArchive::read(int32_t fromDate, int32_t toDate, int stimesec, int etimesec) const {
+    auto first = std::lower_bound(blocks_.begin(), blocks_.end(), fromDate,
+        [](const ArchiveBlock& block, int32_t d) { return block.date < d; });
+    auto last = std::upper_bound(first, blocks_.end(), toDate,
+        [](int32_t d, const ArchiveBlock& block) { return d < block.date; });
+
+    TickColumns out;
+    if (stimesec < 0 && etimesec < 0) {
+        size_t rows = 0;
+        for (auto it = first; it != last; ++it) rows += it->rows;
+        out.reserve(rows);
+    }
+    for (auto it = first; it != last; ++it) {
+        readBlock(*it, out, stimesec, etimesec);
+    }
+    return out;
+}
+
+// 通过稀疏索引找到与时间范围相交的颗粒，只解码这些颗粒并追加到 out，返回追加的笔数
+size_t TickArchive::readBlock(const ArchiveBlock& block, TickColumns& out, int stimesec, int etimesec) const {
+    const int stimesec_ = (stimesec == -1) ? 0 : stimesec;
+    const int etimesec_ = (etimesec == -1) ? 24 * 60 * 60 : etimesec;
+    if (block.rows == 0 || block.maxTime < stimesec_ || block.minTime > etimesec_) {
+        return 0;
+    }
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(file_.data()) + block.offset;
+    std::atomic<bool>& verified = verified_[&block - blocks_.data()];
+    if (!verified.load(std::memory_order_acquire)) {
+        if (crc32(data, block.size) != block.crc) {
+            throw std::runtime_error("Archive block checksum mismatch");
+        }
+        verified.store(true, std::memory_order_release);
+    }
+
+    const uint8_t* columns[COLUMN_COUNT + 1];
+    columns[0] = data;
+    for (int c = 0; c < COLUMN_COUNT; ++c) {
+        columns[c + 1] = columns[c] + block.columnSize[c];
+    }
+
+    // 版本 1 的数据块没有索引，整块是一个颗粒
+    const size_t restart = block.granuleRows ? block.granuleRows : block.rows;
+    const size_t granules = (block.rows + restart - 1) / restart;
+    const uint8_t* indexData = columns[COLUMN_COUNT];
+    auto granule = [&](size_t g) {
+        GranuleIndex entry;
+        if (block.granuleRows) {
+            memcpy(&entry, indexData + g * sizeof(GranuleIndex), sizeof(GranuleIndex));
+        }
+        else {
+            entry = GranuleIndex{ block.minTime, block.maxTime, {} };
+        }
+        return entry;
+    };
+
+    // 时间有序时二分查找首尾颗粒，否则顺序扫描索引
+    size_t firstGranule = 0, lastGranule = granules;
+    if (block.flags & ARCHIVE_SORTED) {
+        size_t lo = 0, hi = granules;
+        while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (granule(mid).maxTime < stimesec_) lo = mid + 1; else hi = mid;
+        }
+        firstGranule = lo;
+        hi = granules;
+        while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (granule(mid).minTime <= etimesec_) lo = mid + 1; else hi = mid;
+        }
+        lastGranule = lo;
+    }
+    else {
+        while (firstGranule < granules && (granule(firstGranule).maxTime < stimesec_ || granule(firstGranule).minTime > etimesec_)) {
+            firstGranule++;
+        }
+        while (lastGranule > firstGranule && (granule(lastGranule - 1).maxTime < stimesec_ || granule(lastGranule - 1).minTime > etimesec_)) {
+            lastGranule--;
+        }
+    }
+    if (firstGranule >= lastGranule) {
+        return 0;
+    }
+
+    const GranuleIndex start = granule(firstGranule);
+    const size_t firstRow = firstGranule * restart;
+    const size_t n = (std::min)(static_cast<size_t>(block.rows), lastGranule * restart) - firstRow;
+    auto column = [&](Column c) { return columns[c] + start.offset[c]; };
+    auto columnEnd = [&](Column c) { return columns[c + 1]; };
+
+    const size_t base = out.size();
+    out.resize(base + n);
+
+    const int64_t scale = (block.priceDigits <= MAX_DIGITS) ? POW10[block.priceDigits] : 1;
+    std::vector<int64_t> priceFixed(block.encoding[COL_AMOUNT] == ENC_AMOUNT ? n : 0);
+
+    decodeDelta(column(COL_INDEX), columnEnd(COL_INDEX), n, restart, &out.index[base]);
+    decodeDelta(column(COL_TIME), columnEnd(COL_TIME), n, restart, &out.time[base]);
+
+    for (Column c : { COL_PRICE, COL_CHANGE }) {
+        double* target = (c == COL_PRICE) ? &out.price[base] : &out.change[base];
+        int64_t* fixed = (c == COL_PRICE && !priceFixed.empty()) ? priceFixed.data() : nullptr;
+        if (block.encoding[c] == ENC_DELTA) {
+            decodeFixed(column(c), columnEnd(c), n, restart, scale, target, fixed);
+        }
+        else {
+            decodeRaw(column(c), columnEnd(c), n, target);
+        }
+    }
+
+    if (block.encoding[COL_VOLUME] == ENC_VARINT) {
+        decodeVarint(column(COL_VOLUME), columnEnd(COL_VOLUME), n, &out.volume[base]);
+    }
+    else {
+        decodeRaw(column(COL_VOLUME), columnEnd(COL_VOLUME), n, &out.volume[base]);
+    }
+
+    if (block.encoding[COL_AMOUNT] == ENC_AMOUNT) {
+        const uint8_t* p = column(COL_AMOUNT);
+        const uint8_t* end = columnEnd(COL_AMOUNT);
+        for (size_t i = 0; i < n; ++i) {
+            const int64_t predicted = predictAmount(priceFixed[i], static_cast<int64_t>(out.volume[base + i]), block.lotSize, scale);
+            out.amount[base + i] = static_cast<double>(predicted + unzigzag(getVarint(p, end)));
+        }
+    }
+    else if (block.encoding[COL_AMOUNT] == ENC_VARINT) {
+        decodeVarint(column(COL_AMOUNT), columnEnd(COL_AMOUNT), n, &out.amount[base]);
+    }
+    else {
+        decodeRaw(column(COL_AMOUNT), columnEnd(COL_AMOUNT), n, &out.amount[base]);
+    }
+
+    decodeSide(column(COL_SIDE), columnEnd(COL_SIDE), n, &out.side[base]);
+
+    // 首尾颗粒只部分落在时间范围内时，原地去掉范围外的行
+    size_t kept = base;
+    for (size_t i = base; i < base + n; ++i) {
+        if (out.time[i] < stimesec_ || out.time[i] > etimesec_) continue;
+        if (kept != i) {
+            out.index[kept] = out.index[i];
+            out.time[kept] = out.time[i];
+            out.price[kept] = out.price[i];
+            out.change[kept] = out.change[i];
+            out.volume[kept] = out.volume[i];
+            out.amount[kept] = out.amount[i];
+            out.side[kept] = out.side[i];
+        }
+        kept++;
+    }
+    out.resize(kept);
+    return kept - base;
+}
+
+bool TickArchive::writeDay(const std::string& path, int32_t date, const TickColumns& ticks, bool complete) {
+    if (ticks.empty()) return false;
+
+    // 同一进程内可能有多个查询线程同时归档
+    static std::mutex writeMutex;
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    ArchiveBlock info;
+    const std::vector<uint8_t> encoded = encodeBlock(date, ticks, info);
+    if (complete) {
+        info.flags |= ARCHIVE_COMPLETE;
+    }
+
+    const std::filesystem::path target = toPath(path);
+    std::filesystem::path temp = target;
+    temp += ".tmp";
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path());
+    }
+
+    {
+        std::unique_ptr<TickArchive> existing;
+        if (std::filesystem::exists(target)) {
+            existing = std::make_unique<TickArchive>(path);
+        }
+
+        // 合并已有数据块，同一交易日的旧数据被替换
+        std::vector<ArchiveBlock> blocks;
+        if (existing) {
+            for (const auto& block : existing->blocks()) {
+                if (block.date == date) continue;
+                // 节假日接口仍返回上一交易日的数据，内容完全相同时不重复保存
+                if (block.rows == info.rows && block.size == info.size && block.crc == info.crc) {
+                    return false;
+                }
+                blocks.push_back(block);
+            }
+        }
+        blocks.push_back(info);
+        std::sort(blocks.begin(), blocks.end(), [](const ArchiveBlock& a, const ArchiveBlock& b) { return a.date < b.date; });
+
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + temp.u8string());
+        }
+
+        const uint16_t version = VERSION, reserved = 0;
+        file.write(MAGIC, 4);
+        file.write(reinterpret_cast<const char*>(&version), 2);
+        file.write(reinterpret_cast<const char*>(&reserved), 2);
+
+        uint64_t offset = HEADER_SIZE;
+        for (auto& block : blocks) {
+            const char* source = (block.date == date)
+                ? reinterpret_cast<const char*>(encoded.data())
+                : existing->file_.data() + block.offset;
+            file.write(source, block.size);
+            block.offset = offset;
+            offset += block.size;
+        }
+
+        const uint32_t count = static_cast<uint32_t>(blocks.size());
+        const uint32_t directoryCrc = crc32(reinterpret_cast<const uint8_t*>(blocks.data()), count * sizeof(ArchiveBlock));
+        file.write(reinterpret_cast<const char*>(blocks.data()), count * sizeof(ArchiveBlock));
+        file.write(reinterpret_cast<const char*>(&offset), 8);
+        file.write(reinterpret_cast<const char*>(&count), 4);
+        file.write(reinterpret_cast<const char*>(&directoryCrc), 4);
+        file.write(MAGIC, 4);
+        file.close();
+        if (!file) {
+            throw std::runtime_error("Failed to write file: " + temp.u8string());
+        }
+    }
+
+    // 本线程对旧文件的映射已释放，等其他线程的读取结束后替换
+    std::unique_lock<std::shared_mutex> exclusive(fileLock(path));
+    std::filesystem::rename(temp, target);
+    return true;
+}
+
+bool TickArchive::exists(const std::string& path) {
+    std::error_code error;
+    return std::filesystem::is_regular_file(toPath(path), error);
+}
+
+std::string TickArchive::getArchiveFile(const std::string& symbol) {
+    const wxString dir(Config::getInstance().getProgramDir());
+    const wxString file = dir + "/archive/" + wxString::FromUTF8(toLowerCase(symbol).c_str()) + ".tka";
+    return std::string(file.utf8_str());
+}
+
+int32_t TickArchive::currentTradingDate() {
+    std::time_t now = std::time(nullptr);
+    std::tm local;
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+
+    // 开盘集合竞价之前，接口返回的仍是上一交易日的数据
+    if (local.tm_hour * 60 + local.tm_min < 9 * 60 + 15) {
+        local.tm_mday -= 1;
+    }
+    local.tm_hour = 12;
+    std::mktime(&local);
+    while (local.tm_wday == 0 || local.tm_wday == 6) {
+        local.tm_mday -= 1;
+        std::mktime(&local);
+    }
+    return (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+}
@@ -0,0 +1,95 @@
+#include "Metrics.h"
+#include "TickCache.h"
+
+size_t CachedDay::memoryBytes() const {
+    size_t bytes = sizeof(CachedDay) + timePages.size() * sizeof(int) + pages.size() * sizeof(CachedPage);
+    for (const auto& page : pages) {
+        if (page.ticks) {
+            bytes += page.ticks->memoryBytes();
+        }
+    }
+    return bytes;
+}
+
+TickCache& TickCache::getInstance() {
+    static TickCache instance;
+    return instance;
+}
+
+std::string TickCache::makeKey(const std::string& symbol, int32_t date, const std::string& source) {
+    return symbol + '|' + std::to_string(date) + '|' + source;
+}
+
+std::shared_ptr<const CachedDay> TickCache::find(const std::string& symbol, int32_t date, const std::string& source) {
+    const std::string key = makeKey(symbol, date, source);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        misses_++;
+        Metrics::getInstance().counter("cache.misses")++;
+        return nullptr;
+    }
+    hits_++;
+    Metrics::getInstance().counter("cache.hits")++;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->day;
+}
+
+// 放入或替换一个交易日的数据；正在使用的旧数据由调用方持有的 shared_ptr 保持有效
+void TickCache::put(const std::string& symbol, int32_t date, const std::string& source, std::shared_ptr<const CachedDay> day) {
+    const std::string key = makeKey(symbol, date, source);
+    const size_t bytes = day->memoryBytes();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        bytes_ -= it->second->bytes;
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+
+    // 单个交易日超过上限时不缓存
+    if (bytes > capacity_) return;
+
+    lru_.push_front(Entry{ key, std::move(day), bytes });
+    index_[key] = lru_.begin();
+    bytes_ += bytes;
+    evict();
+}
+
+void TickCache::setCapacity(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = bytes;
+    evict();
+}
+
+void TickCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+TickCacheStats TickCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TickCacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.entries = lru_.size();
+    stats.bytes = bytes_;
+    stats.capacity = capacity_;
+    return stats;
+}
+
+// 调用方已持有锁
+void TickCache::evict() {
+    while (bytes_ > capacity_ && !lru_.empty()) {
+        const Entry& victim = lru_.back();
+        bytes_ -= victim.bytes;
+        index_.erase(victim.key);
+        lru_.pop_back();
+        evictions_++;
+        Metrics::getInstance().counter("cache.evictions")++;
+    }
+}
@@ -0,0 +1,108 @@
+#include "TickGrid.h"
+#include "Trace.h"
+
+namespace {
+    // 按 TickField 顺序
+    const int COLUMN_WIDTHS[FIELD_COUNT] = { 70, 80, 80, 70, 90, 110, 70 };
+}
+
+TickList::TickList(wxWindow* parent, std::shared_ptr<const TickColumns> ticks)
+    : wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxSize(640, 400), wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL),
+      view_(std::move(ticks)) {
+    const wxString headers[FIELD_COUNT] = { _("Index"), _("Time"), _("Price"), _("Change"), _("Volume"), _("Amounts"), _("Type") };
+    for (int i = 0; i < FIELD_COUNT; ++i) {
+        AppendColumn(headers[i], i <= FIELD_TIME ? wxLIST_FORMAT_LEFT : wxLIST_FORMAT_RIGHT, COLUMN_WIDTHS[i]);
+    }
+    Bind(wxEVT_LIST_COL_CLICK, &TickList::OnColumnClick, this);
+    reload();
+}
+
+void TickList::reload() {
+    SetItemCount(static_cast<long>(view_.size()));
+    Refresh();
+}
+
+// 只有可见的行才会调用这里
+wxString TickList::OnGetItemText(long item, long column) const {
+    if (item < 0 || static_cast<size_t>(item) >= view_.size()) return wxEmptyString;
+    const TickColumns& t = view_.ticks();
+    const uint32_t r = view_.row(static_cast<size_t>(item));
+    switch (column) {
+    case FIELD_INDEX: return wxString::Format("%d", t.index[r]);
+    case FIELD_TIME: return StockData::secondsToTimeString(t.time[r]);
+    case FIELD_PRICE: return wxString::Format("%.2f", t.price[r]);
+    case FIELD_CHANGE: return wxString::Format("%.2f", t.change[r]);
+    case FIELD_VOLUME: return wxString::Format("%.0f", t.volume[r]);
+    case FIELD_AMOUNT: return wxString::Format("%.0f", t.amount[r]);
+    case FIELD_SIDE: return t.side[r] == SIDE_BUY ? _("Buy") : t.side[r] == SIDE_SELL ? _("Sell") : _("Neutral");
+    default: return wxEmptyString;
+    }
+}
+
+// 点击列头排序，再次点击同一列切换升降序
+void TickList::OnColumnClick(wxListEvent& event) {
+    const TickField field = static_cast<TickField>(event.GetColumn());
+    const bool ascending = (view_.sortField() == field) ? !view_.ascending() : true;
+    wxBusyCursor busy;
+    view_.sort(field, ascending);
+    reload();
+}
+
+TickGrid::TickGrid(wxWindow* parent, std::shared_ptr<const TickColumns> ticks)
+    : wxPanel(parent) {
+    TRACE_SCOPE("TickGrid");
+    wxArrayString sides;
+    sides.Add(_("All"));
+    sides.Add(_("Buy"));
+    sides.Add(_("Sell"));
+    sides.Add(_("Neutral"));
+    sideChoice_ = new wxChoice(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, sides);
+    sideChoice_->SetSelection(0);
+    minVolumeBox_ = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxSize(80, -1), wxTE_PROCESS_ENTER);
+    countLabel_ = new wxStaticText(this, wxID_ANY, "");
+    list_ = new TickList(this, ticks);
+
+    auto* filterSizer = new wxBoxSizer(wxHORIZONTAL);
+    filterSizer->Add(new wxStaticText(this, wxID_ANY, _("Type:")), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    filterSizer->Add(sideChoice_, 0, wxRIGHT, 10);
+    filterSizer->Add(new wxStaticText(this, wxID_ANY, _("Min Volume:")), 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    filterSizer->Add(minVolumeBox_, 0, wxRIGHT, 10);
+    filterSizer->Add(countLabel_, 1, wxALIGN_CENTER_VERTICAL);
+
+    auto* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(filterSizer, 0, wxEXPAND | wxALL, 5);
+    sizer->Add(list_, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 5);
+    SetSizer(sizer);
+
+    sideChoice_->Bind(wxEVT_CHOICE, &TickGrid::OnFilter, this);
+    minVolumeBox_->Bind(wxEVT_TEXT_ENTER, &TickGrid::OnFilter, this);
+    minVolumeBox_->Bind(wxEVT_KILL_FOCUS, [this](wxFocusEvent& event) {
+        wxCommandEvent dummy;
+        OnFilter(dummy);
+        event.Skip();
+    });
+    UpdateCount();
+}
+
+void TickGrid::OnFilter(wxCommandEvent& event) {
+    TickFilter filter;
+    const int side = sideChoice_->GetSelection();
+    filter.buy = side == 0 || side == 1;
+    filter.sell = side == 0 || side == 2;
+    filter.neutral = side == 0 || side == 3;
+    double minVolume = 0;
+    if (minVolumeBox_->GetValue().ToDouble(&minVolume)) {
+        filter.minVolume = minVolume;
+    }
+
+    wxBusyCursor busy;
+    list_->view().setFilter(filter);
+    list_->reload();
+    UpdateCount();
+}
+
+void TickGrid::UpdateCount() {
+    const TickView& view = list_->view();
+    countLabel_->SetLabel(wxString::Format(_("%llu of %llu ticks"),
+        static_cast<unsigned long long>(view.size()), static_cast<unsigned long long>(view.totalSize())));
+}
@@ -0,0 +1,194 @@
+#include "TickParser.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // 低于该大小的数据不值得开线程
+    const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+    inline bool isRecordSeparator(char c) {
+        return c == '|' || c == '\n';
+    }
+
+    inline bool isFieldSeparator(char c) {
+        return c == '/' || c == ',';
+    }
+
+    inline bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // 解析 HH:MM:SS（也接受 HH:MM），失败返回 -1
+    int parseTime(const char* p, const char* end) {
+        int parts[3] = { 0, 0, 0 };
+        int count = 0;
+        while (p < end && count < 3) {
+            int value = 0;
+            const char* start = p;
+            while (p < end && isDigit(*p)) {
+                value = value * 10 + (*p - '0');
+                p++;
+            }
+            if (p == start) return -1;
+            parts[count++] = value;
+            if (p < end && *p == ':') p++;
+        }
+        return count >= 2 ? parts[0] * 3600 + parts[1] * 60 + parts[2] : -1;
+    }
+
+    template <typename T>
+    inline bool parseNumber(const char* begin, const char* end, T& value) {
+        auto result = std::from_chars(begin, end, value);
+        return result.ec == std::errc();
+    }
+
+    // 买盘/卖盘兼容 B/S、Buy/Sell 以及中文的“买”“卖”
+    int8_t parseSide(const char* p, const char* end) {
+        if (p >= end) return SIDE_NEUTRAL;
+        if (*p == 'B' || *p == 'b') return SIDE_BUY;
+        if (*p == 'S' || *p == 's') return SIDE_SELL;
+        if (end - p >= 3 && memcmp(p, "\xE4\xB9\xB0", 3) == 0) return SIDE_BUY;
+        if (end - p >= 3 && memcmp(p, "\xE5\x8D\x96", 3) == 0) return SIDE_SELL;
+        return SIDE_NEUTRAL;
+    }
+}
+
+size_t TickParser::parseRange(const char* begin, const char* end, TickColumns& out, int stimesec, int etimesec, size_t* skipped) {
+    const int stimesec_ = (stimesec == -1) ? 0 : stimesec;
+    const int etimesec_ = (etimesec == -1) ? 24 * 60 * 60 : etimesec;
+    const size_t before = out.size();
+    size_t bad = 0;
+
+    const char* p = begin;
+    while (p < end) {
+        const char* recordEnd = p;
+        while (recordEnd < end && !isRecordSeparator(*recordEnd)) recordEnd++;
+
+        // 去掉首尾空白和回车
+        const char* r = p;
+        const char* e = recordEnd;
+        while (r < e && (*r == ' ' || *r == '\t' || *r == '\r' || *r == '"')) r++;
+        while (e > r && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r' || e[-1] == '"')) e--;
+        p = recordEnd + 1;
+
+        // 空行和表头（首字符不是数字）直接跳过
+        if (r == e || !isDigit(*r)) continue;
+
+        const char* fields[8];
+        const char* fieldEnds[8];
+        int count = 0;
+        const char* f = r;
+        while (count < 7) {
+            const char* fe = f;
+            while (fe < e && !isFieldSeparator(*fe)) fe++;
+            fields[count] = f;
+            fieldEnds[count] = fe;
+            count++;
+            if (fe >= e) break;
+            f = fe + 1;
+        }
+        if (count < 7) {
+            bad++;
+            continue;
+        }
+
+        int32_t index = 0;
+        double price = 0, change = 0, volume = 0, amount = 0;
+        const int time = parseTime(fields[1], fieldEnds[1]);
+        if (time < 0 ||
+            !parseNumber(fields[0], fieldEnds[0], index) ||
+            !parseNumber(fields[2], fieldEnds[2], price) ||
+            !parseNumber(fields[3], fieldEnds[3], change) ||
+            !parseNumber(fields[4], fieldEnds[4], volume) ||
+            !parseNumber(fields[5], fieldEnds[5], amount)) {
+            bad++;
+            continue;
+        }
+
+        if (time >= stimesec_ && time <= etimesec_) {
+            out.push(index, time, price, change, volume, amount, parseSide(fields[6], fieldEnds[6]));
+        }
+    }
+
+    if (skipped) *skipped += bad;
+    return out.size() - before;
+}
+
+TickColumns TickParser::parseParallel(const char* data, size_t size, int stimesec, int etimesec, size_t* skipped, unsigned threads) {
+    if (threads == 0) {
+        threads = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>((std::min)(static_cast<size_t>(threads), (std::max)(size_t(1), size / MIN_CHUNK_BYTES)));
+
+    // 按字节等分后把边界推进到下一个记录分隔符之后
+    std::vector<const char*> bounds{ data };
+    for (unsigned i = 1; i < threads; ++i) {
+        const char* p = (std::max)(bounds.back(), data + size * i / threads);
+        while (p < data + size && !isRecordSeparator(*p)) p++;
+        bounds.push_back(p < data + size ? p + 1 : data + size);
+    }
+    bounds.push_back(data + size);
+
+    std::vector<TickColumns> parts(threads);
+    std::vector<size_t> bad(threads, 0);
+    auto parseChunk = [&](unsigned i) {
+        parts[i].reserve(static_cast<size_t>(bounds[i + 1] - bounds[i]) / 40);
+        parseRange(bounds[i], bounds[i + 1], parts[i], stimesec, etimesec, &bad[i]);
+    };
+
+    if (threads == 1) {
+        parseChunk(0);
+    }
+    else {
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back(parseChunk, i);
+        }
+        for (auto& worker : workers) worker.join();
+    }
+
+    if (skipped) {
+        for (size_t b : bad) *skipped += b;
+    }
+    if (threads == 1) {
+        return std::move(parts[0]);
+    }
+
+    // 各段结果按顺序并行拷贝到最终的列中
+    std::vector<size_t> offsets(threads + 1, 0);
+    for (unsigned i = 0; i < threads; ++i) {
+        offsets[i + 1] = offsets[i] + parts[i].size();
+    }
+    TickColumns result;
+    const size_t total = offsets.back();
+    result.index.resize(total);
+    result.time.resize(total);
+    result.price.resize(total);
+    result.change.resize(total);
+    result.volume.resize(total);
+    result.amount.resize(total);
+    result.side.resize(total);
+
+    auto copyChunk = [&](unsigned i) {
+        const TickColumns& part = parts[i];
+        const size_t at = offsets[i];
+        std::copy(part.index.begin(), part.index.end(), result.index.begin() + at);
+        std::copy(part.time.begin(), part.time.end(), result.time.begin() + at);
+        std::copy(part.price.begin(), part.price.end(), result.price.begin() + at);
+        std::copy(part.change.begin(), part.change.end(), result.change.begin() + at);
+        std::copy(part.volume.begin(), part.volume.end(), result.volume.begin() + at);
+        std::copy(part.amount.begin(), part.amount.end(), result.amount.begin() + at);
+        std::copy(part.side.begin(), part.side.end(), result.side.begin() + at);
+        parts[i] = TickColumns();
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(copyChunk, i);
+    }
+    for (auto& worker : workers) worker.join();
+    return result;
+}
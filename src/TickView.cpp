@@ -0,0 +1,84 @@
+#include "TickView.h"
+#include "Trace.h"
+#include <algorithm>
+#include <utility>
+
+TickView::TickView(std::shared_ptr<const TickColumns> ticks)
+    : ticks_(std::move(ticks)) {
+    setFilter(TickFilter());
+}
+
+void TickView::setFilter(const TickFilter& filter) {
+    TRACE_SCOPE("TickView::setFilter");
+    filter_ = filter;
+    rows_.clear();
+    if (!ticks_) return;
+
+    const TickColumns& t = *ticks_;
+    const int stimesec = (filter.stimesec < 0) ? 0 : filter.stimesec;
+    const int etimesec = (filter.etimesec < 0) ? 24 * 60 * 60 : filter.etimesec;
+    rows_.reserve(t.size());
+    for (size_t i = 0; i < t.size(); ++i) {
+        const int8_t side = t.side[i];
+        if (side == SIDE_BUY ? !filter.buy : side == SIDE_SELL ? !filter.sell : !filter.neutral) continue;
+        if (t.volume[i] < filter.minVolume) continue;
+        if (t.time[i] < stimesec || t.time[i] > etimesec) continue;
+        rows_.push_back(static_cast<uint32_t>(i));
+    }
+    applySort();
+}
+
+void TickView::sort(TickField field, bool ascending) {
+    sortField_ = field;
+    ascending_ = ascending;
+    setFilter(filter_);
+}
+
+// 过滤后的行号本来就是原始顺序，只有其他排序需要重新排列
+// 取出排序键后按（键，行号）排序，相同键保持原始顺序
+void TickView::applySort() {
+    if (sortField_ == FIELD_COUNT || rows_.empty()) {
+        if (!ascending_) std::reverse(rows_.begin(), rows_.end());
+        return;
+    }
+    TRACE_SCOPE("TickView::sort");
+
+    const TickColumns& t = *ticks_;
+    std::vector<std::pair<double, uint32_t>> keys(rows_.size());
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        const uint32_t r = rows_[i];
+        double key = 0;
+        switch (sortField_) {
+        case FIELD_INDEX: key = t.index[r]; break;
+        case FIELD_TIME: key = t.time[r]; break;
+        case FIELD_PRICE: key = t.price[r]; break;
+        case FIELD_CHANGE: key = t.change[r]; break;
+        case FIELD_VOLUME: key = t.volume[r]; break;
+        case FIELD_AMOUNT: key = t.amount[r]; break;
+        case FIELD_SIDE: key = t.side[r]; break;
+        default: break;
+        }
+        keys[i] = { key, r };
+    }
+
+    // 时间和序号通常已经有序，省去排序
+    const auto ascendingOrder = [](const std::pair<double, uint32_t>& a, const std::pair<double, uint32_t>& b) {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+    };
+    if (!std::is_sorted(keys.begin(), keys.end(), ascendingOrder)) {
+        std::sort(keys.begin(), keys.end(), ascendingOrder);
+    }
+    if (!ascending_) {
+        // 降序：整体反转后，把相同键的行反转回原始顺序
+        std::reverse(keys.begin(), keys.end());
+        for (size_t i = 0; i < keys.size();) {
+            size_t j = i + 1;
+            while (j < keys.size() && keys[j].first == keys[i].first) j++;
+            std::reverse(keys.begin() + i, keys.begin() + j);
+            i = j;
+        }
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        rows_[i] = keys[i].second;
+    }
+}
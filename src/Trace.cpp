@@ -0,0 +1,166 @@
+#include "Config.h"
+#include "Trace.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    const size_t CHUNK_EVENTS = 4096;
+    const size_t MAX_CHUNKS = 256;
+
+    // 单个线程的事件缓冲区：只有所属线程写入，写入后用 release 发布长度，导出时用 acquire 读取
+    struct ThreadBuffer {
+        int tid = 0;
+        std::string name;
+        std::array<std::atomic<TraceEvent*>, MAX_CHUNKS> chunks{};
+        std::atomic<size_t> size{ 0 };
+        std::atomic<size_t> dropped{ 0 };
+        bool exited = false;        // 所属线程已经结束，由登记表的锁保护
+
+        ~ThreadBuffer() {
+            for (auto& chunk : chunks) {
+                delete[] chunk.load();
+            }
+        }
+
+        void push(const TraceEvent& event) {
+            const size_t n = size.load(std::memory_order_relaxed);
+            const size_t chunkIndex = n / CHUNK_EVENTS;
+            if (chunkIndex >= MAX_CHUNKS) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            TraceEvent* chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+            if (!chunk) {
+                chunk = new TraceEvent[CHUNK_EVENTS];
+                chunks[chunkIndex].store(chunk, std::memory_order_release);
+            }
+            chunk[n % CHUNK_EVENTS] = event;
+            size.store(n + 1, std::memory_order_release);
+        }
+    };
+
+    // 所有线程缓冲区的登记表，只在线程第一次记录和导出时加锁
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        int nextTid = 1;
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    // 线程结束时没有事件的缓冲区直接移除，有事件的等导出之后再移除
+    struct LocalBuffer {
+        std::shared_ptr<ThreadBuffer> buffer;
+
+        ~LocalBuffer() {
+            if (!buffer) return;
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            buffer->exited = true;
+            if (buffer->size.load(std::memory_order_relaxed) == 0) {
+                reg.buffers.erase(std::remove(reg.buffers.begin(), reg.buffers.end(), buffer), reg.buffers.end());
+            }
+        }
+    };
+
+    ThreadBuffer& localBuffer() {
+        thread_local LocalBuffer local;
+        if (!local.buffer) {
+            local.buffer = std::make_shared<ThreadBuffer>();
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            local.buffer->tid = reg.nextTid++;
+            reg.buffers.push_back(local.buffer);
+        }
+        return *local.buffer;
+    }
+
+    const auto traceEpoch = std::chrono::steady_clock::now();
+
+    // 名称均来自代码中的字面量，只需处理引号和反斜杠
+    void writeEscaped(std::ofstream& file, const std::string& text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\') file << '\\';
+            file << c;
+        }
+    }
+}
+
+void Trace::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+int64_t Trace::nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - traceEpoch).count();
+}
+
+void Trace::record(const char* name, int64_t startUs, int64_t durationUs, int64_t arg) {
+    localBuffer().push(TraceEvent{ name, startUs, durationUs, arg });
+}
+
+void Trace::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name;
+}
+
+// 导出所有线程已记录的时间段，已结束线程的缓冲区导出后释放
+bool Trace::write(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) file << ",\n";
+        first = false;
+    };
+
+    for (const auto& buffer : reg.buffers) {
+        separator();
+        file << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid << ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+        writeEscaped(file, buffer->name.empty() ? "Thread " + std::to_string(buffer->tid) : buffer->name);
+        file << "\"}}";
+
+        const size_t n = buffer->size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) {
+            const TraceEvent& event = buffer->chunks[i / CHUNK_EVENTS].load(std::memory_order_acquire)[i % CHUNK_EVENTS];
+            separator();
+            file << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"name\":\"";
+            writeEscaped(file, event.name);
+            file << "\",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs;
+            if (event.arg >= 0) {
+                file << ",\"args\":{\"page\":" << event.arg << "}";
+            }
+            file << "}";
+        }
+
+        const size_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0) {
+            separator();
+            file << "{\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->tid << ",\"name\":\"dropped\",\"ts\":0,\"args\":{\"events\":" << dropped << "}}";
+        }
+    }
+    file << "\n]}\n";
+    file.close();
+    if (!file) return false;
+    reg.buffers.erase(std::remove_if(reg.buffers.begin(), reg.buffers.end(),
+        [](const std::shared_ptr<ThreadBuffer>& buffer) { return buffer->exited; }), reg.buffers.end());
+    return true;
+}
+
+std::string Trace::getTraceFile() {
+    return Config::getInstance().getProgramDir() + "/stock_trace.json";
+}
@@ -1,70 +1,96 @@
-#pragma once
-#include "Common.h"
-#include "Config.h"
-#include "LanguageLoader.h"
-#include "MainWindow.h"
-#include <locale.h>
-#include <wx/filename.h>
-#include <wx/stdpaths.h>
-#include <wx/wx.h>
-
-#ifdef _WIN32
-#include <windows.h>
-#else
-#include <unistd.h>
-#endif
-
-class StockAnalyzerApp : public wxApp {
-private:
-    wxLocale locale;
-public:
-    bool OnInit() override {
-        Config::getInstance().loadConfig();
-        const int language = Config::getInstance().getLanguage();
-
-        // 开启调试日志
-        wxLog::AddTraceMask("i18n");
-
-        // 设置自定义加载器
-        auto* translations = new wxTranslations();
-        wxTranslations::Set(translations);
-
-        LanguageLoader* loader = new LanguageLoader();
-        translations->SetLoader(loader);
-
-        // 设置语言
-        locale.Init(language);
-
-        // 加载翻译文件
-        if (!locale.AddCatalog("stock"))
-        {
-            wxLogError("Failed to load translations!");
-        }
-
-        wxMessageBox(
-            _("Announcement\n\n"
-                "The data is sourced from the network.\n"
-                "The analysis results are only for reference.\n"
-                "Regarding the accuracy and quality issues of the data,\n"
-                "this tool shall not be held responsible in any way."),
-            _("Announcement")
-        );
-
-        MainWindow* frame = new MainWindow();
-        frame->Show(true);
-        return true;
-    }
-
-};
-
-int main(int argc, char** argv) {
-    wxDISABLE_DEBUG_SUPPORT();
-
-    wxEntryStart(argc, argv);
-    wxApp::SetInstance(new StockAnalyzerApp());
-    int exitCode = wxEntry(argc, argv);
-    wxEntryCleanup();
-    return exitCode;
-}
-
+#pragma once
+#include "Common.h"
+#include "Config.h"
+#include "DataSource.h"
+#include "LanguageLoader.h"
+#include "MainWindow.h"
+#include "Metrics.h"
+#include "RateLimiter.h"
+#include "SymbolMetadata.h"
+#include "TencentSource.h"
+#include "TickCache.h"
+#include "Trace.h"
+#include <locale.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <wx/wx.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+class StockAnalyzerApp : public wxApp {
+private:
+    wxLocale locale;
+public:
+    bool OnInit() override {
+        Config::getInstance().loadConfig();
+        // 股票代码、每手股数、交易时段和当天分页表的缓存
+        SymbolMetadata::getInstance().load();
+        const int language = Config::getInstance().getLanguage();
+
+        // 配置文件中 "trace": true 时记录查询时间线
+        Trace::setEnabled(Config::getInstance().getTrace());
+        Trace::setThreadName("UI");
+
+        // 已解析成交明细的内存缓存上限
+        TickCache::getInstance().setCapacity(Config::getInstance().getCacheSize());
+        // 所有查询共享的请求频率上限
+        RateLimiter::getInstance().configure(Config::getInstance().getRequestRate(), Config::getInstance().getRequestBurst());
+        // 成交明细数据源，按健康状况自动切换
+        DataSourceRouter::getInstance().add(std::make_shared<TencentSource>());
+
+        // 开启调试日志
+        wxLog::AddTraceMask("i18n");
+
+        // 设置自定义加载器
+        auto* translations = new wxTranslations();
+        wxTranslations::Set(translations);
+
+        LanguageLoader* loader = new LanguageLoader();
+        translations->SetLoader(loader);
+
+        // 设置语言
+        locale.Init(language);
+
+        // 加载翻译文件
+        if (!locale.AddCatalog("stock"))
+        {
+            wxLogError("Failed to load translations!");
+        }
+
+        wxMessageBox(
+            _("Announcement\n\n"
+                "The data is sourced from the network.\n"
+                "The analysis results are only for reference.\n"
+                "Regarding the accuracy and quality issues of the data,\n"
+                "this tool shall not be held responsible in any way."),
+            _("Announcement")
+        );
+
+        MainWindow* frame = new MainWindow();
+        frame->Show(true);
+        return true;
+    }
+
+    // 写入尚未写入的查询指标
+    int OnExit() override {
+        Metrics::getInstance().flush();
+        return wxApp::OnExit();
+    }
+
+};
+
+int main(int argc, char** argv) {
+    wxDISABLE_DEBUG_SUPPORT();
+
+    wxEntryStart(argc, argv);
+    wxApp::SetInstance(new StockAnalyzerApp());
+    int exitCode = wxEntry(argc, argv);
+    wxEntryCleanup();
+    return exitCode;
+}
+
 wxIMPLEMENT_APP_NO_MAIN(StockAnalyzerApp);
\ No newline at end of file